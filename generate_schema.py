@@ -0,0 +1,496 @@
+#!/usr/bin/env python
+###############################################################################
+# $Id$
+#
+# Project:  VFP Translator
+# Purpose:  Generate the layer, field and token tables of the OGR VFP driver
+#           (ogrvfpschema.h, ogrvfptokens.h) from the VFP XML schema.
+#
+###############################################################################
+# Copyright (c) 2015, Martin Landa <landa.martin gmail.com>
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+###############################################################################
+#
+# Usage:
+#   python generate_schema.py data/vfp_3.1.xsd ogrvfpschema.h ogrvfptokens.h
+#
+# Each child element of the root element (except the header) is a layer.
+# Its records are the repeated elements found one level below it, or two
+# levels below it when the layer element only groups optional collections
+# (zs, pm, ...). The attributes of the record elements, including those
+# of the types that may be substituted with xsi:type, become the fields.
+#
+# For the writer, each record (and each of its xsi:type variants) also
+# gets a template: the elements leading from it to the reg, lin or c
+# element of its geometry, the first of them that repeats for the parts
+# of a multi geometry, and the fields it has attributes for.
+#
+# Every element name and xsi:type value, with and without the v: prefix,
+# and every field name also gets a token. The tokens are looked up with a
+# hash and displace perfect hash: the bucket of a name gives the seed that
+# maps it to a slot of its own, so that a lookup costs one hash and one
+# strcmp.
+
+import sys
+import xml.etree.ElementTree as ET
+
+XS = '{http://www.w3.org/2001/XMLSchema}'
+
+INT_MIN = -2147483648
+INT_MAX = 2147483647
+
+NS_PREFIX = 'v:'
+
+
+class Schema:
+
+    def __init__(self, filename):
+        self.root = ET.parse(filename).getroot()
+        self.complex_types = {}
+        self.simple_types = {}
+        for node in self.root:
+            if node.tag == XS + 'complexType':
+                self.complex_types[node.get('name')] = node
+            elif node.tag == XS + 'simpleType':
+                self.simple_types[node.get('name')] = node
+
+    # -- types ---------------------------------------------------------------
+
+    def complex_type_of(self, element):
+        """ Complex type (named or anonymous) of an element, or None. """
+        name = element.get('type')
+        if name is not None:
+            return self.complex_types.get(name)
+        return element.find(XS + 'complexType')
+
+    def base_of(self, ctype):
+        ext = ctype.find(XS + 'complexContent/' + XS + 'extension')
+        if ext is None:
+            return None
+        return self.complex_types.get(ext.get('base'))
+
+    def derived_types(self, ctype):
+        """ The type and the types extending it, usable with xsi:type. """
+        result = [ctype]
+        for other in self.complex_types.values():
+            base = self.base_of(other)
+            while base is not None:
+                if base is ctype:
+                    result.append(other)
+                    break
+                base = self.base_of(base)
+        return result
+
+    def content(self, ctype):
+        """ Element and attribute declarations of a type and its bases. """
+        nodes = []
+        base = self.base_of(ctype)
+        if base is not None:
+            nodes.extend(self.content(base))
+        ext = ctype.find(XS + 'complexContent/' + XS + 'extension')
+        for node in (ext if ext is not None else ctype):
+            nodes.append(node)
+        return nodes
+
+    def attributes(self, ctype):
+        return [n for n in self.content(ctype) if n.tag == XS + 'attribute']
+
+    def elements(self, ctype):
+        result = []
+        for node in self.content(ctype):
+            if node.tag in (XS + 'sequence', XS + 'choice', XS + 'all'):
+                result.extend(node.findall(XS + 'element'))
+        return result
+
+    def field_type(self, type_name):
+        """ OGR field type of a simple type. """
+        facets = {}
+        while type_name is not None and not type_name.startswith('xs:'):
+            restriction = self.simple_types[type_name].find(XS + 'restriction')
+            for facet in restriction:
+                if facet.tag == XS + 'enumeration':
+                    facets.setdefault('enumeration', []).append(facet.get('value'))
+                else:
+                    facets.setdefault(facet.tag[len(XS):], facet.get('value'))
+            type_name = restriction.get('base')
+
+        if type_name in ('xs:integer', 'xs:positiveInteger', 'xs:int'):
+            values = facets.get('enumeration', [])
+            if not values and 'minInclusive' in facets and 'maxInclusive' in facets:
+                values = [facets['minInclusive'], facets['maxInclusive']]
+            if values and all(INT_MIN <= int(v) <= INT_MAX for v in values):
+                return 'OFTInteger'
+            return 'OFTInteger64'
+        if type_name in ('xs:decimal', 'xs:double', 'xs:float'):
+            return 'OFTReal'
+        if type_name == 'xs:dateTime':
+            return 'OFTDateTime'
+        return 'OFTString'
+
+    def token_names(self):
+        """ Element names and the names of the types used with xsi:type. """
+        names = set()
+        for element in self.root.iter(XS + 'element'):
+            if element.get('name') is not None:
+                names.add(element.get('name'))
+        for name, ctype in self.complex_types.items():
+            if self.base_of(ctype) is not None:
+                names.add(name)
+        return sorted(names)
+
+    # -- geometry ------------------------------------------------------------
+
+    def has_geometry(self, ctype, seen=None):
+        """ Whether coordinates can appear in an element of that type. """
+        if seen is None:
+            seen = set()
+        if id(ctype) in seen:
+            return False
+        seen.add(id(ctype))
+        for derived in self.derived_types(ctype):
+            for attr in self.attributes(derived):
+                if attr.get('name') == 'sx':
+                    return True
+            for element in self.elements(derived):
+                if element.get('type') == 'coordinateType':
+                    return True
+                child = self.complex_type_of(element)
+                if child is not None and self.has_geometry(child, seen):
+                    return True
+        return False
+
+    # -- record templates ----------------------------------------------------
+
+    def required_attributes(self, ctype):
+        return [a for a in self.attributes(ctype) if a.get('use') == 'required']
+
+    def geometry_paths(self, ctype, path, repeat, found):
+        """ Paths from a record to the reg, lin and c elements the writer
+            can fill in, without going through elements that need
+            attributes of their own (nested records, texts). """
+        for element in self.elements(ctype):
+            name = element.get('name')
+            type_name = element.get('type')
+            if element.get('maxOccurs') == 'unbounded' and repeat < 0:
+                here = len(path)
+            else:
+                here = repeat
+            if type_name == 'regionType':
+                label = any(e.get('type') == 'textType' and
+                            e.get('minOccurs') != '0'
+                            for e in self.elements(ctype))
+                found.append(('VFP_RECORD_REGION', path + [name], here, label))
+            elif type_name == 'linearType':
+                found.append(('VFP_RECORD_LINE', path + [name], here, False))
+            elif type_name == 'coordinateType':
+                found.append(('VFP_RECORD_POINT', path + [name], here, False))
+            else:
+                child = self.complex_type_of(element)
+                if child is None or self.required_attributes(child):
+                    continue
+                self.geometry_paths(child, path + [name], here, found)
+
+    def record_templates(self, group, record, fields, alone):
+        """ How the writer encodes a feature as this record, for each
+            type the record element may have. Records whose coordinates
+            are only in texts or nested records are written without
+            geometry if they are the only records of the layer. """
+        rtype = self.complex_type_of(record)
+        if rtype is None:
+            return []
+        derived = self.derived_types(rtype)
+        templates = []
+        for ctype in derived:
+            if ctype.get('abstract') == 'true':
+                continue
+            xsi_type = None
+            if len(derived) > 1:
+                xsi_type = ctype.get('name')
+            names = [a.get('name') for a in self.attributes(ctype)]
+
+            found = []
+            self.geometry_paths(ctype, [], -1, found)
+            kinds = [f[0] for f in found]
+            if 'sx' in names:
+                geometry = ('VFP_RECORD_POINT_ATTR', [], -1, False)
+                names = [n for n in names if n not in ('sx', 'sy', 'sz')]
+            else:
+                geometry = None
+            for kind in ('VFP_RECORD_REGION', 'VFP_RECORD_LINE',
+                         'VFP_RECORD_POINT'):
+                if geometry is None and kind in kinds:
+                    geometry = found[kinds.index(kind)]
+            if geometry is None:
+                if self.has_geometry(ctype) and not alone:
+                    continue
+                geometry = ('VFP_RECORD_NONE', [], -1, False)
+
+            mask = 0
+            for i, (field_name, field_type) in enumerate(fields):
+                if field_name in names:
+                    mask |= 1 << i
+            templates.append((group, record.get('name'), xsi_type) +
+                             geometry + (mask,))
+        return templates
+
+    # -- layers --------------------------------------------------------------
+
+    def layers(self):
+        root_element = self.root.find(XS + 'element')
+        layers = []
+        for element in self.elements(self.complex_type_of(root_element)):
+            if element.get('name') == 'hlav':
+                continue
+            ctype = self.complex_type_of(element)
+
+            records = []
+            groups = []
+            depth = 1
+            for child in self.elements(ctype):
+                if child.get('maxOccurs') == 'unbounded':
+                    records.append(child)
+                    groups.append(None)
+            if not records:
+                depth = 2
+                for group in self.elements(ctype):
+                    for child in self.elements(self.complex_type_of(group)):
+                        if child.get('maxOccurs') == 'unbounded':
+                            records.append(child)
+                            groups.append(group.get('name'))
+            if not records:
+                raise Exception('no records found in %s' % element.get('name'))
+
+            fields = []
+            geometry = False
+            for record in records:
+                rtype = self.complex_type_of(record)
+                if rtype is None:
+                    continue
+                geometry = geometry or self.has_geometry(rtype)
+                for derived in self.derived_types(rtype):
+                    for attr in self.attributes(derived):
+                        merge_field(fields, attr.get('name'),
+                                    self.field_type(attr.get('type')))
+
+            if len(fields) > 32:
+                raise Exception('too many fields in %s' % element.get('name'))
+            templates = []
+            for group, record in zip(groups, records):
+                templates.extend(self.record_templates(group, record, fields,
+                                                       len(records) == 1))
+
+            layers.append((element.get('name'), depth, geometry, fields,
+                           templates))
+        return layers
+
+
+def merge_field(fields, name, field_type):
+    """ Add a field, widening its type if it is declared several times. """
+    for i, (other_name, other_type) in enumerate(fields):
+        if other_name != name:
+            continue
+        if other_type != field_type:
+            if 'OFTString' in (field_type, other_type) or \
+               'OFTDateTime' in (field_type, other_type):
+                field_type = 'OFTString'
+            elif 'OFTReal' in (field_type, other_type):
+                field_type = 'OFTReal'
+            else:
+                field_type = 'OFTInteger64'
+            fields[i] = (name, field_type)
+        return
+    fields.append((name, field_type))
+
+
+def c_string(value):
+    if value is None:
+        return 'NULL'
+    return '"%s"' % value
+
+
+def token_id(name):
+    return 'VFP_TOKEN_' + name.upper()
+
+
+def fnv_hash(name):
+    """ FNV-1a, as computed by OGRVFPGetToken(). """
+    h = 2166136261
+    for c in bytearray(name.encode('ascii')):
+        h = ((h ^ c) * 16777619) & 0xffffffff
+    return h
+
+
+def mix(h, seed):
+    """ MurmurHash3 finalizer of the hash xor the seed of its bucket. """
+    h ^= seed
+    h ^= h >> 16
+    h = (h * 0x85ebca6b) & 0xffffffff
+    h ^= h >> 13
+    h = (h * 0xc2b2ae35) & 0xffffffff
+    h ^= h >> 16
+    return h
+
+
+def perfect_hash(keys):
+    """ Seeds of the buckets and slot table so that no two keys collide. """
+    nslots = 1
+    while nslots < 2 * len(keys):
+        nslots *= 2
+    nbuckets = max(nslots // 4, 1)
+
+    buckets = [[] for i in range(nbuckets)]
+    for key in keys:
+        buckets[fnv_hash(key) & (nbuckets - 1)].append(key)
+
+    seeds = [0] * nbuckets
+    slots = [None] * nslots
+    order = sorted(range(nbuckets), key=lambda b: -len(buckets[b]))
+    for b in order:
+        if not buckets[b]:
+            break
+        seed = 1
+        while True:
+            used = [mix(fnv_hash(key), seed) & (nslots - 1) for key in buckets[b]]
+            if len(set(used)) == len(used) and \
+               all(slots[i] is None for i in used):
+                break
+            seed += 1
+        seeds[b] = seed
+        for key, i in zip(buckets[b], used):
+            slots[i] = key
+    return seeds, slots
+
+
+def main(argv):
+    if len(argv) != 4:
+        sys.stderr.write('Usage: generate_schema.py vfp.xsd ogrvfpschema.h '
+                         'ogrvfptokens.h\n')
+        return 1
+
+    schema = Schema(argv[1])
+    layers = schema.layers()
+    names = schema.token_names()
+    field_names = set()
+    for name, depth, geometry, fields, templates in layers:
+        for field_name, field_type in fields:
+            field_names.add(field_name)
+    token_names = sorted(set(names) | field_names)
+    ids = [token_id(name) for name in token_names]
+    assert len(set(ids)) == len(ids), 'names differing only by case'
+    xsd_name = argv[1].replace('\\', '/').split('/')[-1]
+
+    # tokens ------------------------------------------------------------------
+    out = []
+    out.append('/* Generated by generate_schema.py from %s, do not edit. */' %
+               xsd_name)
+    out.append('')
+    out.append('#ifndef _OGR_VFP_TOKENS_H_INCLUDED')
+    out.append('#define _OGR_VFP_TOKENS_H_INCLUDED')
+    out.append('')
+    out.append('/* Element names, xsi:type values and field names of the VFP schema */')
+    out.append('typedef enum')
+    out.append('{')
+    out.append('    VFP_TOKEN_UNKNOWN = 0,')
+    for name in token_names:
+        out.append('    %s,' % token_id(name))
+    out.append('    VFP_TOKEN_COUNT')
+    out.append('} OGRVFPToken;')
+    out.append('')
+    out.append('#endif /* ndef _OGR_VFP_TOKENS_H_INCLUDED */')
+
+    f = open(argv[3], 'w')
+    f.write('\n'.join(out) + '\n')
+    f.close()
+
+    # schema and token lookup tables -------------------------------------------
+    keys = {}
+    for name in token_names:
+        keys[name] = token_id(name)
+    for name in names:
+        keys[NS_PREFIX + name] = token_id(name)
+    seeds, slots = perfect_hash(sorted(keys))
+
+    out = []
+    out.append('/* Generated by generate_schema.py from %s, do not edit. */' %
+               xsd_name)
+    out.append('')
+    out.append('#ifndef _OGR_VFP_SCHEMA_H_INCLUDED')
+    out.append('#define _OGR_VFP_SCHEMA_H_INCLUDED')
+    out.append('')
+    for name, depth, geometry, fields, templates in layers:
+        if not fields:
+            continue
+        out.append('static const OGRVFPFieldDesc asVFPFields_%s[] = {' % name)
+        for field_name, field_type in fields:
+            out.append('    { "%s", %s },' % (field_name, field_type))
+        out.append('};')
+        out.append('')
+    for name, depth, geometry, fields, templates in layers:
+        if not templates:
+            continue
+        out.append('static const OGRVFPRecordDesc asVFPRecords_%s[] = {' % name)
+        for group, record, xsi_type, kind, path, repeat, label, mask in templates:
+            out.append('    { %s, "%s", %s, %s, %s, %d, %s, 0x%08x },' %
+                       (c_string(group), record, c_string(xsi_type), kind,
+                        c_string('/'.join(path) if path else None), repeat,
+                        'TRUE' if label else 'FALSE', mask))
+        out.append('};')
+        out.append('')
+    out.append('static const OGRVFPLayerDesc asVFPLayers[] = {')
+    for name, depth, geometry, fields, templates in layers:
+        if fields:
+            table = 'asVFPFields_%s, %d' % (name, len(fields))
+        else:
+            table = 'NULL, 0'
+        if templates:
+            table += ', asVFPRecords_%s, %d' % (name, len(templates))
+        else:
+            table += ', NULL, 0'
+        out.append('    { "%s", %s, %d, %s, %s },' %
+                   (name, token_id(name), depth,
+                    'TRUE' if geometry else 'FALSE', table))
+    out.append('};')
+    out.append('')
+    out.append('#define VFP_TOKEN_BUCKETS %d' % len(seeds))
+    out.append('#define VFP_TOKEN_SLOTS %d' % len(slots))
+    out.append('')
+    out.append('static const GUInt32 anVFPTokenSeeds[VFP_TOKEN_BUCKETS] = {')
+    for i in range(0, len(seeds), 8):
+        out.append('    ' + ' '.join('%d,' % seed for seed in seeds[i:i + 8]))
+    out.append('};')
+    out.append('')
+    out.append('static const OGRVFPTokenDesc asVFPTokenSlots[VFP_TOKEN_SLOTS] = {')
+    for key in slots:
+        if key is None:
+            out.append('    { NULL, VFP_TOKEN_UNKNOWN },')
+        else:
+            out.append('    { "%s", %s },' % (key, keys[key]))
+    out.append('};')
+    out.append('')
+    out.append('#endif /* ndef _OGR_VFP_SCHEMA_H_INCLUDED */')
+
+    f = open(argv[2], 'w')
+    f.write('\n'.join(out) + '\n')
+    f.close()
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -31,112 +31,1300 @@
 #define _OGR_VFP_H_INCLUDED
 
 #include "ogrsf_frmts.h"
+#include "cpl_multiproc.h"
+#include "cpl_virtualmem.h"
+
+#include <map>
+#include <vector>
+#include <stdint.h>
+
+#include "ogrvfptokens.h"
 
 #ifdef HAVE_EXPAT
 #include "ogr_expat.h"
 #endif
 
 class OGRVFPDataSource;
+class OGRVFPLayer;
+class OGRVFPWriter;
+class OGRVFPWriterLayer;
+class swq_expr_node;
+
+double OGRVFPStrtod( const char *pszStr, char **ppszEnd );
+
+/* Token of an element name or xsi:type value, VFP_TOKEN_UNKNOWN if it
+   is not defined by the schema. "v:name" and "name" give the same token. */
+OGRVFPToken OGRVFPGetToken( const char *pszName );
+
+/* Result of OGRVFPSniffHeader() */
+typedef enum
+{
+    VFP_SNIFF_NOT_VFP,
+    VFP_SNIFF_VFP,
+    VFP_SNIFF_NEED_MORE         /* the root element is not in the bytes */
+} OGRVFPSniffResult;
+
+/* bytes of the file the root element and hlav are looked for in */
+#define VFP_SNIFF_MAX_BYTES 16384
 
+/* Check the root element of a document from its first bytes without an
+   XML parser. If posVersion is given, it receives the ver attribute of
+   hlav when hlav is the first element in the root and fits in them. */
+OGRVFPSniffResult OGRVFPSniffHeader( const char *pszHeader, int nHeaderBytes,
+                                     CPLString *posVersion );
+
+/* SPATIAL_INDEX open option */
+typedef enum
+{
+    VFP_SPATIAL_INDEX_NO,       /* never use a .vfpr file */
+    VFP_SPATIAL_INDEX_AUTO,     /* build it on the first spatial query */
+    VFP_SPATIAL_INDEX_YES       /* build it when the file is opened */
+} OGRVFPSpatialIndexMode;
 
 /************************************************************************/
-/*                             OGRVFPLayer                              */
+/*                             OGRVFPArena                              */
+/*                                                                      */
+/*      Bump allocator for the transient state of the record being      */
+/*      parsed: its attribute values and the scratch point arrays of    */
+/*      the geometry builder. Nothing is freed individually, Reset()    */
+/*      rewinds the arena for the next record. When a record did not    */
+/*      fit, the blocks are merged into one large enough for it, so     */
+/*      the arena stops allocating once it has seen the largest         */
+/*      record.                                                         */
 /************************************************************************/
 
-class OGRVFPLayer : public OGRLayer
+class OGRVFPArena
+{
+private:
+    std::vector<GByte*> apabyBlocks;    /* the last one is being filled */
+    size_t             nLastBlockSize;
+    size_t             nLastBlockUsed;
+    size_t             nTotalSize;
+
+    GIntBig            nBlockAllocs;
+
+public:
+    OGRVFPArena();
+    ~OGRVFPArena();
+
+    void*              Alloc( size_t nSize );
+    char*              Strdup( const char *pszStr );
+    void               Reset();
+
+    /* number of blocks allocated so far, for instrumentation */
+    GIntBig            GetBlockAllocs() const { return nBlockAllocs; }
+    size_t             GetSize() const { return nTotalSize; }
+};
+
+/************************************************************************/
+/*                          OGRVFPMappedRange                           */
+/*                                                                      */
+/*      Read-only memory mapping of a byte range of a local file. The   */
+/*      mapped bytes are passed to XML_Parse() directly instead of      */
+/*      being read into the expat buffer chunk by chunk. Files of /vsi  */
+/*      handlers without a native file descriptor cannot be mapped,     */
+/*      Map() then fails quietly and the caller reads the file.         */
+/************************************************************************/
+
+class OGRVFPMappedRange
+{
+private:
+    CPLVirtualMem*     psMem;
+    vsi_l_offset       nStart;
+    vsi_l_offset       nEnd;
+
+public:
+    OGRVFPMappedRange();
+    ~OGRVFPMappedRange();
+
+    bool               Map( VSILFILE *fp, vsi_l_offset nStartIn, vsi_l_offset nEndIn );
+    void               Unmap();
+    bool               IsMapped() const { return psMem != NULL; }
+
+    /* bytes from nOffset to the end of the mapped range */
+    const char*        GetData( vsi_l_offset nOffset ) const;
+    vsi_l_offset       GetEnd() const { return nEnd; }
+};
+
+/************************************************************************/
+/*                        OGRVFPGeometryBuilder                         */
+/*                                                                      */
+/*      Builds the geometry of a record from the elements nested in     */
+/*      it: reg (solid and holes made of linpol or circle polygons),    */
+/*      lin (se and ar segments) and c points. True curves are kept     */
+/*      unless linearization is requested; rings and lines made only    */
+/*      of se segments give plain linear geometries.                    */
+/*                                                                      */
+/*      While the record is parsed only its coordinates and the paths   */
+/*      they form are collected, together with their envelope. The      */
+/*      geometry objects are built by GetGeometry(), which is not       */
+/*      called for records rejected by the spatial filter.              */
+/************************************************************************/
+
+/* Path of a record: a range of the coordinates and segments */
+typedef struct
+{
+    int                eType;   /* VFP_PATH_xxx */
+    int                nFirstPoint;
+    int                nEndPoint;
+    int                nFirstPart;
+    int                nEndPart;
+    int                iRegion; /* reg of a polygon, -1 if none */
+    double             dfRadius;
+} OGRVFPPath;
+
+#define VFP_PATH_POINT  0
+#define VFP_PATH_LINE   1
+#define VFP_PATH_RING   2
+#define VFP_PATH_CIRCLE 3
+
+class OGRVFPGeometryBuilder
+{
+private:
+    bool               bLinearize;
+    double             dfMaxAngleStep;
+
+    /* coordinates of the current record and the se or ar segments
+       they are split into; the buffers are kept between records */
+    std::vector<double> adfX;
+    std::vector<double> adfY;
+    std::vector<double> adfZ;
+    std::vector<int>   anPartStart;
+    std::vector<bool>  abPartIsArc;
+    std::vector<OGRVFPPath> asPaths;
+    int                nRegions;
+    bool               bHas3D;
+
+    bool               bHasEnvelope;
+    OGREnvelope        sEnvelope;
+
+    bool               bInSegment;
+    int                iCurPath;
+    int                iCurRegion;
+
+    std::vector<OGRCurve*> apoRings;
+    std::vector<OGRGeometry*> apoGeoms;
+
+    /* arena of the reader, for the scratch arrays of GetGeometry() */
+    OGRVFPArena*       poArena;
+
+    void               AddXYZ( double dfX, double dfY, double dfZ );
+    void               AddCoordinate( const char **ppszAttr );
+    void               StartPath( int eType );
+    void               MergeArcEnvelope( int nStart, int nEnd );
+    int                CompactPoints( int nStart, int nEnd );
+    void               SetPoints( OGRSimpleCurve *poCurve, int nStart, int nCount,
+                                  bool bClose );
+    OGRCurve*          BuildPath( OGRVFPPath *psPath, bool bRing );
+    OGRCurve*          BuildCircle( const OGRVFPPath *psPath );
+    OGRGeometry*       BuildRegion( int iFirstPath, int iEndPath );
+
+public:
+    OGRVFPGeometryBuilder( bool bLinearize, double dfMaxAngleStep,
+                           OGRVFPArena *poArena );
+    ~OGRVFPGeometryBuilder();
+
+    void               Reset();
+    void               StartElement( OGRVFPToken eToken, const char **ppszAttr );
+    void               EndElement( OGRVFPToken eToken );
+    bool               Intersects( const OGREnvelope &sFilter ) const;
+    bool               GetEnvelope( OGREnvelope *psEnvelope ) const;
+    OGRGeometry*       GetGeometry();
+};
+
+/* Byte range and envelope of a record, collected by a reader in scan
+   mode to build the spatial index of a layer */
+typedef struct
+{
+    vsi_l_offset       nOffset;
+    GUInt32            nSize;
+    GUInt32            iPath;   /* enclosing elements, index in a path table */
+    bool               bHasEnvelope;
+    OGREnvelope        sEnvelope;
+} OGRVFPRecordInfo;
+
+/* Byte range of a record, by FID, for the random reads of a layer */
+typedef struct
+{
+    vsi_l_offset       nOffset;
+    GUInt32            nSize;
+    GUInt32            iPath;   /* enclosing elements, index in a path table */
+} OGRVFPRecordRange;
+
+/* Attribute of the record being parsed, allocated in the arena */
+typedef struct
+{
+    int                iField;
+    const char*        pszValue;
+} OGRVFPAttribute;
+
+/************************************************************************/
+/*                             OGRVFPStats                              */
+/*                                                                      */
+/*      Counters of the parsing of a layer or of the scan of the file   */
+/*      by the datasource, reported in the VFP_STATS metadata domain.   */
+/*      The counters are always kept, the timers only with STATS=YES.   */
+/************************************************************************/
+
+typedef struct
+{
+    GIntBig            nBytesRead;        /* through VSIFReadL() */
+    GIntBig            nReadCalls;
+    GIntBig            nBytesMapped;      /* parsed in place from a mapping */
+    GIntBig            nXMLEvents;        /* start and end tags, STATS=YES only */
+    GIntBig            nRecords;
+    GIntBig            nRecordsSkipped;   /* by the predicates or the envelope */
+    GIntBig            nFeaturesBuilt;
+    GIntBig            nFeaturesReturned; /* by GetNextFeature() */
+    GIntBig            nFeaturesFiltered; /* built, rejected by the OGR filters */
+
+    /* nanoseconds */
+    GIntBig            nReadNs;
+    GIntBig            nExpatNs;          /* in expat, handlers included */
+    GIntBig            nHandlersNs;
+    GIntBig            nAttributesNs;     /* copy of the values, predicates */
+    GIntBig            nCoordinatesNs;    /* geometry builder events */
+    GIntBig            nGeometryNs;       /* OGRGeometry of the records */
+    GIntBig            nFilterNs;         /* envelope and OGR filters */
+    GIntBig            nFeatureNs;        /* OGRFeature and its fields */
+} OGRVFPStats;
+
+GIntBig OGRVFPGetTimeNs();
+void    OGRVFPResetStats( OGRVFPStats *psStats );
+void    OGRVFPAddStats( OGRVFPStats *psTo, const OGRVFPStats *psFrom );
+char**  OGRVFPStatsToList( const OGRVFPStats *psStats, char **papszList );
+
+/************************************************************************/
+/*                          Arrow C interfaces                          */
+/*                                                                      */
+/*      ABI of the Arrow C data and C stream interfaces, which GDAL     */
+/*      does not provide yet. The guards are those of the Arrow         */
+/*      headers, so that either definition can come first.              */
+/************************************************************************/
+
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema
+{
+    const char*        format;
+    const char*        name;
+    const char*        metadata;
+    int64_t            flags;
+    int64_t            n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+    void             (*release)( struct ArrowSchema * );
+    void*              private_data;
+};
+
+struct ArrowArray
+{
+    int64_t            length;
+    int64_t            null_count;
+    int64_t            offset;
+    int64_t            n_buffers;
+    int64_t            n_children;
+    const void**       buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+    void             (*release)( struct ArrowArray * );
+    void*              private_data;
+};
+
+#endif /* ARROW_C_DATA_INTERFACE */
+
+#ifndef ARROW_C_STREAM_INTERFACE
+#define ARROW_C_STREAM_INTERFACE
+
+struct ArrowArrayStream
+{
+    int              (*get_schema)( struct ArrowArrayStream *, struct ArrowSchema *out );
+    int              (*get_next)( struct ArrowArrayStream *, struct ArrowArray *out );
+    const char*      (*get_last_error)( struct ArrowArrayStream * );
+    void             (*release)( struct ArrowArrayStream * );
+    void*              private_data;
+};
+
+#endif /* ARROW_C_STREAM_INTERFACE */
+
+CPL_C_START
+/* Arrow stream of the features of a VFP layer, see
+   OGRVFPLayer::GetArrowStream(). FALSE if hLayer is not a VFP layer. */
+int CPL_DLL OGR_VFP_L_GetArrowStream( OGRLayerH hLayer,
+                                      struct ArrowArrayStream *psStream,
+                                      char **papszOptions );
+CPL_C_END
+
+/************************************************************************/
+/*                           OGRVFPArrowBatch                           */
+/*                                                                      */
+/*      Columns of the records of an Arrow stream batch, appended       */
+/*      from the raw attribute values without any OGRFeature. The       */
+/*      fields named in DICTIONARY_FIELDS are dictionary encoded on     */
+/*      their raw values: each distinct value of a batch is converted   */
+/*      once. The geometry is a WKB binary column. Export() hands the   */
+/*      buffers over to an ArrowArray and starts an empty batch.        */
+/************************************************************************/
+
+/* Growable buffer, owned by the ArrowArray once exported */
+typedef struct
+{
+    GByte*             pabyData;
+    size_t             nSize;
+    size_t             nAlloc;
+} OGRVFPArrowBuffer;
+
+typedef struct
+{
+    int                iField;
+    OGRFieldType       eType;
+    bool               bDictionary;
+
+    OGRVFPArrowBuffer  sValidity;
+    OGRVFPArrowBuffer  sValues;     /* int32 indices of a dictionary */
+    OGRVFPArrowBuffer  sOffsets;    /* int32, strings only */
+    int                nNulls;
+
+    /* raw values of the batch and their index in the dictionary */
+    std::map<CPLString, int> oDictionary;
+    OGRVFPArrowBuffer  sDictValues;
+    OGRVFPArrowBuffer  sDictOffsets;
+} OGRVFPArrowColumn;
+
+class OGRVFPArrowBatch
 {
 private:
     OGRFeatureDefn*    poFeatureDefn;
-    OGRSpatialReference *poSRS;
-    OGRVFPDataSource*  poDS;
+    bool               bIncludeFID;
+    bool               bIncludeGeometry;
 
-    int                nFeatures;
+    std::vector<OGRVFPArrowColumn*> apoColumns;
+    std::vector<const char*> apszRecordValues;
 
-    const char*        pszElementToScan;
+    OGRVFPArrowBuffer  sFIDs;
+    OGRVFPArrowBuffer  sGeomValidity;
+    OGRVFPArrowBuffer  sGeomOffsets;
+    OGRVFPArrowBuffer  sGeomData;
+    int                nGeomNulls;
+
+    int                nLength;
+
+    void               Clear();
+
+public:
+    OGRVFPArrowBatch( OGRFeatureDefn *poFeatureDefn, bool bIncludeFID,
+                      char **papszDictionaryFields );
+    ~OGRVFPArrowBatch();
+
+    void               AddRecord( GIntBig nFID, const OGRVFPAttribute *pasAttrs,
+                                  int nAttrs, OGRGeometry *poGeom );
+    int                GetLength() const { return nLength; }
+
+    void               GetSchema( struct ArrowSchema *psSchema ) const;
+    void               Export( struct ArrowArray *psArray );
+};
+
+/* Comparison of a field with constants taken from the attribute filter,
+   evaluated by the readers on the raw value of the attribute */
+class OGRVFPPredicate
+{
+public:
+    int                iField;
+    OGRFieldType       eFieldType;
+    int                nOperation;  /* SWQ_EQ, SWQ_IN, SWQ_BETWEEN, ... */
+    std::vector<CPLString> aosValues;
+    std::vector<double> adfValues;
+
+    bool               Evaluate( const char *pszValue ) const;
+};
+
+/************************************************************************/
+/*                             OGRVFPReader                             */
+/*                                                                      */
+/*      Parses a byte range of a layer element and builds its           */
+/*      features. The range is either the whole layer element or a      */
+/*      slice of its records, in which case the elements enclosing      */
+/*      the records are given as a prefix and a suffix.                 */
+/************************************************************************/
+
+class OGRVFPReader
+{
+private:
+    OGRVFPLayer*       poLayer;
+    OGRFeatureDefn*    poFeatureDefn;
+    int                nRecordDepth;
+
+    VSILFILE*          fp;
+    bool               bOwnFile;
+
+    vsi_l_offset       nEndOffset;
+    vsi_l_offset       nReadOffset;
+    int                nReadChunkSize;
+    CPLString          osSuffix;
+
+    /* the range is parsed from a mapping of the file if possible */
+    OGRVFPMappedRange  oMappedRange;
 
 #ifdef HAVE_EXPAT
     XML_Parser         oParser;
-    XML_Parser         oSchemaParser;
+    bool               bParserSuspended;
+    bool               bLastChunk;
 #endif
 
-    OGRFeature*        poFeature;
+    bool               bStarted;
+    bool               bEOF;
+    GIntBig            nNextFID;
+
+    /* queue of completed features, the parser is suspended when
+       nFeatureTabSize features are queued (0 means unbounded) */
+    OGRFeature**       ppoFeatureTab;
+    int                nFeatureTabSize;
+    int                nFeatureTabAlloc;
+    int                nFeatureTabLength;
+    int                nFeatureTabIndex;
+
+    /* attributes of the current record; its feature is only created
+       when the record ends and its envelope passes the filter. They
+       are copied to the arena, which is rewound at each record. */
+    bool               bInRecord;
+    OGRVFPArena        oArena;
+    OGRVFPAttribute*   pasAttrs;
+    int                nAttrs;
+    OGRVFPGeometryBuilder* poGeomBuilder;
 
-    VSILFILE*          fpVFP; /* Large file API */
+    /* merged into the statistics of the layer by the destructor */
+    bool               bStats;
+    OGRVFPStats        sStats;
 
-    void               LoadSchema();
+    /* projection taken from the feature definition by Start(): the
+       ignored fields are neither copied nor set, and the elements
+       below the record are skipped if the geometry is ignored */
+    std::vector<bool>  abIgnoredFields;
+    bool               bIgnoreAllFields;
+    bool               bIgnoreGeometry;
+
+    bool               bIgnoreFilters;
+    bool               bFilterGeom;
+    OGREnvelope        sFilterEnvelope;
+    const std::vector<OGRVFPPredicate>* pasPredicates;
+    bool               bSkipRecord;
+
+    /* scan mode: the byte range and envelope of each record are
+       collected instead of its feature */
+    std::vector<OGRVFPRecordInfo>* pasRecordInfo;
+
+    /* Arrow mode: the records are appended to a batch instead of
+       being returned as features, see OGRVFPLayer::GetArrowStream() */
+    OGRVFPArrowBatch*  poArrowBatch;
+    int                nArrowBatchSize;
+
+    /* filters of the layer when the stream was created, which do not
+       follow the later changes of those of the layer */
+    OGRGeometry*       poArrowFilterGeom;
+    bool               bArrowFilterIsEnvelope;
+    OGRFeatureQuery*   poArrowAttrQuery;
+    std::vector<OGRVFPPredicate> asArrowPredicates;
+
+    bool               FilterArrowGeometry( OGRGeometry *poGeom );
+
+    /* count mode: the records are counted and their envelopes merged,
+       neither the attributes nor the features are kept */
+    bool               bCountOnly;
+    bool               bHasCountExtent;
+    OGREnvelope        sCountExtent;
+
+    /* FID table of the layer: the byte range of the record of the
+       next FID missing from it is appended, with or without building
+       the features */
+    std::vector<OGRVFPRecordRange>* pasRecordRanges;
+    bool               bRecordRangesOnly;
+
+    /* enclosing elements of the records, for both */
+    std::vector<CPLString>* paosRecordPaths;
+    std::vector<CPLString> aosPath;
+    int                iRecordPath;
+    GIntBig            nHeadOffset;
+    vsi_l_offset       nRecordOffset;
+    vsi_l_offset       nRecordTagEnd;
+
+    vsi_l_offset       GetFileOffset( GIntBig nByteIndex )
+                        { return (vsi_l_offset)(nHeadOffset + nByteIndex); }
 
     bool               bStopParsing;
+    bool               bError;
     int                nWithoutEventCounter;
     int                nDataHandlerCounter;
     int                depthLevel;
-    bool               inInterestingElement;
-    int                interestingDepthLevel;
+
+public:
+    OGRVFPReader( OGRVFPLayer *poLayer, int nMaxQueuedFeatures );
+    ~OGRVFPReader();
+
+    bool               Start( VSILFILE *fpIn, bool bOwnFileIn,
+                              vsi_l_offset nStart, vsi_l_offset nEnd,
+                              GIntBig nFirstFID,
+                              const char *pszPrefix = NULL,
+                              const char *pszSuffix = NULL );
+    void               Stop();
+    void               ParseNextChunk();
+    void               SetScanMode( std::vector<OGRVFPRecordInfo> *pasRecordInfoIn,
+                                    std::vector<CPLString> *paosRecordPathsIn );
+    void               SetRecordRanges( std::vector<OGRVFPRecordRange> *pasRecordRangesIn,
+                                        std::vector<CPLString> *paosRecordPathsIn,
+                                        bool bRecordRangesOnlyIn );
+    void               SetIgnoreFilters( bool bIgnoreFiltersIn )
+                            { bIgnoreFilters = bIgnoreFiltersIn; }
+    void               SetCountMode() { bCountOnly = TRUE; }
+    void               SetArrowBatch( OGRVFPArrowBatch *poArrowBatchIn, int nBatchSize );
+    bool               GetCountExtent( OGREnvelope *psExtent );
+
+    OGRFeature*        GetNextQueuedFeature();
+    GIntBig            GetNextFID() { return nNextFID; }
+    bool               IsStarted() { return bStarted; }
+    bool               IsFinished() { return bStopParsing; }
+    bool               HasFailed() { return bError; }
+    const OGRVFPStats* GetStats() { return &sStats; }
+
+#ifdef HAVE_EXPAT
+    void               startElementCbk(const char *pszName, const char **ppszAttr);
+    void               endElementCbk(const char *pszName);
+    void               startElementStatsCbk(const char *pszName, const char **ppszAttr);
+    void               endElementStatsCbk(const char *pszName);
+    void               dataHandlerCbk(const char *data, int nLen);
+    void               GetRecordRange( OGRVFPRecordRange *psRange );
+    void               AddRecordInfo();
+    bool               EvaluatePredicates(int iField, const char *pszValue);
+    void               SetFields( OGRFeature *poFeature );
+    void               AddArrowRecord( GIntBig nFID );
+#endif
+};
+
+/************************************************************************/
+/*                              OGRVFPRTree                             */
+/*                                                                      */
+/*      Spatial index of a layer stored in a <file>.<layer>.vfpr        */
+/*      sidecar: the byte range of each record by FID, and a packed     */
+/*      Hilbert R-tree of the record envelopes. Nodes are read from     */
+/*      the file on demand.                                             */
+/************************************************************************/
+
+class OGRVFPRTree
+{
+private:
+    VSILFILE*          fp;
+    GUIntBig           nFeatures;
+    GUIntBig           nItems;
+    int                nNodeSize;
+    OGREnvelope        sExtent;
+    std::vector<CPLString> aosPaths;
+    vsi_l_offset       nRecordTableOffset;
+    vsi_l_offset       nTreeOffset;
+
+    /* level 0 holds the leaves, the last level the root */
+    std::vector<GUIntBig> anLevelStart;
+    std::vector<GUIntBig> anLevelSize;
+
+                       OGRVFPRTree();
+
+public:
+                       ~OGRVFPRTree();
+
+    static bool        Build( const char *pszFilename, const char *pszDataFilename,
+                              vsi_l_offset nSectionStart,
+                              const std::vector<OGRVFPRecordInfo>& asRecords,
+                              const std::vector<CPLString>& aosPathsIn );
+    static OGRVFPRTree* Open( const char *pszFilename, const char *pszDataFilename,
+                              vsi_l_offset nSectionStart );
+
+    GIntBig            GetFeatureCount() { return (GIntBig)nFeatures; }
+    bool               GetExtent( OGREnvelope *psExtent );
+    bool               Search( const OGREnvelope &sFilter,
+                               std::vector<GIntBig> &anFIDs );
+    bool               GetRecord( GIntBig nFID, vsi_l_offset *pnOffset,
+                                  GUInt32 *pnSize, const char **ppszPath );
+};
+
+/************************************************************************/
+/*                          OGRVFPFeatureCache                          */
+/*                                                                      */
+/*      Binary copy of the features of a layer in a                     */
+/*      <file>.<layer>.vfpc sidecar, written by the first complete      */
+/*      read of the layer with FEATURE_CACHE=YES. The fields are        */
+/*      stored in the order of the schema, the geometry as ISO WKB      */
+/*      with its envelope, and a table gives the offset of each         */
+/*      record by FID. Later opens of the unchanged file read the       */
+/*      features from a mapping of the cache instead of parsing XML.    */
+/************************************************************************/
+
+class OGRVFPFeatureCache
+{
+private:
+    VSILFILE*          fp;
+    OGRVFPMappedRange  oMappedRange;
+    std::vector<GUIntBig> anOffsets;    /* nFeatures + 1 entries */
+    std::vector<GByte> abyRecord;       /* record read when not mapped */
+    int                nFields;
+
+                       OGRVFPFeatureCache();
+
+    const GByte*       GetRecord( GIntBig nFID, size_t *pnSize );
+
+public:
+                       ~OGRVFPFeatureCache();
+
+    static OGRVFPFeatureCache* Open( const char *pszFilename,
+                                     const char *pszDataFilename,
+                                     GUInt32 nHeaderHash,
+                                     vsi_l_offset nSectionStart,
+                                     OGRFeatureDefn *poFeatureDefn,
+                                     bool bLinearize, double dfMaxAngleStep,
+                                     bool bUseMmap );
+
+    GIntBig            GetFeatureCount() { return (GIntBig)anOffsets.size() - 1; }
+
+    /* NULL at the end of the layer, on error, or with *pbSkipped set
+       when the envelope of the geometry does not intersect psFilter */
+    OGRFeature*        GetFeature( GIntBig nFID, OGRFeatureDefn *poFeatureDefn,
+                                   OGRSpatialReference *poSRS,
+                                   const OGREnvelope *psFilter,
+                                   bool *pbSkipped, bool *pbError );
+};
+
+/************************************************************************/
+/*                       OGRVFPFeatureCacheWriter                       */
+/*                                                                      */
+/*      Appends the features of a sequential read to a .vfpc file.      */
+/*      The header is written last by Finish(), so a cache left         */
+/*      incomplete is never used.                                       */
+/************************************************************************/
+
+class OGRVFPFeatureCacheWriter
+{
+private:
+    VSILFILE*          fp;
+    CPLString          osFilename;
+    std::vector<GUIntBig> anOffsets;
+    std::vector<GByte> abyRecord;
+    GUIntBig           nOffset;
+    bool               bError;
+
+public:
+                       OGRVFPFeatureCacheWriter();
+                       ~OGRVFPFeatureCacheWriter();
+
+    bool               Create( const char *pszFilename );
+    bool               AddFeature( OGRFeature *poFeature );
+    bool               Finish( const char *pszDataFilename, GUInt32 nHeaderHash,
+                               vsi_l_offset nSectionStart,
+                               OGRFeatureDefn *poFeatureDefn,
+                               bool bLinearize, double dfMaxAngleStep );
+    void               Abort();
+
+    GIntBig            GetFeatureCount() { return (GIntBig)anOffsets.size(); }
+};
+
+GUInt32 OGRVFPHash( const void *pData, size_t nSize, GUInt32 nHash = 2166136261U );
+
+/************************************************************************/
+/*                             OGRVFPSlice                              */
+/************************************************************************/
+
+/* Record boundary from which a layer element can be parsed on its own */
+typedef struct
+{
+    vsi_l_offset       nOffset;
+    GIntBig            nFID;
+    CPLString          osPath;  /* enclosing elements, e.g. "zs/plins" */
+} OGRVFPSplitPoint;
+
+/* Byte range of a layer element in the file, empty if the element is
+   not present, its record boundaries about every VFP_SLICE_SIZE bytes
+   and its number of records. Found by OGRVFPDataSource::ScanSections()
+   for all layers, whether they have been instantiated or not. The
+   extent is added by the first GetExtent() of the layer. All of it is
+   kept in the .vfpi index. */
+typedef struct
+{
+    vsi_l_offset       nStart;
+    vsi_l_offset       nEnd;
+    std::vector<OGRVFPSplitPoint> asSplitPoints;
+    GIntBig            nFeatureCount;   /* -1 if unknown */
+    bool               bExtentScanned;
+    bool               bHasExtent;      /* FALSE if no record has coordinates */
+    OGREnvelope        sExtent;
+} OGRVFPSection;
+
+/* Slice of a layer element parsed by one of the NUM_THREADS workers */
+typedef struct
+{
+    vsi_l_offset       nStart;
+    vsi_l_offset       nEnd;
+    GIntBig            nFirstFID;
+    CPLString          osPrefix;
+    CPLString          osSuffix;
+    OGRVFPReader*      poReader;
+    bool               bDone;
+} OGRVFPSlice;
+
+/************************************************************************/
+/*                           OGRVFPLayerDesc                            */
+/*                                                                      */
+/*      Layers and fields defined by the VFP schema. The tables are     */
+/*      generated from data/vfp_3.1.xsd into ogrvfpschema.h.            */
+/************************************************************************/
+
+typedef struct
+{
+    const char*        pszName;   /* attribute of the record elements */
+    OGRFieldType       eType;
+} OGRVFPFieldDesc;
+
+/* Geometry of a record template */
+#define VFP_RECORD_NONE       0
+#define VFP_RECORD_REGION     1     /* reg */
+#define VFP_RECORD_LINE       2     /* lin */
+#define VFP_RECORD_POINT      3     /* c */
+#define VFP_RECORD_POINT_ATTR 4     /* sx, sy and sz attributes */
+
+/* How the writer encodes a feature as a record of a layer */
+typedef struct
+{
+    const char*        pszGroup;  /* element between the layer and the
+                                     records if nRecordDepth is 2 */
+    const char*        pszRecord;
+    const char*        pszType;   /* xsi:type of the record, or NULL */
+    int                eGeometry; /* VFP_RECORD_xxx */
+    const char*        pszGeometryPath; /* "gpar/area/reg", or NULL */
+    int                iRepeat;   /* element of the path repeated for the
+                                     parts of a multi geometry, or -1 */
+    bool               bLabel;    /* a t label follows reg */
+    GUInt32            nFieldMask; /* fields written as attributes */
+} OGRVFPRecordDesc;
+
+typedef struct
+{
+    const char*        pszName;   /* top-level element of v:vfp */
+    OGRVFPToken        eToken;
+    int                nRecordDepth;
+    bool               bHasGeometry;
+    const OGRVFPFieldDesc *pasFields;
+    int                nFields;
+    const OGRVFPRecordDesc *pasRecords;
+    int                nRecords;
+} OGRVFPLayerDesc;
+
+typedef struct
+{
+    const char*        pszName;
+    OGRVFPToken        eToken;
+} OGRVFPTokenDesc;
+
+/************************************************************************/
+/*                             OGRVFPLayer                              */
+/************************************************************************/
+
+class OGRVFPLayer : public OGRLayer
+{
+    friend class OGRVFPReader;
+
+private:
+    OGRFeatureDefn*    poFeatureDefn;
+    OGRSpatialReference *poSRS;
+    OGRVFPDataSource*  poDS;
+
+    const char*        pszElementToScan;
+    OGRVFPToken        eElementToken;
+    int                nRecordDepth;
+
+    /* owned by the datasource, valid once ScanSections() was called */
+    const OGRVFPSection* psSection;
+
+    /* index of the field of each attribute token, -1 for the others */
+    std::vector<int>   anFieldByToken;
+
+    OGRVFPReader*      poReader;
+
+    /* PARSER_THREADS=YES: the file is parsed by a worker thread
+       feeding a single-producer/single-consumer ring of features */
+    bool               bUseParserThread;
+    CPLJoinableThread* hParserThread;
+    CPLMutex*          hRingMutex;
+    CPLCond*           hRingCond;
+    OGRFeature**       papoRing;
+    int                nRingSize;
+    volatile int       nRingHead;
+    volatile int       nRingTail;
+    volatile int       nRingWaiters;
+    volatile int       bParserThreadDone;
+    volatile int       bAbortParserThread;
+    OGRVFPStats        sParserThreadStats; /* copy of the stats of poReader,
+                                              under hRingMutex */
+
+    static void        ParserThreadFunc( void *pData );
+    void               RunParserThread();
+    void               StopParserThread();
+    void               WakeUpRingWaiter();
+    bool               PushFeature( OGRFeature *poFeatureIn );
+    OGRFeature*        PopFeature();
+
+    /* NUM_THREADS > 1: slices of the layer element are parsed
+       concurrently and their features returned in document order */
+    int                nParseThreads;
+    std::vector<OGRVFPSlice*> apoSlices;
+    std::vector<CPLJoinableThread*> ahSliceThreads;
+    CPLMutex*          hSliceMutex;
+    CPLCond*           hSliceCond;
+    int                nNextSliceToParse;
+    int                nCurrentSlice;
+    volatile int       bAbortSlices;
+
+    static void        SliceThreadFunc( void *pData );
+    void               RunSliceThread();
+    bool               StartSliceThreads();
+    void               StopSliceThreads();
+    OGRFeature*        GetNextSliceFeature();
+
+    /* simple parts of the attribute filter */
+    std::vector<OGRVFPPredicate> asPredicates;
+
+    void               CompilePredicates( swq_expr_node *poNode );
+
+    /* spatial index, opened or built on the first spatial query */
+    OGRVFPRTree*       poRTree;
+    bool               bRTreeChecked;
+    bool               bRTreeBuildFailed;
+    CPLString          osRTreeFilename;
+    bool               bRTreeInMemory;
+    std::vector<GIntBig> anCandidateFIDs;
+    size_t             iNextCandidate;
+    bool               bCandidatesFetched;
+
+    OGRVFPRTree*       GetRTree( bool bBuild );
+    bool               HasOpenRTree();
+    bool               BuildRTree();
+    OGRFeature*        GetNextIndexedFeature();
+
+    /* byte ranges of the records by FID, appended as the records are
+       read from the start of the layer and by ScanRecordRanges() */
+    std::vector<OGRVFPRecordRange> asRecordRanges;
+    std::vector<CPLString> aosRecordPaths;
+    bool               bRecordRangesComplete;
+    OGRVFPReader*      poRandomReader;
+
+    bool               GetRecordRange( GIntBig nFID, vsi_l_offset *pnOffset,
+                                       GUInt32 *pnSize, const char **ppszPath );
+    void               ScanRecordRanges( GIntBig nFID );
+
+    /* FEATURE_CACHE=YES: features read from the .vfpc file, or written
+       to it by a complete sequential read without filters */
+    OGRVFPFeatureCache* poFeatureCache;
+    bool               bFeatureCacheChecked;
+    CPLString          osFeatureCacheFilename;
+    GIntBig            nNextCachedFID;
+    OGRVFPFeatureCacheWriter* poCacheWriter;
+    bool               bCacheWritePending;
+    bool               bCacheWriteFailed;
+    /* set when a slice or the parser thread failed, their readers are
+       not poReader; the cache of such a read is not kept */
+    bool               bReadFailed;
+
+    OGRVFPFeatureCache* GetFeatureCache();
+    OGRFeature*        GetNextCachedFeature();
+    void               StartCacheWriter();
+    void               FinishCacheWriter();
+    void               AbortCacheWriter();
+
+    /* first record of the sequential read, set by SetNextByIndex() */
+    GIntBig            nStartFID;
+    vsi_l_offset       nStartOffset;
+    CPLString          osStartPrefix;
+
+    bool               StartReader();
+
+    bool               CountFeatures();
+
+    /* statistics of the readers deleted so far, see AddStats() */
+    bool               bStats;
+    OGRVFPStats        sStats;
+    char**             papszStatsMetadata;
+
+    OGRFeature*        GetNextRawFeature();
 
 public:
     OGRVFPLayer(const char *pszFilename,
-                const char* layerName,
+                const OGRVFPLayerDesc *psDesc,
+                const OGRVFPSection *psSection,
                 OGRVFPDataSource* poDS);
     ~OGRVFPLayer();
 
+    const char*         GetElementName() { return pszElementToScan; }
+    OGRVFPToken         GetElementToken() { return eElementToken; }
+    const char*         GetAttributeFilter() { return m_pszAttrQueryString; }
+
     void                ResetReading();
     OGRFeature *        GetNextFeature();
-    
+    OGRFeature *        GetFeature( GIntBig nFID );
+    OGRErr              SetNextByIndex( GIntBig nIndex );
+    void                SetSpatialFilter( OGRGeometry *poGeom );
+    void                SetSpatialFilter( int iGeomField, OGRGeometry *poGeom );
+    OGRErr              SetAttributeFilter( const char *pszQuery );
+    OGRErr              SetIgnoredFields( const char **papszFields );
+    int                 GetArrowStream( struct ArrowArrayStream *psStream,
+                                        char **papszOptions = NULL );
+    GIntBig             GetFeatureCount( int bForce = TRUE );
+    OGRErr              GetExtent( OGREnvelope *psExtent, int bForce = TRUE );
+    OGRErr              GetExtent( int iGeomField, OGREnvelope *psExtent, int bForce )
+                            { return OGRLayer::GetExtent(iGeomField, psExtent, bForce); }
+
+    void                PrepareSpatialIndex();
+
+    /* called by the destructor of each reader, on the main thread */
+    void                AddStats( const OGRVFPStats *psStats )
+                            { OGRVFPAddStats(&sStats, psStats); }
+
+    char**              GetMetadataDomainList();
+    char**              GetMetadata( const char *pszDomain = "" );
+    const char*         GetMetadataItem( const char *pszName,
+                                         const char *pszDomain = "" );
 
     OGRFeatureDefn *    GetLayerDefn() { return poFeatureDefn; }
     
     int                 TestCapability( const char * );
+};
 
-#ifdef HAVE_EXPAT
-    void                startElementLoadSchemaCbk(const char *pszName, const char **ppszAttr);
-    void                endElementLoadSchemaCbk(const char *pszName);
-    void                dataHandlerLoadSchemaCbk(const char *data, int nLen);
-#endif
+/************************************************************************/
+/*                           OGRVFPJoinLayer                            */
+/*                                                                      */
+/*      Result of an equi-join of two layers by ExecuteSQL(). The       */
+/*      attributes of the secondary layer are read once into memory     */
+/*      with a hash index on its key, then the primary layer is         */
+/*      streamed and each of its features is joined with the matching   */
+/*      secondary features, so the join costs one pass over each        */
+/*      layer. As in OGR SQL, a primary feature is joined with the      */
+/*      first match only unless bOneToMany is set.                      */
+/************************************************************************/
+
+class OGRVFPJoinLayer : public OGRLayer
+{
+private:
+    OGRFeatureDefn*    poFeatureDefn;
+    OGRVFPLayer*       poPrimary;
+    OGRVFPLayer*       poSecondary;
+    int                iPrimaryField;
+    int                iSecondaryField;
+    bool               bLeftJoin;
+    bool               bOneToMany;
+
+    /* filters of the source layers when the join was created, which
+       are cleared as OGR SQL does and restored by the destructor */
+    char*              pszPrimaryAttrFilter;
+    OGRGeometry*       poPrimaryFilterGeom;
+    char*              pszSecondaryAttrFilter;
+    OGRGeometry*       poSecondaryFilterGeom;
+
+    /* type in which the keys are compared: OFTInteger64, OFTReal or
+       OFTString */
+    OGRFieldType       eKeyType;
+
+    /* features of the secondary layer, without their geometries, and
+       their indices by the hash of the key */
+    bool               bIndexBuilt;
+    std::vector<OGRFeature*> apoSecondaryFeatures;
+    std::vector< std::vector<int> > aanBuckets;
+
+    OGRFeature*        poPrimaryFeature;
+    std::vector<int>   anMatches;
+    size_t             iNextMatch;
+    GIntBig            nNextFID;
+
+    GUInt32            HashKey( OGRFeature *poFeature, int iField );
+    bool               EqualKeys( OGRFeature *poFeature1, int iField1,
+                                  OGRFeature *poFeature2, int iField2 );
+    int                FindFirstMatch( OGRFeature *poFeature, int iField,
+                                       GUInt32 nHash );
+    void               BuildIndex();
+    void               FindMatches( OGRFeature *poFeature );
+    OGRFeature*        BuildFeature( OGRFeature *poSecondaryFeature );
+
+public:
+    OGRVFPJoinLayer( OGRVFPLayer *poPrimary, int iPrimaryField,
+                     OGRVFPLayer *poSecondary, int iSecondaryField,
+                     bool bLeftJoin, bool bOneToMany );
+    ~OGRVFPJoinLayer();
+
+    static bool         GetKeyType( OGRFieldType ePrimaryType,
+                                    OGRFieldType eSecondaryType,
+                                    OGRFieldType *peKeyType );
+
+    void                ResetReading();
+    OGRFeature *        GetNextFeature();
+    void                SetSpatialFilter( OGRGeometry *poGeom );
+    void                SetSpatialFilter( int iGeomField, OGRGeometry *poGeom )
+                            { OGRLayer::SetSpatialFilter(iGeomField, poGeom); }
+
+    OGRFeatureDefn *    GetLayerDefn() { return poFeatureDefn; }
+
+    int                 TestCapability( const char * );
 };
 
 /************************************************************************/
-/*                           OGRVFPDataSource                           */
+/*                             OGRVFPWriter                             */
+/*                                                                      */
+/*      Output of a document created by the driver. The XML is          */
+/*      formatted straight into a large buffer which is written to      */
+/*      the file whenever it is full, so the memory used does not       */
+/*      depend on the size of the document. The layer elements are      */
+/*      written in the order of the schema: starting a layer closes     */
+/*      the previous one, which cannot be written to any more.          */
 /************************************************************************/
 
-typedef enum
+class OGRVFPWriter
 {
-    VFP_VALIDITY_UNKNOWN,
-    VFP_VALIDITY_INVALID,
-    VFP_VALIDITY_VALID
-} OGRVFPValidity;
+private:
+    VSILFILE*          fp;
+    char*              pachBuffer;
+    size_t             nBufferSize;
+    size_t             nBufferUsed;
+    bool               bError;
+
+    /* open elements: the current layer (index in asVFPLayers, -1
+       before the first one) and its record group if it has one */
+    int                iCurLayer;
+    const char*        pszCurLayer;
+    const char*        pszCurGroup;
+    std::vector<const char*> apszUsedGroups;
+    bool               bWarnedGroups;
+
+    bool               FlushBuffer();
+    char*              Reserve( size_t nSize );
+    void               WriteInteger( GIntBig nValue );
+    void               WriteReal( double dfValue );
+    void               WriteCoordinate( double dfValue );
+    void               EndGroup();
+
+public:
+    OGRVFPWriter( VSILFILE *fp, int nBufferSize );
+    ~OGRVFPWriter();
+
+    void               Write( const char *pachData, size_t nSize );
+    void               Write( const char *pszStr ) { Write(pszStr, strlen(pszStr)); }
+    void               WriteEscaped( const char *pszStr );
+    void               WriteAttribute( const char *pszName, const char *pszValue );
+    void               WriteIntegerAttribute( const char *pszName, GIntBig nValue );
+    void               WriteRealAttribute( const char *pszName, double dfValue );
+    void               WriteCoordinateAttribute( const char *pszName, double dfValue );
+    void               WritePoint( double dfX, double dfY, double dfZ, bool b3D );
+    void               StartElement( const char *pszName );
+    void               EndElement( const char *pszName );
+
+    bool               StartLayer( int iLayer, const char *pszName );
+    void               StartGroup( const char *pszGroup );
+    void               EndLayer();
+    bool               Close();
+
+    bool               HasError() const { return bError; }
+};
+
+/************************************************************************/
+/*                          OGRVFPWriterLayer                           */
+/*                                                                      */
+/*      Layer of a document being created. Its fields are those of      */
+/*      the schema, and each feature is written out as soon as it is    */
+/*      created, with the record template matching its geometry.        */
+/************************************************************************/
+
+class OGRVFPWriterLayer : public OGRLayer
+{
+private:
+    OGRFeatureDefn*    poFeatureDefn;
+    OGRVFPWriter*      poWriter;
+    int                iLayer;      /* index in asVFPLayers */
+    const OGRVFPLayerDesc *psDesc;
+
+    /* elements of the geometry path of each record template */
+    std::vector<char**> apapszPaths;
+
+    GIntBig            nFeatures;
+    bool               bWarnedNoGeometry;
+    bool               bWarnedParts;
+
+    int                FindRecord( OGRFeature *poFeature, OGRGeometry *poGeom );
+    void               WriteAttributes( const OGRVFPRecordDesc *psRecord,
+                                        OGRFeature *poFeature );
+    void               WriteGeometry( int iRecord, OGRGeometry *poGeom,
+                                      const char *pszLabel );
+    void               WritePart( const OGRVFPRecordDesc *psRecord,
+                                  const char *pszElement, OGRGeometry *poPart,
+                                  bool b3D );
+    void               WriteRing( OGRCurve *poRing, bool b3D );
+    void               WriteSegments( OGRCurve *poCurve, bool b3D );
+    void               WriteLabel( OGRGeometry *poGeom, const char *pszLabel );
+
+public:
+    OGRVFPWriterLayer( OGRVFPWriter *poWriter, int iLayer,
+                       const OGRVFPLayerDesc *psDesc,
+                       OGRSpatialReference *poSRS );
+    ~OGRVFPWriterLayer();
+
+    int                 GetSchemaIndex() { return iLayer; }
+
+    void                ResetReading() {}
+    OGRFeature *        GetNextFeature() { return NULL; }
+    OGRErr              ICreateFeature( OGRFeature *poFeature );
+    OGRErr              CreateField( OGRFieldDefn *poField, int bApproxOK = TRUE );
+
+    OGRFeatureDefn *    GetLayerDefn() { return poFeatureDefn; }
+
+    int                 TestCapability( const char * );
+};
+
+/************************************************************************/
+/*                           OGRVFPDataSource                           */
+/************************************************************************/
 
 class OGRVFPDataSource : public OGRDataSource
 {
 private:
     char*               pszName;
 
+    /* a layer is instantiated by the first GetLayer() call for it */
     OGRVFPLayer**       papoLayers;
     int                 nLayers;
+    std::vector<OGRVFPSection> asSections;
 
-    OGRVFPValidity      validity;
     char*               pszVersion;
+    char*               pszEncoding;
+
+    /* S-JTSK, shared by the layers */
+    OGRSpatialReference* poSRS;
+    bool                bSRSInitialized;
+
+    /* handle taken over from the GDALOpenInfo, shared by the readers of
+       all layers, see ReadFile() */
+    VSILFILE*           fpVFP;
+    CPLMutex*           hFileMutex;
+
+    bool                bUseIndex;
+    int                 nReadChunkSize;
+    bool                bUseMmap;
+    int                 nFeatureQueueSize;
+    bool                bParserThreads;
+    int                 nParseThreads;
+    bool                bLinearize;
+    double              dfMaxAngleStep;
+    OGRVFPSpatialIndexMode eSpatialIndexMode;
+    bool                bFeatureCache;
+
+    /* STATS=YES, and the statistics of the scan of ParseSections() */
+    bool                bStats;
+    OGRVFPStats         sScanStats;
+    char**              papszStatsMetadata;
+
+    bool                ReadIndex();
+    void                WriteIndex();
+
+    bool                bSectionsScanned;
 
 #ifdef HAVE_EXPAT
     XML_Parser          oCurrentParser;
     int                 nDataHandlerCounter;
+
+    /* state of the single pass that finds the elements of all layers */
+    OGRVFPSection*      psCurSection;
+    int                 nCurRecordDepth;
+    bool                bStopParsing;
+    int                 nWithoutEventCounter;
+    int                 depthLevel;
+    std::vector<CPLString> aosScanPath;
+    GIntBig             nScanRecords;
+    vsi_l_offset        nLastSplitOffset;
+    int                 nSliceSize;
+
+    void                ParseSections();
 #endif
 
+    int                 FindLayerIndex( const char *pszElementName );
+    int                 FindLayerIndex( OGRVFPToken eToken );
+
+    OGRLayer*           ExecuteJoin( const char *pszStatement, bool bOneToMany );
+
+    /* document being created, the layers in the order of creation */
+    OGRVFPWriter*       poWriter;
+    std::vector<OGRVFPWriterLayer*> apoWriterLayers;
+
 public:
     OGRVFPDataSource();
     ~OGRVFPDataSource();
     
     const char*         GetName() { return pszName; }
 
-    int                 Open( const char * pszFilename,
-                              int bUpdate );
+    int                 Open( GDALOpenInfo *poOpenInfo );
+    int                 Create( const char *pszFilename, char **papszOptions );
     
-    int                 GetLayerCount() { return nLayers; }
+    int                 GetLayerCount();
     OGRLayer*           GetLayer( int );
-    
+    OGRLayer*           GetLayerByName( const char * );
+
+    OGRLayer*           ICreateLayer( const char *pszLayerName,
+                                      OGRSpatialReference *poSRS = NULL,
+                                      OGRwkbGeometryType eType = wkbUnknown,
+                                      char **papszOptions = NULL );
+    int                 TestCapability( const char * );
+
+    OGRLayer*           ExecuteSQL( const char *pszStatement,
+                                    OGRGeometry *poSpatialFilter,
+                                    const char *pszDialect );
+
+    const char*         GetEncoding() { return pszEncoding; }
+    int                 GetReadChunkSize() { return nReadChunkSize; }
+    bool                UseMmap() { return bUseMmap; }
+    int                 GetFeatureQueueSize() { return nFeatureQueueSize; }
+    bool                UseParserThreads() { return bParserThreads; }
+    int                 GetParseThreads() { return nParseThreads; }
+    bool                GetLinearize() { return bLinearize; }
+    double              GetMaxAngleStep() { return dfMaxAngleStep; }
+    OGRVFPSpatialIndexMode GetSpatialIndexMode() { return eSpatialIndexMode; }
+    bool                CollectStats() { return bStats; }
+    bool                UseFeatureCache() { return bFeatureCache; }
+    GUInt32             GetHeaderHash();
+
+    char**              GetMetadataDomainList();
+    char**              GetMetadata( const char *pszDomain = "" );
+    const char*         GetMetadataItem( const char *pszName,
+                                         const char *pszDomain = "" );
+
+    void                ScanSections();
+    bool                SectionsScanned() { return bSectionsScanned; }
+    void                SetSectionStatistics( const OGRVFPSection *psSection,
+                                              GIntBig nFeatureCount,
+                                              const OGREnvelope *psExtent );
+
+    OGRSpatialReference* GetSpatialRef();
+
+    VSILFILE*           GetFile() { return fpVFP; }
+    int                 ReadFile( vsi_l_offset nOffset, void *pBuffer, int nSize );
+    bool                MapFile( OGRVFPMappedRange *poRange,
+                                 vsi_l_offset nStart, vsi_l_offset nEnd );
+
 #ifdef HAVE_EXPAT
-    void                startElementValidateCbk(const char *pszName, const char **ppszAttr);
-    void                dataHandlerValidateCbk(const char *data, int nLen);
+    void                startElementScanCbk(const char *pszName, const char **ppszAttr);
+    void                endElementScanCbk(const char *pszName);
+    void                dataHandlerScanCbk(const char *data, int nLen);
+    void                xmlDeclScanCbk(const char *pszEncoding);
 #endif
 
+    static const char*  GetIndexFilename( const char *pszFilename );
+    static const char*  GetSpatialIndexFilename( const char *pszFilename,
+                                                 const char *pszLayerName );
+    static const char*  GetFeatureCacheFilename( const char *pszFilename,
+                                                 const char *pszLayerName );
+    static void         DeleteLayerFiles( const char *pszFilename );
+
 };
 
 #endif /* ndef _OGR_VFP_H_INCLUDED */
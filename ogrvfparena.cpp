@@ -0,0 +1,117 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  VFP Translator
+ * Purpose:  Implements OGRVFPArena class.
+ * Author:   Martin Landa, landa.martin gmail.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, Martin Landa <landa.martin gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ogr_vfp.h"
+#include "cpl_conv.h"
+
+CPL_CVSID("$Id$");
+
+/* size of the first block, enough for the attributes of most records */
+#define VFP_ARENA_MIN_BLOCK 4096
+
+/* allocations are aligned for doubles */
+#define VFP_ARENA_ALIGN(n) (((n) + 7) & ~((size_t)7))
+
+/************************************************************************/
+/*                            OGRVFPArena()                             */
+/************************************************************************/
+
+OGRVFPArena::OGRVFPArena()
+{
+    nLastBlockSize = 0;
+    nLastBlockUsed = 0;
+    nTotalSize = 0;
+    nBlockAllocs = 0;
+}
+
+/************************************************************************/
+/*                            ~OGRVFPArena()                            */
+/************************************************************************/
+
+OGRVFPArena::~OGRVFPArena()
+
+{
+    for( size_t i = 0; i < apabyBlocks.size(); i++ )
+        CPLFree(apabyBlocks[i]);
+}
+
+/************************************************************************/
+/*                               Alloc()                                */
+/************************************************************************/
+
+void *OGRVFPArena::Alloc( size_t nSize )
+{
+    nSize = VFP_ARENA_ALIGN(nSize);
+
+    if( nLastBlockUsed + nSize > nLastBlockSize )
+    {
+        size_t nNewSize = MAX(nSize, MAX(nTotalSize, VFP_ARENA_MIN_BLOCK));
+        apabyBlocks.push_back((GByte *) CPLMalloc(nNewSize));
+        nLastBlockSize = nNewSize;
+        nLastBlockUsed = 0;
+        nTotalSize += nNewSize;
+        nBlockAllocs++;
+    }
+
+    void *pRet = apabyBlocks.back() + nLastBlockUsed;
+    nLastBlockUsed += nSize;
+    return pRet;
+}
+
+/************************************************************************/
+/*                               Strdup()                               */
+/************************************************************************/
+
+char *OGRVFPArena::Strdup( const char *pszStr )
+{
+    const size_t nLen = strlen(pszStr) + 1;
+    return (char *) memcpy(Alloc(nLen), pszStr, nLen);
+}
+
+/************************************************************************/
+/*                               Reset()                                */
+/*                                                                      */
+/*      Release everything allocated since the last reset. Several      */
+/*      blocks are replaced by a single one of their total size.        */
+/************************************************************************/
+
+void OGRVFPArena::Reset()
+
+{
+    if( apabyBlocks.size() > 1 )
+    {
+        for( size_t i = 0; i < apabyBlocks.size(); i++ )
+            CPLFree(apabyBlocks[i]);
+        apabyBlocks.resize(1);
+        apabyBlocks[0] = (GByte *) CPLMalloc(nTotalSize);
+        nLastBlockSize = nTotalSize;
+        nBlockAllocs++;
+    }
+    nLastBlockUsed = 0;
+}
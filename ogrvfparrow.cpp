@@ -0,0 +1,687 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  VFP Translator
+ * Purpose:  Implements the Arrow stream of the VFP layers.
+ * Author:   Martin Landa, landa.martin gmail.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, Martin Landa <landa.martin gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ogr_vfp.h"
+#include "cpl_conv.h"
+#include "cpl_string.h"
+
+#include <errno.h>
+
+CPL_CVSID("$Id$");
+
+/* default number of records of a batch */
+#define VFP_ARROW_BATCH_SIZE 65536
+
+/* code lists of the parcels, few distinct values in a layer */
+#define VFP_ARROW_DICTIONARY_FIELDS "dpz,zvz,kk"
+
+/************************************************************************/
+/*                            Buffer helpers                            */
+/************************************************************************/
+
+static GByte *OGRVFPArrowReserve( OGRVFPArrowBuffer *psBuffer, size_t nBytes )
+{
+    if (psBuffer->nSize + nBytes > psBuffer->nAlloc)
+    {
+        psBuffer->nAlloc = MAX(psBuffer->nSize + nBytes, psBuffer->nAlloc * 2 + 256);
+        psBuffer->pabyData = (GByte *) CPLRealloc(psBuffer->pabyData, psBuffer->nAlloc);
+    }
+    GByte *pabyRet = psBuffer->pabyData + psBuffer->nSize;
+    psBuffer->nSize += nBytes;
+    return pabyRet;
+}
+
+static void OGRVFPArrowAppendInt32( OGRVFPArrowBuffer *psBuffer, GInt32 nValue )
+{
+    memcpy(OGRVFPArrowReserve(psBuffer, sizeof(nValue)), &nValue, sizeof(nValue));
+}
+
+static void OGRVFPArrowAppendInt64( OGRVFPArrowBuffer *psBuffer, GIntBig nValue )
+{
+    memcpy(OGRVFPArrowReserve(psBuffer, sizeof(nValue)), &nValue, sizeof(nValue));
+}
+
+static void OGRVFPArrowAppendDouble( OGRVFPArrowBuffer *psBuffer, double dfValue )
+{
+    memcpy(OGRVFPArrowReserve(psBuffer, sizeof(dfValue)), &dfValue, sizeof(dfValue));
+}
+
+/* bit iRow of a validity bitmap, whose rows are appended in order */
+static void OGRVFPArrowSetValid( OGRVFPArrowBuffer *psBuffer, int iRow, bool bValid )
+{
+    if ((size_t)(iRow / 8) >= psBuffer->nSize)
+        *OGRVFPArrowReserve(psBuffer, 1) = 0;
+    if (bValid)
+        psBuffer->pabyData[iRow / 8] |= (GByte)(1 << (iRow % 8));
+}
+
+/* the data is handed over to an array, the buffer starts empty */
+static void *OGRVFPArrowTakeBuffer( OGRVFPArrowBuffer *psBuffer )
+{
+    void *pData = psBuffer->pabyData;
+    psBuffer->pabyData = NULL;
+    psBuffer->nSize = 0;
+    psBuffer->nAlloc = 0;
+    return pData;
+}
+
+static void OGRVFPArrowFreeBuffer( OGRVFPArrowBuffer *psBuffer )
+{
+    CPLFree(OGRVFPArrowTakeBuffer(psBuffer));
+}
+
+/************************************************************************/
+/*                       OGRVFPArrowAppendValue()                       */
+/*                                                                      */
+/*      Convert a raw value to the type of its field and append it,     */
+/*      FALSE if it is null: no attribute, or an empty value of a       */
+/*      numeric field. A slot is appended anyway.                       */
+/************************************************************************/
+
+static bool OGRVFPArrowAppendValue( OGRFieldType eType,
+                                    OGRVFPArrowBuffer *psValues,
+                                    OGRVFPArrowBuffer *psOffsets,
+                                    const char *pszValue )
+{
+    const bool bValid = pszValue != NULL &&
+                        (pszValue[0] != '\0' || eType == OFTString);
+    switch (eType)
+    {
+        case OFTInteger:
+        {
+            GIntBig nValue = bValid ? CPLAtoGIntBig(pszValue) : 0;
+            if (nValue > INT_MAX)
+                nValue = INT_MAX;
+            else if (nValue < INT_MIN)
+                nValue = INT_MIN;
+            OGRVFPArrowAppendInt32(psValues, (GInt32) nValue);
+            break;
+        }
+        case OFTInteger64:
+            OGRVFPArrowAppendInt64(psValues, bValid ? CPLAtoGIntBig(pszValue) : 0);
+            break;
+        case OFTReal:
+            OGRVFPArrowAppendDouble(psValues, bValid ? OGRVFPStrtod(pszValue, NULL) : 0.0);
+            break;
+        default:
+        {
+            const size_t nLen = bValid ? strlen(pszValue) : 0;
+            if (nLen > 0)
+                memcpy(OGRVFPArrowReserve(psValues, nLen), pszValue, nLen);
+            OGRVFPArrowAppendInt32(psOffsets, (GInt32) psValues->nSize);
+            break;
+        }
+    }
+    return bValid;
+}
+
+/************************************************************************/
+/*                          OGRVFPArrowBatch()                          */
+/*                                                                      */
+/*      The ignored fields and geometry are left out of the columns.    */
+/************************************************************************/
+
+OGRVFPArrowBatch::OGRVFPArrowBatch( OGRFeatureDefn *poFeatureDefnIn,
+                                    bool bIncludeFIDIn,
+                                    char **papszDictionaryFields )
+{
+    poFeatureDefn = poFeatureDefnIn;
+    bIncludeFID = bIncludeFIDIn;
+    bIncludeGeometry = poFeatureDefn->GetGeomFieldCount() > 0 &&
+                       !poFeatureDefn->IsGeometryIgnored();
+
+    apszRecordValues.resize(poFeatureDefn->GetFieldCount(), NULL);
+    for (int i = 0; i < poFeatureDefn->GetFieldCount(); i++)
+    {
+        OGRFieldDefn *poFieldDefn = poFeatureDefn->GetFieldDefn(i);
+        if (poFieldDefn->IsIgnored())
+            continue;
+
+        OGRVFPArrowColumn *psColumn = new OGRVFPArrowColumn();
+        psColumn->iField = i;
+        psColumn->eType = poFieldDefn->GetType();
+        psColumn->bDictionary =
+            CSLFindString(papszDictionaryFields, poFieldDefn->GetNameRef()) >= 0;
+        memset(&psColumn->sValidity, 0, sizeof(OGRVFPArrowBuffer));
+        memset(&psColumn->sValues, 0, sizeof(OGRVFPArrowBuffer));
+        memset(&psColumn->sOffsets, 0, sizeof(OGRVFPArrowBuffer));
+        memset(&psColumn->sDictValues, 0, sizeof(OGRVFPArrowBuffer));
+        memset(&psColumn->sDictOffsets, 0, sizeof(OGRVFPArrowBuffer));
+        apoColumns.push_back(psColumn);
+    }
+
+    memset(&sFIDs, 0, sizeof(OGRVFPArrowBuffer));
+    memset(&sGeomValidity, 0, sizeof(OGRVFPArrowBuffer));
+    memset(&sGeomOffsets, 0, sizeof(OGRVFPArrowBuffer));
+    memset(&sGeomData, 0, sizeof(OGRVFPArrowBuffer));
+
+    Clear();
+}
+
+/************************************************************************/
+/*                         ~OGRVFPArrowBatch()                          */
+/************************************************************************/
+
+OGRVFPArrowBatch::~OGRVFPArrowBatch()
+
+{
+    Clear();
+    for (size_t i = 0; i < apoColumns.size(); i++)
+    {
+        OGRVFPArrowFreeBuffer(&apoColumns[i]->sOffsets);
+        OGRVFPArrowFreeBuffer(&apoColumns[i]->sDictOffsets);
+        delete apoColumns[i];
+    }
+    OGRVFPArrowFreeBuffer(&sGeomOffsets);
+}
+
+/************************************************************************/
+/*                               Clear()                                */
+/*                                                                      */
+/*      Empty the batch. The offsets of the strings start with 0.       */
+/************************************************************************/
+
+void OGRVFPArrowBatch::Clear()
+
+{
+    for (size_t i = 0; i < apoColumns.size(); i++)
+    {
+        OGRVFPArrowColumn *psColumn = apoColumns[i];
+        OGRVFPArrowFreeBuffer(&psColumn->sValidity);
+        OGRVFPArrowFreeBuffer(&psColumn->sValues);
+        OGRVFPArrowFreeBuffer(&psColumn->sDictValues);
+        psColumn->sOffsets.nSize = 0;
+        psColumn->sDictOffsets.nSize = 0;
+        OGRVFPArrowAppendInt32(&psColumn->sOffsets, 0);
+        OGRVFPArrowAppendInt32(&psColumn->sDictOffsets, 0);
+        psColumn->nNulls = 0;
+        psColumn->oDictionary.clear();
+    }
+
+    OGRVFPArrowFreeBuffer(&sFIDs);
+    OGRVFPArrowFreeBuffer(&sGeomValidity);
+    OGRVFPArrowFreeBuffer(&sGeomData);
+    sGeomOffsets.nSize = 0;
+    OGRVFPArrowAppendInt32(&sGeomOffsets, 0);
+    nGeomNulls = 0;
+
+    nLength = 0;
+}
+
+/************************************************************************/
+/*                             AddRecord()                              */
+/*                                                                      */
+/*      Append a record from the raw values of its attributes. The      */
+/*      geometry, if any, is only written as WKB and not kept.          */
+/************************************************************************/
+
+void OGRVFPArrowBatch::AddRecord( GIntBig nFID, const OGRVFPAttribute *pasAttrs,
+                                  int nAttrs, OGRGeometry *poGeom )
+{
+    for (int i = 0; i < nAttrs; i++)
+        apszRecordValues[pasAttrs[i].iField] = pasAttrs[i].pszValue;
+
+    if (bIncludeFID)
+        OGRVFPArrowAppendInt64(&sFIDs, nFID);
+
+    for (size_t i = 0; i < apoColumns.size(); i++)
+    {
+        OGRVFPArrowColumn *psColumn = apoColumns[i];
+        const char *pszValue = apszRecordValues[psColumn->iField];
+        bool bValid;
+        if (psColumn->bDictionary)
+        {
+            /* a value is converted once per batch */
+            int iIndex = 0;
+            bValid = pszValue != NULL &&
+                     (pszValue[0] != '\0' || psColumn->eType == OFTString);
+            if (bValid)
+            {
+                std::map<CPLString, int>::iterator oIter =
+                    psColumn->oDictionary.find(pszValue);
+                if (oIter != psColumn->oDictionary.end())
+                    iIndex = oIter->second;
+                else
+                {
+                    iIndex = (int) psColumn->oDictionary.size();
+                    OGRVFPArrowAppendValue(psColumn->eType, &psColumn->sDictValues,
+                                           &psColumn->sDictOffsets, pszValue);
+                    psColumn->oDictionary[pszValue] = iIndex;
+                }
+            }
+            OGRVFPArrowAppendInt32(&psColumn->sValues, iIndex);
+        }
+        else
+            bValid = OGRVFPArrowAppendValue(psColumn->eType, &psColumn->sValues,
+                                            &psColumn->sOffsets, pszValue);
+        OGRVFPArrowSetValid(&psColumn->sValidity, nLength, bValid);
+        if (!bValid)
+            psColumn->nNulls++;
+    }
+
+    for (int i = 0; i < nAttrs; i++)
+        apszRecordValues[pasAttrs[i].iField] = NULL;
+
+    if (bIncludeGeometry)
+    {
+        if (poGeom != NULL)
+        {
+            const int nWkbSize = poGeom->WkbSize();
+            poGeom->exportToWkb(wkbNDR, OGRVFPArrowReserve(&sGeomData, nWkbSize),
+                                wkbVariantIso);
+        }
+        else
+            nGeomNulls++;
+        OGRVFPArrowAppendInt32(&sGeomOffsets, (GInt32) sGeomData.nSize);
+        OGRVFPArrowSetValid(&sGeomValidity, nLength, poGeom != NULL);
+    }
+
+    nLength++;
+}
+
+/************************************************************************/
+/*                          Schema and arrays                           */
+/*                                                                      */
+/*      Everything below an exported schema or array is allocated       */
+/*      with CPLMalloc() and freed by its release callback.             */
+/************************************************************************/
+
+static void OGRVFPArrowReleaseSchema( struct ArrowSchema *psSchema )
+{
+    for (int64_t i = 0; i < psSchema->n_children; i++)
+    {
+        if (psSchema->children[i]->release != NULL)
+            psSchema->children[i]->release(psSchema->children[i]);
+        CPLFree(psSchema->children[i]);
+    }
+    CPLFree(psSchema->children);
+    if (psSchema->dictionary != NULL)
+    {
+        if (psSchema->dictionary->release != NULL)
+            psSchema->dictionary->release(psSchema->dictionary);
+        CPLFree(psSchema->dictionary);
+    }
+    CPLFree((char *) psSchema->format);
+    CPLFree((char *) psSchema->name);
+    CPLFree((char *) psSchema->metadata);
+    psSchema->release = NULL;
+}
+
+static void OGRVFPArrowInitSchema( struct ArrowSchema *psSchema,
+                                   const char *pszFormat, const char *pszName,
+                                   int64_t nFlags )
+{
+    memset(psSchema, 0, sizeof(*psSchema));
+    psSchema->format = CPLStrdup(pszFormat);
+    psSchema->name = pszName ? CPLStrdup(pszName) : NULL;
+    psSchema->flags = nFlags;
+    psSchema->release = OGRVFPArrowReleaseSchema;
+}
+
+static struct ArrowSchema *OGRVFPArrowNewSchema( const char *pszFormat,
+                                                 const char *pszName,
+                                                 int64_t nFlags )
+{
+    struct ArrowSchema *psSchema =
+        (struct ArrowSchema *) CPLMalloc(sizeof(struct ArrowSchema));
+    OGRVFPArrowInitSchema(psSchema, pszFormat, pszName, nFlags);
+    return psSchema;
+}
+
+static const char *OGRVFPArrowFormat( OGRFieldType eType )
+{
+    switch (eType)
+    {
+        case OFTInteger:   return "i";
+        case OFTInteger64: return "l";
+        case OFTReal:      return "g";
+        default:           return "u";
+    }
+}
+
+/* metadata of a single key and value, in the binary layout of the
+   C data interface: the number of pairs then each length and string */
+static char *OGRVFPArrowMetadata( const char *pszKey, const char *pszValue )
+{
+    const GInt32 nCount = 1;
+    const GInt32 nKeyLen = (GInt32) strlen(pszKey);
+    const GInt32 nValueLen = (GInt32) strlen(pszValue);
+    char *pszMetadata = (char *) CPLMalloc(3 * sizeof(GInt32) + nKeyLen + nValueLen);
+    char *pszIter = pszMetadata;
+    memcpy(pszIter, &nCount, sizeof(GInt32));
+    pszIter += sizeof(GInt32);
+    memcpy(pszIter, &nKeyLen, sizeof(GInt32));
+    pszIter += sizeof(GInt32);
+    memcpy(pszIter, pszKey, nKeyLen);
+    pszIter += nKeyLen;
+    memcpy(pszIter, &nValueLen, sizeof(GInt32));
+    pszIter += sizeof(GInt32);
+    memcpy(pszIter, pszValue, nValueLen);
+    return pszMetadata;
+}
+
+static void OGRVFPArrowReleaseArray( struct ArrowArray *psArray )
+{
+    for (int64_t i = 0; i < psArray->n_buffers; i++)
+        CPLFree((void *) psArray->buffers[i]);
+    CPLFree(psArray->buffers);
+    for (int64_t i = 0; i < psArray->n_children; i++)
+    {
+        if (psArray->children[i]->release != NULL)
+            psArray->children[i]->release(psArray->children[i]);
+        CPLFree(psArray->children[i]);
+    }
+    CPLFree(psArray->children);
+    if (psArray->dictionary != NULL)
+    {
+        if (psArray->dictionary->release != NULL)
+            psArray->dictionary->release(psArray->dictionary);
+        CPLFree(psArray->dictionary);
+    }
+    psArray->release = NULL;
+}
+
+/* the validity bitmap is left out if there are no nulls */
+static struct ArrowArray *OGRVFPArrowNewArray( int64_t nLength, int64_t nNulls,
+                                               OGRVFPArrowBuffer *psValidity,
+                                               OGRVFPArrowBuffer *psBuffer1,
+                                               OGRVFPArrowBuffer *psBuffer2 )
+{
+    struct ArrowArray *psArray =
+        (struct ArrowArray *) CPLCalloc(1, sizeof(struct ArrowArray));
+    psArray->length = nLength;
+    psArray->null_count = nNulls;
+    psArray->n_buffers = psBuffer2 != NULL ? 3 : psBuffer1 != NULL ? 2 : 1;
+    psArray->buffers = (const void **) CPLCalloc((size_t) psArray->n_buffers,
+                                                 sizeof(void *));
+    if (nNulls > 0 && psValidity != NULL)
+        psArray->buffers[0] = OGRVFPArrowTakeBuffer(psValidity);
+    else if (psValidity != NULL)
+        OGRVFPArrowFreeBuffer(psValidity);
+    if (psBuffer1 != NULL)
+        psArray->buffers[1] = OGRVFPArrowTakeBuffer(psBuffer1);
+    if (psBuffer2 != NULL)
+        psArray->buffers[2] = OGRVFPArrowTakeBuffer(psBuffer2);
+    psArray->release = OGRVFPArrowReleaseArray;
+    return psArray;
+}
+
+/************************************************************************/
+/*                             GetSchema()                              */
+/*                                                                      */
+/*      Struct of the FID, the fields and the geometry, named as by     */
+/*      ogr2ogr. The geometry is tagged with the ogc.wkb extension.     */
+/************************************************************************/
+
+void OGRVFPArrowBatch::GetSchema( struct ArrowSchema *psSchema ) const
+{
+    OGRVFPArrowInitSchema(psSchema, "+s", "", 0);
+
+    std::vector<struct ArrowSchema *> apsChildren;
+    if (bIncludeFID)
+        apsChildren.push_back(OGRVFPArrowNewSchema("l", "OGC_FID", 0));
+
+    for (size_t i = 0; i < apoColumns.size(); i++)
+    {
+        const OGRVFPArrowColumn *psColumn = apoColumns[i];
+        const char *pszName =
+            poFeatureDefn->GetFieldDefn(psColumn->iField)->GetNameRef();
+        const char *pszFormat = OGRVFPArrowFormat(psColumn->eType);
+        struct ArrowSchema *psChild;
+        if (psColumn->bDictionary)
+        {
+            psChild = OGRVFPArrowNewSchema("i", pszName, ARROW_FLAG_NULLABLE);
+            psChild->dictionary = OGRVFPArrowNewSchema(pszFormat, NULL, 0);
+        }
+        else
+            psChild = OGRVFPArrowNewSchema(pszFormat, pszName, ARROW_FLAG_NULLABLE);
+        apsChildren.push_back(psChild);
+    }
+
+    if (bIncludeGeometry)
+    {
+        const char *pszName = poFeatureDefn->GetGeomFieldDefn(0)->GetNameRef();
+        struct ArrowSchema *psChild =
+            OGRVFPArrowNewSchema("z", pszName[0] ? pszName : "wkb_geometry",
+                                 ARROW_FLAG_NULLABLE);
+        psChild->metadata = OGRVFPArrowMetadata("ARROW:extension:name", "ogc.wkb");
+        apsChildren.push_back(psChild);
+    }
+
+    psSchema->n_children = (int64_t) apsChildren.size();
+    psSchema->children = (struct ArrowSchema **)
+        CPLMalloc(MAX(1, apsChildren.size()) * sizeof(struct ArrowSchema *));
+    for (size_t i = 0; i < apsChildren.size(); i++)
+        psSchema->children[i] = apsChildren[i];
+}
+
+/************************************************************************/
+/*                               Export()                               */
+/************************************************************************/
+
+void OGRVFPArrowBatch::Export( struct ArrowArray *psArray )
+{
+    std::vector<struct ArrowArray *> apsChildren;
+    if (bIncludeFID)
+        apsChildren.push_back(OGRVFPArrowNewArray(nLength, 0, NULL, &sFIDs, NULL));
+
+    for (size_t i = 0; i < apoColumns.size(); i++)
+    {
+        OGRVFPArrowColumn *psColumn = apoColumns[i];
+        const bool bString = EQUAL(OGRVFPArrowFormat(psColumn->eType), "u");
+        struct ArrowArray *psChild;
+        if (psColumn->bDictionary)
+        {
+            psChild = OGRVFPArrowNewArray(nLength, psColumn->nNulls,
+                                          &psColumn->sValidity,
+                                          &psColumn->sValues, NULL);
+            psChild->dictionary =
+                OGRVFPArrowNewArray((int64_t) psColumn->oDictionary.size(), 0, NULL,
+                                    bString ? &psColumn->sDictOffsets :
+                                              &psColumn->sDictValues,
+                                    bString ? &psColumn->sDictValues : NULL);
+        }
+        else
+            psChild = OGRVFPArrowNewArray(nLength, psColumn->nNulls,
+                                          &psColumn->sValidity,
+                                          bString ? &psColumn->sOffsets :
+                                                    &psColumn->sValues,
+                                          bString ? &psColumn->sValues : NULL);
+        apsChildren.push_back(psChild);
+    }
+
+    if (bIncludeGeometry)
+        apsChildren.push_back(OGRVFPArrowNewArray(nLength, nGeomNulls,
+                                                  &sGeomValidity,
+                                                  &sGeomOffsets, &sGeomData));
+
+    memset(psArray, 0, sizeof(*psArray));
+    psArray->length = nLength;
+    psArray->n_buffers = 1;
+    psArray->buffers = (const void **) CPLCalloc(1, sizeof(void *));
+    psArray->n_children = (int64_t) apsChildren.size();
+    psArray->children = (struct ArrowArray **)
+        CPLMalloc(MAX(1, apsChildren.size()) * sizeof(struct ArrowArray *));
+    for (size_t i = 0; i < apsChildren.size(); i++)
+        psArray->children[i] = apsChildren[i];
+    psArray->release = OGRVFPArrowReleaseArray;
+
+    Clear();
+}
+
+/************************************************************************/
+/*                          OGRVFPArrowStream                           */
+/*                                                                      */
+/*      Private data of a stream: its own reader of the layer element,  */
+/*      so that the stream and GetNextFeature() do not interfere.       */
+/************************************************************************/
+
+typedef struct
+{
+    OGRVFPReader*      poReader;
+    OGRVFPArrowBatch*  poBatch;
+    int                nBatchSize;
+    CPLString          osLastError;
+} OGRVFPArrowStream;
+
+static int OGRVFPArrowGetSchema( struct ArrowArrayStream *psStream,
+                                 struct ArrowSchema *psSchema )
+{
+    OGRVFPArrowStream *psPrivate = (OGRVFPArrowStream *) psStream->private_data;
+    psPrivate->poBatch->GetSchema(psSchema);
+    return 0;
+}
+
+/* a batch with no record ends the stream */
+static int OGRVFPArrowGetNext( struct ArrowArrayStream *psStream,
+                               struct ArrowArray *psArray )
+{
+    OGRVFPArrowStream *psPrivate = (OGRVFPArrowStream *) psStream->private_data;
+    OGRVFPReader *poReader = psPrivate->poReader;
+    OGRVFPArrowBatch *poBatch = psPrivate->poBatch;
+
+    memset(psArray, 0, sizeof(*psArray));
+    while (poBatch->GetLength() < psPrivate->nBatchSize && !poReader->IsFinished())
+        poReader->ParseNextChunk();
+
+    if (poReader->HasFailed())
+    {
+        psPrivate->osLastError = CPLGetLastErrorMsg();
+        return EIO;
+    }
+    if (poBatch->GetLength() > 0)
+        poBatch->Export(psArray);
+
+    return 0;
+}
+
+static const char *OGRVFPArrowGetLastError( struct ArrowArrayStream *psStream )
+{
+    OGRVFPArrowStream *psPrivate = (OGRVFPArrowStream *) psStream->private_data;
+    return psPrivate->osLastError.empty() ? NULL : psPrivate->osLastError.c_str();
+}
+
+static void OGRVFPArrowReleaseStream( struct ArrowArrayStream *psStream )
+{
+    OGRVFPArrowStream *psPrivate = (OGRVFPArrowStream *) psStream->private_data;
+    delete psPrivate->poReader;
+    delete psPrivate->poBatch;
+    delete psPrivate;
+    psStream->private_data = NULL;
+    psStream->release = NULL;
+}
+
+/************************************************************************/
+/*                           GetArrowStream()                           */
+/*                                                                      */
+/*      Stream the features as Arrow record batches, appending the      */
+/*      raw attribute values of each record to the columns of a         */
+/*      batch instead of building an OGRFeature. The filters and the    */
+/*      ignored fields in effect are those of the time of the call.     */
+/*      The stream must be released before the layer is destroyed.      */
+/*                                                                      */
+/*      Options:                                                        */
+/*       - MAX_FEATURES_IN_BATCH=n, 65536 by default.                   */
+/*       - INCLUDE_FID=YES/NO, YES by default.                          */
+/*       - DICTIONARY_FIELDS=a,b,...: dictionary encoded fields,        */
+/*         dpz,zvz,kk by default.                                       */
+/************************************************************************/
+
+int OGRVFPLayer::GetArrowStream( struct ArrowArrayStream *psStream,
+                                 char **papszOptions )
+
+{
+    memset(psStream, 0, sizeof(*psStream));
+
+    int nBatchSize = atoi(CSLFetchNameValueDef(papszOptions, "MAX_FEATURES_IN_BATCH",
+                                               CPLSPrintf("%d", VFP_ARROW_BATCH_SIZE)));
+    if (nBatchSize <= 0)
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg,
+                 "Invalid value for MAX_FEATURES_IN_BATCH");
+        return FALSE;
+    }
+
+    poDS->ScanSections();
+
+    char **papszDictionaryFields =
+        CSLTokenizeString2(CSLFetchNameValueDef(papszOptions, "DICTIONARY_FIELDS",
+                                                VFP_ARROW_DICTIONARY_FIELDS),
+                           ",", CSLT_STRIPLEADSPACES | CSLT_STRIPENDSPACES);
+    OGRVFPArrowStream *psPrivate = new OGRVFPArrowStream();
+    psPrivate->poBatch = new OGRVFPArrowBatch(
+        poFeatureDefn,
+        CSLFetchBoolean(papszOptions, "INCLUDE_FID", TRUE) != FALSE,
+        papszDictionaryFields);
+    CSLDestroy(papszDictionaryFields);
+    psPrivate->nBatchSize = nBatchSize;
+
+    psPrivate->poReader = new OGRVFPReader(this, 0);
+    psPrivate->poReader->SetArrowBatch(psPrivate->poBatch, nBatchSize);
+    if (!psPrivate->poReader->Start(poDS->GetFile(), FALSE, psSection->nStart,
+                                    psSection->nEnd, 0) &&
+        psPrivate->poReader->HasFailed())
+    {
+        delete psPrivate->poReader;
+        delete psPrivate->poBatch;
+        delete psPrivate;
+        return FALSE;
+    }
+
+    psStream->get_schema = OGRVFPArrowGetSchema;
+    psStream->get_next = OGRVFPArrowGetNext;
+    psStream->get_last_error = OGRVFPArrowGetLastError;
+    psStream->release = OGRVFPArrowReleaseStream;
+    psStream->private_data = psPrivate;
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                      OGR_VFP_L_GetArrowStream()                      */
+/************************************************************************/
+
+int OGR_VFP_L_GetArrowStream( OGRLayerH hLayer,
+                              struct ArrowArrayStream *psStream,
+                              char **papszOptions )
+
+{
+    VALIDATE_POINTER1( hLayer, "OGR_VFP_L_GetArrowStream", FALSE );
+    VALIDATE_POINTER1( psStream, "OGR_VFP_L_GetArrowStream", FALSE );
+
+    OGRVFPLayer *poLayer = dynamic_cast<OGRVFPLayer *>((OGRLayer *) hLayer);
+    if (poLayer == NULL)
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "%s is not a VFP layer", ((OGRLayer *) hLayer)->GetName());
+        return FALSE;
+    }
+
+    return poLayer->GetArrowStream(psStream, papszOptions);
+}
@@ -0,0 +1,610 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  VFP Translator
+ * Purpose:  Implements OGRVFPFeatureCache and OGRVFPFeatureCacheWriter.
+ * Author:   Martin Landa, landa.martin gmail.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, Martin Landa <landa.martin gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ogr_vfp.h"
+#include "cpl_conv.h"
+#include "cpl_string.h"
+
+CPL_CVSID("$Id$");
+
+/*
+ * Layout of a .vfpc file, all numbers are little endian:
+ *
+ *   header      "VFPCACHE", version, number of fields, size and
+ *               modification time of the VFP file, hash of its first
+ *               bytes, hash of the field names and types, start offset
+ *               of the layer element, number of records, offset of
+ *               the record table, and the LINEARIZE and MAX_ANGLE_STEP
+ *               options the geometries were built with
+ *   records     for each FID: the WKB size of the geometry (4 bytes,
+ *               0 without geometry), then its envelope and ISO WKB; a
+ *               bitmap of the fields that are set, then their values:
+ *               4 bytes for integers, 8 for 64 bit integers and reals,
+ *               the length (4 bytes) and bytes of the others
+ *   table       offset of each record, and of the end of the last one
+ */
+
+#define VFPC_MAGIC          "VFPCACHE"
+#define VFPC_VERSION        2
+#define VFPC_HEADER_SIZE    80
+
+/************************************************************************/
+/*                             OGRVFPHash()                             */
+/*                                                                      */
+/*      FNV-1a hash, chained through nHash.                             */
+/************************************************************************/
+
+GUInt32 OGRVFPHash( const void *pData, size_t nSize, GUInt32 nHash )
+{
+    const GByte *pabyData = (const GByte *) pData;
+    for( size_t i = 0; i < nSize; i++ )
+    {
+        nHash ^= pabyData[i];
+        nHash *= 16777619U;
+    }
+    return nHash;
+}
+
+/* field names and types, so that a cache of another schema is ignored */
+static GUInt32 GetSchemaHash( OGRFeatureDefn *poFeatureDefn )
+{
+    GUInt32 nHash = OGRVFPHash(NULL, 0);
+    for( int i = 0; i < poFeatureDefn->GetFieldCount(); i++ )
+    {
+        OGRFieldDefn *poFieldDefn = poFeatureDefn->GetFieldDefn(i);
+        const char *pszName = poFieldDefn->GetNameRef();
+        const GByte byType = (GByte) poFieldDefn->GetType();
+        nHash = OGRVFPHash(pszName, strlen(pszName) + 1, nHash);
+        nHash = OGRVFPHash(&byType, 1, nHash);
+    }
+    return nHash;
+}
+
+/************************************************************************/
+/*                         Read and write helpers                       */
+/************************************************************************/
+
+static void AppendUInt32( std::vector<GByte> &abyData, GUInt32 nValue )
+{
+    CPL_LSBPTR32(&nValue);
+    const GByte *pabyValue = (const GByte *) &nValue;
+    abyData.insert(abyData.end(), pabyValue, pabyValue + 4);
+}
+
+static void AppendUInt64( std::vector<GByte> &abyData, GUIntBig nValue )
+{
+    CPL_LSBPTR64(&nValue);
+    const GByte *pabyValue = (const GByte *) &nValue;
+    abyData.insert(abyData.end(), pabyValue, pabyValue + 8);
+}
+
+static void AppendDouble( std::vector<GByte> &abyData, double dfValue )
+{
+    CPL_LSBPTR64(&dfValue);
+    const GByte *pabyValue = (const GByte *) &dfValue;
+    abyData.insert(abyData.end(), pabyValue, pabyValue + 8);
+}
+
+static GUInt32 GetUInt32( const GByte *pabyData )
+{
+    GUInt32 nValue;
+    memcpy(&nValue, pabyData, 4);
+    CPL_LSBPTR32(&nValue);
+    return nValue;
+}
+
+static GUIntBig GetUInt64( const GByte *pabyData )
+{
+    GUIntBig nValue;
+    memcpy(&nValue, pabyData, 8);
+    CPL_LSBPTR64(&nValue);
+    return nValue;
+}
+
+static double GetDouble( const GByte *pabyData )
+{
+    double dfValue;
+    memcpy(&dfValue, pabyData, 8);
+    CPL_LSBPTR64(&dfValue);
+    return dfValue;
+}
+
+/************************************************************************/
+/*                         OGRVFPFeatureCache()                         */
+/************************************************************************/
+
+OGRVFPFeatureCache::OGRVFPFeatureCache()
+{
+    fp = NULL;
+    nFields = 0;
+}
+
+/************************************************************************/
+/*                        ~OGRVFPFeatureCache()                         */
+/************************************************************************/
+
+OGRVFPFeatureCache::~OGRVFPFeatureCache()
+{
+    oMappedRange.Unmap();
+    if( fp != NULL )
+        VSIFCloseL(fp);
+}
+
+/************************************************************************/
+/*                               Open()                                 */
+/*                                                                      */
+/*      Open the cache of a layer. NULL is returned if the file does    */
+/*      not exist, is corrupted or does not match the data file, the    */
+/*      schema or the geometry options; the layer is then read from     */
+/*      the XML.                                                        */
+/************************************************************************/
+
+OGRVFPFeatureCache *OGRVFPFeatureCache::Open( const char *pszFilename,
+                                              const char *pszDataFilename,
+                                              GUInt32 nHeaderHash,
+                                              vsi_l_offset nSectionStart,
+                                              OGRFeatureDefn *poFeatureDefn,
+                                              bool bLinearize,
+                                              double dfMaxAngleStep,
+                                              bool bUseMmap )
+{
+    VSIStatBufL sStat, sCacheStat;
+    if( VSIStatL(pszDataFilename, &sStat) != 0 ||
+        VSIStatL(pszFilename, &sCacheStat) != 0 )
+        return NULL;
+
+    VSILFILE *fp = VSIFOpenL(pszFilename, "rb");
+    if( fp == NULL )
+        return NULL;
+
+    GByte abyHeader[VFPC_HEADER_SIZE];
+    if( VSIFReadL(abyHeader, 1, sizeof(abyHeader), fp) != sizeof(abyHeader) ||
+        memcmp(abyHeader, VFPC_MAGIC, 8) != 0 ||
+        GetUInt32(abyHeader + 8) != VFPC_VERSION )
+    {
+        CPLDebug("VFP", "%s is not a valid feature cache, ignored", pszFilename);
+        VSIFCloseL(fp);
+        return NULL;
+    }
+
+    if( GetUInt32(abyHeader + 12) != (GUInt32)poFeatureDefn->GetFieldCount() ||
+        GetUInt64(abyHeader + 16) != (GUIntBig)sStat.st_size ||
+        GetUInt64(abyHeader + 24) != (GUIntBig)sStat.st_mtime ||
+        GetUInt32(abyHeader + 32) != nHeaderHash ||
+        GetUInt32(abyHeader + 36) != GetSchemaHash(poFeatureDefn) ||
+        GetUInt64(abyHeader + 40) != (GUIntBig)nSectionStart ||
+        GetUInt32(abyHeader + 64) != (GUInt32)(bLinearize ? 1 : 0) ||
+        GetDouble(abyHeader + 72) != (bLinearize ? dfMaxAngleStep : 0.0) )
+    {
+        CPLDebug("VFP", "%s is out of date, ignored", pszFilename);
+        VSIFCloseL(fp);
+        return NULL;
+    }
+
+    const GUIntBig nFeatures = GetUInt64(abyHeader + 48);
+    const GUIntBig nTableOffset = GetUInt64(abyHeader + 56);
+
+    /* the table must fill the end of the file */
+    OGRVFPFeatureCache *poCache = new OGRVFPFeatureCache();
+    poCache->fp = fp;
+    poCache->nFields = poFeatureDefn->GetFieldCount();
+    bool bOK = nTableOffset >= VFPC_HEADER_SIZE &&
+               (GUIntBig)sCacheStat.st_size == nTableOffset + (nFeatures + 1) * 8 &&
+               VSIFSeekL(fp, nTableOffset, SEEK_SET) == 0;
+    if( bOK )
+    {
+        std::vector<GByte> abyTable((size_t)(nFeatures + 1) * 8);
+        bOK = VSIFReadL(&abyTable[0], 8, (size_t)nFeatures + 1, fp) ==
+              (size_t)nFeatures + 1;
+        poCache->anOffsets.resize(bOK ? (size_t)nFeatures + 1 : 0);
+        for( size_t i = 0; bOK && i < poCache->anOffsets.size(); i++ )
+        {
+            poCache->anOffsets[i] = GetUInt64(&abyTable[i * 8]);
+            bOK = i == 0 ? poCache->anOffsets[0] == VFPC_HEADER_SIZE :
+                           poCache->anOffsets[i] >= poCache->anOffsets[i - 1];
+        }
+        bOK = bOK && poCache->anOffsets.back() == nTableOffset;
+    }
+
+    if( !bOK )
+    {
+        CPLDebug("VFP", "%s is corrupted, ignored", pszFilename);
+        delete poCache;
+        return NULL;
+    }
+
+    if( bUseMmap && nTableOffset > VFPC_HEADER_SIZE )
+        poCache->oMappedRange.Map(fp, 0, nTableOffset);
+
+    CPLDebug("VFP", "Using %s%s", pszFilename,
+             poCache->oMappedRange.IsMapped() ? ", mapped" : "");
+
+    return poCache;
+}
+
+/************************************************************************/
+/*                             GetRecord()                              */
+/*                                                                      */
+/*      Bytes of the record of nFID, in the mapping or read into        */
+/*      abyRecord.                                                      */
+/************************************************************************/
+
+const GByte *OGRVFPFeatureCache::GetRecord( GIntBig nFID, size_t *pnSize )
+{
+    const vsi_l_offset nOffset = anOffsets[(size_t)nFID];
+    *pnSize = (size_t)(anOffsets[(size_t)nFID + 1] - nOffset);
+
+    if( oMappedRange.IsMapped() )
+        return (const GByte *) oMappedRange.GetData(nOffset);
+
+    abyRecord.resize(*pnSize + 1);
+    if( VSIFSeekL(fp, nOffset, SEEK_SET) != 0 ||
+        VSIFReadL(&abyRecord[0], 1, *pnSize, fp) != *pnSize )
+        return NULL;
+    return &abyRecord[0];
+}
+
+/************************************************************************/
+/*                             GetFeature()                             */
+/*                                                                      */
+/*      The envelope of the record is tested against psFilter before    */
+/*      anything is built, as the reader does with the coordinates.     */
+/*      Ignored fields are skipped, and the geometry too when it is     */
+/*      ignored and there is no filter.                                 */
+/************************************************************************/
+
+OGRFeature *OGRVFPFeatureCache::GetFeature( GIntBig nFID,
+                                            OGRFeatureDefn *poFeatureDefn,
+                                            OGRSpatialReference *poSRS,
+                                            const OGREnvelope *psFilter,
+                                            bool *pbSkipped, bool *pbError )
+{
+    *pbSkipped = FALSE;
+    *pbError = FALSE;
+    if( nFID < 0 || nFID >= GetFeatureCount() )
+        return NULL;
+
+    size_t nSize = 0;
+    const GByte *pabyRecord = GetRecord(nFID, &nSize);
+    if( pabyRecord == NULL || nSize < 4 )
+    {
+        *pbError = TRUE;
+        return NULL;
+    }
+    const GByte *pabyEnd = pabyRecord + nSize;
+
+    const GUInt32 nWkbSize = GetUInt32(pabyRecord);
+    pabyRecord += 4;
+    if( nWkbSize > 0 && (size_t)(pabyEnd - pabyRecord) < 32 + (size_t)nWkbSize )
+    {
+        *pbError = TRUE;
+        return NULL;
+    }
+    if( psFilter != NULL &&
+        (nWkbSize == 0 ||
+         GetDouble(pabyRecord) > psFilter->MaxX ||
+         GetDouble(pabyRecord + 8) > psFilter->MaxY ||
+         GetDouble(pabyRecord + 16) < psFilter->MinX ||
+         GetDouble(pabyRecord + 24) < psFilter->MinY) )
+    {
+        *pbSkipped = TRUE;
+        return NULL;
+    }
+
+    OGRGeometry *poGeom = NULL;
+    if( nWkbSize > 0 )
+    {
+        if( psFilter != NULL || !poFeatureDefn->IsGeometryIgnored() )
+        {
+            if( OGRGeometryFactory::createFromWkb((unsigned char *) pabyRecord + 32,
+                                                  poSRS, &poGeom, nWkbSize,
+                                                  wkbVariantIso) != OGRERR_NONE )
+            {
+                *pbError = TRUE;
+                return NULL;
+            }
+        }
+        pabyRecord += 32 + nWkbSize;
+    }
+
+    OGRFeature *poFeature = new OGRFeature(poFeatureDefn);
+    poFeature->SetFID(nFID);
+    if( poGeom != NULL )
+        poFeature->SetGeometryDirectly(poGeom);
+
+    bool bCorrupted = pabyEnd - pabyRecord < (nFields + 7) / 8;
+    const GByte *pabySet = pabyRecord;
+    pabyRecord += (nFields + 7) / 8;
+    for( int i = 0; i < nFields && !bCorrupted; i++ )
+    {
+        if( !(pabySet[i / 8] & (1 << (i % 8))) )
+            continue;
+
+        OGRFieldDefn *poFieldDefn = poFeatureDefn->GetFieldDefn(i);
+        const bool bIgnored = poFieldDefn->IsIgnored() != FALSE;
+        switch( poFieldDefn->GetType() )
+        {
+            case OFTInteger:
+                if( pabyEnd - pabyRecord < 4 )
+                    break;
+                if( !bIgnored )
+                    poFeature->SetField(i, (int)GetUInt32(pabyRecord));
+                pabyRecord += 4;
+                continue;
+
+            case OFTInteger64:
+                if( pabyEnd - pabyRecord < 8 )
+                    break;
+                if( !bIgnored )
+                    poFeature->SetField(i, (GIntBig)GetUInt64(pabyRecord));
+                pabyRecord += 8;
+                continue;
+
+            case OFTReal:
+                if( pabyEnd - pabyRecord < 8 )
+                    break;
+                if( !bIgnored )
+                    poFeature->SetField(i, GetDouble(pabyRecord));
+                pabyRecord += 8;
+                continue;
+
+            default:
+            {
+                if( pabyEnd - pabyRecord < 4 )
+                    break;
+                const GUInt32 nLen = GetUInt32(pabyRecord);
+                pabyRecord += 4;
+                if( (size_t)(pabyEnd - pabyRecord) < nLen )
+                    break;
+                if( !bIgnored )
+                {
+                    CPLString osValue((const char *) pabyRecord, nLen);
+                    poFeature->SetField(i, osValue.c_str());
+                }
+                pabyRecord += nLen;
+                continue;
+            }
+        }
+
+        /* a value past the end of the record */
+        bCorrupted = TRUE;
+    }
+
+    if( bCorrupted || pabyRecord != pabyEnd )
+    {
+        delete poFeature;
+        *pbError = TRUE;
+        return NULL;
+    }
+
+    return poFeature;
+}
+
+/************************************************************************/
+/*                      OGRVFPFeatureCacheWriter()                      */
+/************************************************************************/
+
+OGRVFPFeatureCacheWriter::OGRVFPFeatureCacheWriter()
+{
+    fp = NULL;
+    nOffset = 0;
+    bError = FALSE;
+}
+
+/************************************************************************/
+/*                     ~OGRVFPFeatureCacheWriter()                      */
+/************************************************************************/
+
+OGRVFPFeatureCacheWriter::~OGRVFPFeatureCacheWriter()
+{
+    Abort();
+}
+
+/************************************************************************/
+/*                               Create()                               */
+/*                                                                      */
+/*      The header is left blank until Finish().                        */
+/************************************************************************/
+
+bool OGRVFPFeatureCacheWriter::Create( const char *pszFilename )
+{
+    /* the directory may be read-only, the caller handles the failure */
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    fp = VSIFOpenL(pszFilename, "wb");
+    CPLPopErrorHandler();
+    if( fp == NULL )
+        return FALSE;
+
+    osFilename = pszFilename;
+    GByte abyHeader[VFPC_HEADER_SIZE];
+    memset(abyHeader, 0, sizeof(abyHeader));
+    nOffset = VSIFWriteL(abyHeader, 1, sizeof(abyHeader), fp);
+    bError = nOffset != sizeof(abyHeader);
+
+    return !bError;
+}
+
+/************************************************************************/
+/*                             AddFeature()                             */
+/*                                                                      */
+/*      The features must come in the order of their FIDs, from 0.      */
+/************************************************************************/
+
+bool OGRVFPFeatureCacheWriter::AddFeature( OGRFeature *poFeature )
+{
+    if( fp == NULL || bError )
+        return FALSE;
+    if( poFeature->GetFID() != (GIntBig)anOffsets.size() )
+    {
+        bError = TRUE;
+        return FALSE;
+    }
+
+    abyRecord.resize(0);
+
+    OGRGeometry *poGeom = poFeature->GetGeometryRef();
+    if( poGeom != NULL && !poGeom->IsEmpty() )
+    {
+        const int nWkbSize = poGeom->WkbSize();
+        OGREnvelope sEnvelope;
+        poGeom->getEnvelope(&sEnvelope);
+        AppendUInt32(abyRecord, (GUInt32)nWkbSize);
+        AppendDouble(abyRecord, sEnvelope.MinX);
+        AppendDouble(abyRecord, sEnvelope.MinY);
+        AppendDouble(abyRecord, sEnvelope.MaxX);
+        AppendDouble(abyRecord, sEnvelope.MaxY);
+        const size_t nWkbOffset = abyRecord.size();
+        abyRecord.resize(nWkbOffset + nWkbSize);
+        poGeom->exportToWkb(wkbNDR, &abyRecord[nWkbOffset], wkbVariantIso);
+    }
+    else
+        AppendUInt32(abyRecord, 0);
+
+    OGRFeatureDefn *poFeatureDefn = poFeature->GetDefnRef();
+    const int nFields = poFeatureDefn->GetFieldCount();
+    const size_t nSetOffset = abyRecord.size();
+    abyRecord.resize(nSetOffset + (nFields + 7) / 8, 0);
+    for( int i = 0; i < nFields; i++ )
+    {
+        if( !poFeature->IsFieldSet(i) )
+            continue;
+        abyRecord[nSetOffset + i / 8] |= (GByte)(1 << (i % 8));
+
+        switch( poFeatureDefn->GetFieldDefn(i)->GetType() )
+        {
+            case OFTInteger:
+                AppendUInt32(abyRecord, (GUInt32)poFeature->GetFieldAsInteger(i));
+                break;
+
+            case OFTInteger64:
+                AppendUInt64(abyRecord, (GUIntBig)poFeature->GetFieldAsInteger64(i));
+                break;
+
+            case OFTReal:
+                AppendDouble(abyRecord, poFeature->GetFieldAsDouble(i));
+                break;
+
+            default:
+            {
+                const char *pszValue = poFeature->GetFieldAsString(i);
+                const size_t nLen = strlen(pszValue);
+                AppendUInt32(abyRecord, (GUInt32)nLen);
+                abyRecord.insert(abyRecord.end(), pszValue, pszValue + nLen);
+                break;
+            }
+        }
+    }
+
+    if( VSIFWriteL(&abyRecord[0], 1, abyRecord.size(), fp) != abyRecord.size() )
+    {
+        bError = TRUE;
+        return FALSE;
+    }
+    anOffsets.push_back(nOffset);
+    nOffset += abyRecord.size();
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                               Finish()                               */
+/*                                                                      */
+/*      Write the record table and the header. The file is removed if   */
+/*      anything failed.                                                */
+/************************************************************************/
+
+bool OGRVFPFeatureCacheWriter::Finish( const char *pszDataFilename,
+                                       GUInt32 nHeaderHash,
+                                       vsi_l_offset nSectionStart,
+                                       OGRFeatureDefn *poFeatureDefn,
+                                       bool bLinearize,
+                                       double dfMaxAngleStep )
+{
+    VSIStatBufL sStat;
+    if( fp == NULL || bError || VSIStatL(pszDataFilename, &sStat) != 0 )
+    {
+        Abort();
+        return FALSE;
+    }
+
+    const GUIntBig nFeatures = anOffsets.size();
+    const GUIntBig nTableOffset = nOffset;
+    anOffsets.push_back(nOffset);
+
+    std::vector<GByte> abyData;
+    abyData.reserve(anOffsets.size() * 8);
+    for( size_t i = 0; i < anOffsets.size(); i++ )
+        AppendUInt64(abyData, anOffsets[i]);
+    bool bOK = VSIFWriteL(&abyData[0], 1, abyData.size(), fp) == abyData.size();
+
+    abyData.resize(0);
+    abyData.insert(abyData.end(), VFPC_MAGIC, VFPC_MAGIC + 8);
+    AppendUInt32(abyData, VFPC_VERSION);
+    AppendUInt32(abyData, (GUInt32)poFeatureDefn->GetFieldCount());
+    AppendUInt64(abyData, (GUIntBig)sStat.st_size);
+    AppendUInt64(abyData, (GUIntBig)sStat.st_mtime);
+    AppendUInt32(abyData, nHeaderHash);
+    AppendUInt32(abyData, GetSchemaHash(poFeatureDefn));
+    AppendUInt64(abyData, (GUIntBig)nSectionStart);
+    AppendUInt64(abyData, nFeatures);
+    AppendUInt64(abyData, nTableOffset);
+    AppendUInt32(abyData, bLinearize ? 1 : 0);
+    AppendUInt32(abyData, 0);
+    /* the angle step only matters to linearized arcs */
+    AppendDouble(abyData, bLinearize ? dfMaxAngleStep : 0.0);
+    bOK = bOK && VSIFSeekL(fp, 0, SEEK_SET) == 0 &&
+          VSIFWriteL(&abyData[0], 1, abyData.size(), fp) == VFPC_HEADER_SIZE;
+
+    bOK = VSIFCloseL(fp) == 0 && bOK;
+    fp = NULL;
+    if( !bOK )
+    {
+        VSIUnlink(osFilename);
+        return FALSE;
+    }
+
+    CPLDebug("VFP", "Wrote %s: " CPL_FRMT_GUIB " features, " CPL_FRMT_GUIB " bytes",
+             osFilename.c_str(), nFeatures, nTableOffset);
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                               Abort()                                */
+/************************************************************************/
+
+void OGRVFPFeatureCacheWriter::Abort()
+{
+    if( fp == NULL )
+        return;
+
+    VSIFCloseL(fp);
+    fp = NULL;
+    VSIUnlink(osFilename);
+}
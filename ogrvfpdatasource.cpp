@@ -31,9 +31,192 @@
 #include "cpl_conv.h"
 #include "cpl_string.h"
 #include "cpl_csv.h"
+#include "cpl_minixml.h"
+
+#include <time.h>
 
 CPL_CVSID("$Id$");
 
+/* Top-level elements of v:vfp exposed as layers. Records (features) are
+   the elements nested nRecordDepth levels below the layer element, e.g.
+   <ucastnici><uca/></ucastnici> or <zs><plins><plin/></plins></zs>.
+   Regenerate with:
+   python generate_schema.py data/vfp_3.1.xsd ogrvfpschema.h ogrvfptokens.h */
+#include "ogrvfpschema.h"
+
+/* version of the schema the tables are generated from */
+#define VFP_SCHEMA_VERSION "3.1"
+
+/************************************************************************/
+/*                           OGRVFPGetToken()                           */
+/*                                                                      */
+/*      Perfect hash lookup in the tables of ogrvfpschema.h: the        */
+/*      FNV-1a hash of the name selects a bucket whose seed maps the    */
+/*      names of the bucket to distinct slots. Must match               */
+/*      generate_schema.py.                                             */
+/************************************************************************/
+
+OGRVFPToken OGRVFPGetToken( const char *pszName )
+
+{
+    GUInt32 nHash = 2166136261U;
+    for( const unsigned char *pabyIter = (const unsigned char *)pszName;
+         *pabyIter != '\0'; pabyIter++ )
+        nHash = (nHash ^ *pabyIter) * 16777619U;
+
+    GUInt32 nSlot = nHash ^ anVFPTokenSeeds[nHash & (VFP_TOKEN_BUCKETS - 1)];
+    nSlot ^= nSlot >> 16;
+    nSlot *= 0x85ebca6bU;
+    nSlot ^= nSlot >> 13;
+    nSlot *= 0xc2b2ae35U;
+    nSlot ^= nSlot >> 16;
+
+    const OGRVFPTokenDesc *psSlot = &asVFPTokenSlots[nSlot & (VFP_TOKEN_SLOTS - 1)];
+    if( psSlot->pszName != NULL && strcmp(psSlot->pszName, pszName) == 0 )
+        return psSlot->eToken;
+    return VFP_TOKEN_UNKNOWN;
+}
+
+/************************************************************************/
+/*                         OGRVFPSniffHeader()                          */
+/*                                                                      */
+/*      Skip the XML declaration, comments and other markup before      */
+/*      the root element and compare its name with the token of vfp.    */
+/*      Only the start tags of the root and hlav are looked at, with    */
+/*      no character references nor encodings other than ASCII          */
+/*      compatible ones, which is all VFP files use.                    */
+/************************************************************************/
+
+static bool IsXMLSpace( char ch )
+{
+    return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
+}
+
+/* position after the first pszToken from p, NULL if not found */
+static const char *SkipPast( const char *p, const char *pszEnd,
+                             const char *pszToken )
+{
+    const size_t nTokenLen = strlen(pszToken);
+    for( ; p + nTokenLen <= pszEnd; p++ )
+    {
+        if( memcmp(p, pszToken, nTokenLen) == 0 )
+            return p + nTokenLen;
+    }
+    return NULL;
+}
+
+/* position after the name of the element whose start tag begins at p,
+   NULL if the name is not complete */
+static const char *SkipName( const char *p, const char *pszEnd )
+{
+    while( p < pszEnd && !IsXMLSpace(*p) && *p != '>' && *p != '/' )
+        p++;
+    return p < pszEnd ? p : NULL;
+}
+
+OGRVFPSniffResult OGRVFPSniffHeader( const char *pszHeader, int nHeaderBytes,
+                                     CPLString *posVersion )
+{
+    const char *p = pszHeader;
+    const char *pszEnd = pszHeader + nHeaderBytes;
+
+    /* UTF-8 byte order mark */
+    if( nHeaderBytes >= 3 && memcmp(p, "\xEF\xBB\xBF", 3) == 0 )
+        p += 3;
+
+    /* prolog */
+    while( TRUE )
+    {
+        while( p < pszEnd && IsXMLSpace(*p) )
+            p++;
+        if( pszEnd - p < 4 )
+            return VFP_SNIFF_NEED_MORE;
+        if( *p != '<' )
+            return VFP_SNIFF_NOT_VFP;
+
+        if( p[1] == '?' )
+            p = SkipPast(p + 2, pszEnd, "?>");
+        else if( strncmp(p, "<!--", 4) == 0 )
+            p = SkipPast(p + 4, pszEnd, "-->");
+        else if( p[1] == '!' )
+            p = SkipPast(p + 2, pszEnd, ">");
+        else
+            break;
+        if( p == NULL )
+            return VFP_SNIFF_NEED_MORE;
+    }
+
+    const char *pszName = p + 1;
+    p = SkipName(pszName, pszEnd);
+    if( p == NULL )
+        return VFP_SNIFF_NEED_MORE;
+    if( OGRVFPGetToken(CPLString(pszName, p - pszName)) != VFP_TOKEN_VFP )
+        return VFP_SNIFF_NOT_VFP;
+    if( posVersion == NULL )
+        return VFP_SNIFF_VFP;
+
+    /* end of the start tag of the root, > may appear in its values */
+    char chQuote = '\0';
+    for( ; p < pszEnd && (chQuote != '\0' || *p != '>'); p++ )
+    {
+        if( chQuote == '\0' && (*p == '"' || *p == '\'') )
+            chQuote = *p;
+        else if( *p == chQuote )
+            chQuote = '\0';
+    }
+    if( p == pszEnd )
+        return VFP_SNIFF_VFP;
+    p++;
+
+    /* first element in the root */
+    while( TRUE )
+    {
+        while( p < pszEnd && IsXMLSpace(*p) )
+            p++;
+        if( pszEnd - p < 4 || *p != '<' )
+            return VFP_SNIFF_VFP;
+        if( strncmp(p, "<!--", 4) != 0 )
+            break;
+        p = SkipPast(p + 4, pszEnd, "-->");
+        if( p == NULL )
+            return VFP_SNIFF_VFP;
+    }
+
+    pszName = p + 1;
+    p = SkipName(pszName, pszEnd);
+    if( p == NULL || OGRVFPGetToken(CPLString(pszName, p - pszName)) != VFP_TOKEN_HLAV )
+        return VFP_SNIFF_VFP;
+
+    /* attributes of hlav */
+    while( TRUE )
+    {
+        while( p < pszEnd && IsXMLSpace(*p) )
+            p++;
+        if( p == pszEnd || *p == '>' || *p == '/' )
+            return VFP_SNIFF_VFP;
+
+        const char *pszAttr = p;
+        while( p < pszEnd && *p != '=' && !IsXMLSpace(*p) )
+            p++;
+        const size_t nAttrLen = p - pszAttr;
+        while( p < pszEnd && (*p == '=' || IsXMLSpace(*p)) )
+            p++;
+        if( p == pszEnd || (*p != '"' && *p != '\'') )
+            return VFP_SNIFF_VFP;
+
+        const char *pszValue = p + 1;
+        p = (const char *) memchr(pszValue, *p, pszEnd - pszValue);
+        if( p == NULL )
+            return VFP_SNIFF_VFP;
+        if( nAttrLen == 3 && strncmp(pszAttr, "ver", 3) == 0 )
+        {
+            posVersion->assign(pszValue, p - pszValue);
+            return VFP_SNIFF_VFP;
+        }
+        p++;
+    }
+}
+
 /************************************************************************/
 /*                          OGRVFPDataSource()                          */
 /************************************************************************/
@@ -42,16 +225,45 @@ OGRVFPDataSource::OGRVFPDataSource()
 {
     pszName = NULL;
     pszVersion = NULL;
-    
-    validity = VFP_VALIDITY_UNKNOWN;
+    pszEncoding = NULL;
+    poSRS = NULL;
+    bSRSInitialized = FALSE;
+    fpVFP = NULL;
+    hFileMutex = NULL;
+
+    bUseIndex = TRUE;
+    nReadChunkSize = 256 * 1024;
+    bUseMmap = TRUE;
+    nFeatureQueueSize = 100;
+    bParserThreads = FALSE;
+    nParseThreads = 1;
+    bLinearize = FALSE;
+    dfMaxAngleStep = 0.0;
+    eSpatialIndexMode = VFP_SPATIAL_INDEX_AUTO;
+    bFeatureCache = FALSE;
+    bStats = FALSE;
+    OGRVFPResetStats(&sScanStats);
+    papszStatsMetadata = NULL;
+    bSectionsScanned = FALSE;
     
 #ifdef HAVE_EXPAT
     oCurrentParser = NULL;
     nDataHandlerCounter = 0;
+
+    psCurSection = NULL;
+    nCurRecordDepth = 0;
+    bStopParsing = FALSE;
+    nWithoutEventCounter = 0;
+    depthLevel = 0;
+    nScanRecords = 0;
+    nLastSplitOffset = 0;
+    nSliceSize = 0;
 #endif
 
     nLayers = 0;
     papoLayers = NULL;
+
+    poWriter = NULL;
 }
 
 /************************************************************************/
@@ -61,221 +273,1314 @@ OGRVFPDataSource::OGRVFPDataSource()
 OGRVFPDataSource::~OGRVFPDataSource()
 
 {
+    for( size_t i = 0; i < apoWriterLayers.size(); i++ )
+        delete apoWriterLayers[i];
+    /* closes the elements left open and the file */
+    delete poWriter;
+
     for( int i = 0; i < nLayers; i++ )
         delete papoLayers[i];
     CPLFree( papoLayers );
+
+    if( bStats && sScanStats.nRecords > 0 )
+        CPLDebug( "VFP", "%s: scan of " CPL_FRMT_GIB " records, "
+                  CPL_FRMT_GIB " bytes read, " CPL_FRMT_GIB " bytes mapped, "
+                  "read " CPL_FRMT_GIB " ns, parse " CPL_FRMT_GIB " ns",
+                  pszName, sScanStats.nRecords, sScanStats.nBytesRead,
+                  sScanStats.nBytesMapped, sScanStats.nReadNs,
+                  sScanStats.nExpatNs );
+    CSLDestroy( papszStatsMetadata );
+
     CPLFree( pszName );
     CPLFree( pszVersion );
+    CPLFree( pszEncoding );
+    if( poSRS != NULL )
+        poSRS->Release();
+    if( fpVFP != NULL )
+        VSIFCloseL( fpVFP );
+    if( hFileMutex != NULL )
+        CPLDestroyMutex( hFileMutex );
+}
+
+/************************************************************************/
+/*                       GetMetadataDomainList()                        */
+/************************************************************************/
+
+char **OGRVFPDataSource::GetMetadataDomainList()
+{
+    return BuildMetadataDomainList(OGRDataSource::GetMetadataDomainList(),
+                                   TRUE, "VFP_STATS", NULL);
+}
+
+/************************************************************************/
+/*                            GetMetadata()                             */
+/*                                                                      */
+/*      VFP_STATS: statistics of the scan of the whole file that finds  */
+/*      the layers; those of the reading are in the layer metadata.     */
+/*      With STATS=YES, PARSE_NS includes the scan handlers.            */
+/************************************************************************/
+
+char **OGRVFPDataSource::GetMetadata( const char *pszDomain )
+{
+    if( pszDomain == NULL || !EQUAL(pszDomain, "VFP_STATS") )
+        return OGRDataSource::GetMetadata(pszDomain);
+
+    CSLDestroy( papszStatsMetadata );
+    papszStatsMetadata = OGRVFPStatsToList(&sScanStats, NULL);
+    return papszStatsMetadata;
+}
+
+/************************************************************************/
+/*                          GetMetadataItem()                           */
+/************************************************************************/
+
+const char *OGRVFPDataSource::GetMetadataItem( const char *pszName,
+                                               const char *pszDomain )
+{
+    if( pszDomain == NULL || !EQUAL(pszDomain, "VFP_STATS") )
+        return OGRDataSource::GetMetadataItem(pszName, pszDomain);
+
+    return CSLFetchNameValue(GetMetadata(pszDomain), pszName);
+}
+
+/************************************************************************/
+/*                           GetSpatialRef()                            */
+/*                                                                      */
+/*      S-JTSK (EPSG:5514), looked up once for all the layers.          */
+/************************************************************************/
+
+OGRSpatialReference *OGRVFPDataSource::GetSpatialRef()
+
+{
+    if( !bSRSInitialized )
+    {
+        bSRSInitialized = TRUE;
+        poSRS = new OGRSpatialReference();
+        if( poSRS->importFromEPSG(5514) != OGRERR_NONE )
+        {
+            delete poSRS;
+            poSRS = NULL;
+        }
+    }
+    return poSRS;
+}
+
+/************************************************************************/
+/*                              ReadFile()                              */
+/*                                                                      */
+/*      Read from the file handle shared by the layers. The readers     */
+/*      of several layers may run in different threads, so each read    */
+/*      seeks to its own offset under the mutex.                        */
+/************************************************************************/
+
+int OGRVFPDataSource::ReadFile( vsi_l_offset nOffset, void *pBuffer, int nSize )
+
+{
+    int nRead = 0;
+
+    CPLAcquireMutex(hFileMutex, 1000.0);
+    if( VSIFSeekL(fpVFP, nOffset, SEEK_SET) == 0 )
+        nRead = (int)VSIFReadL(pBuffer, 1, nSize, fpVFP);
+    CPLReleaseMutex(hFileMutex);
+
+    return nRead;
+}
+
+/************************************************************************/
+/*                              MapFile()                               */
+/************************************************************************/
+
+bool OGRVFPDataSource::MapFile( OGRVFPMappedRange *poRange,
+                                vsi_l_offset nStart, vsi_l_offset nEnd )
+
+{
+    CPLAcquireMutex(hFileMutex, 1000.0);
+    bool bRet = poRange->Map(fpVFP, nStart, nEnd);
+    CPLReleaseMutex(hFileMutex);
+
+    return bRet;
 }
 
 #ifdef HAVE_EXPAT
 
 /************************************************************************/
-/*                startElementValidateCbk()                             */
+/*                         startElementScanCbk()                        */
+/*                                                                      */
+/*      The section of a top-level element of a layer is recorded,      */
+/*      with a split point for NUM_THREADS at the first record          */
+/*      starting VFP_SLICE_SIZE bytes or more after the previous one.   */
+/*      Its records are counted on the way, for GetFeatureCount().      */
 /************************************************************************/
 
-void OGRVFPDataSource::startElementValidateCbk(const char *pszName, const char **ppszAttr)
+void OGRVFPDataSource::startElementScanCbk(const char *pszName,
+                                           CPL_UNUSED const char **ppszAttr)
 {
-    if (validity == VFP_VALIDITY_UNKNOWN)
+    if (bStopParsing) return;
+
+    nWithoutEventCounter = 0;
+
+    if (depthLevel == 1)
     {
-        if (strcmp(pszName, "v:vfp") == 0)
+        const int iLayer = FindLayerIndex(OGRVFPGetToken(pszName));
+        psCurSection = NULL;
+        if (iLayer >= 0)
         {
-            validity = VFP_VALIDITY_VALID;
+            psCurSection = &asSections[iLayer];
+            psCurSection->nStart =
+                (vsi_l_offset)XML_GetCurrentByteIndex(oCurrentParser);
+            psCurSection->asSplitPoints.clear();
+            nCurRecordDepth = asVFPLayers[iLayer].nRecordDepth;
+            aosScanPath.clear();
+            nScanRecords = 0;
+            nLastSplitOffset = psCurSection->nStart;
         }
-        else
+    }
+
+    /* depth of the element in the layer element */
+    const int nDepth = depthLevel - 1;
+    if (psCurSection != NULL && nDepth < nCurRecordDepth)
+    {
+        aosScanPath.push_back(pszName);
+    }
+    else if (psCurSection != NULL && nDepth == nCurRecordDepth)
+    {
+        vsi_l_offset nOffset =
+            (vsi_l_offset)XML_GetCurrentByteIndex(oCurrentParser);
+        if (nOffset - nLastSplitOffset >= (vsi_l_offset)nSliceSize)
         {
-            validity = VFP_VALIDITY_INVALID;
+            OGRVFPSplitPoint sSplit;
+            sSplit.nOffset = nOffset;
+            sSplit.nFID = nScanRecords;
+            for( size_t i = 0; i < aosScanPath.size(); i++ )
+            {
+                if (i > 0)
+                    sSplit.osPath += "/";
+                sSplit.osPath += aosScanPath[i];
+            }
+            psCurSection->asSplitPoints.push_back(sSplit);
+            nLastSplitOffset = nOffset;
         }
+        nScanRecords++;
     }
+
+    depthLevel++;
 }
 
+/************************************************************************/
+/*                          endElementScanCbk()                         */
+/************************************************************************/
+
+void OGRVFPDataSource::endElementScanCbk(CPL_UNUSED const char *pszName)
+{
+    if (bStopParsing) return;
+
+    nWithoutEventCounter = 0;
+
+    depthLevel--;
+
+    if (psCurSection == NULL)
+        return;
+
+    if (depthLevel == 1)
+    {
+        psCurSection->nEnd =
+            (vsi_l_offset)(XML_GetCurrentByteIndex(oCurrentParser) +
+                           XML_GetCurrentByteCount(oCurrentParser));
+        psCurSection->nFeatureCount = nScanRecords;
+        psCurSection = NULL;
+    }
+    else if (depthLevel - 1 < nCurRecordDepth && !aosScanPath.empty())
+        aosScanPath.pop_back();
+}
 
 /************************************************************************/
-/*                      dataHandlerValidateCbk()                        */
+/*                         dataHandlerScanCbk()                         */
 /************************************************************************/
 
-void OGRVFPDataSource::dataHandlerValidateCbk(CPL_UNUSED const char *data,
-                                              CPL_UNUSED int nLen)
+void OGRVFPDataSource::dataHandlerScanCbk(CPL_UNUSED const char *data,
+                                          CPL_UNUSED int nLen)
 {
+    if (bStopParsing) return;
+
     nDataHandlerCounter ++;
-    if (nDataHandlerCounter >= BUFSIZ)
+    if (nDataHandlerCounter >= nReadChunkSize)
     {
         CPLError(CE_Failure, CPLE_AppDefined,
                  "File probably corrupted (million laugh pattern)");
         XML_StopParser(oCurrentParser, XML_FALSE);
+        bStopParsing = TRUE;
     }
 }
 
-static void XMLCALL startElementValidateCbk(void *pUserData, const char *pszName, const char **ppszAttr)
+/************************************************************************/
+/*                           xmlDeclScanCbk()                           */
+/************************************************************************/
+
+void OGRVFPDataSource::xmlDeclScanCbk(const char *pszEncodingIn)
 {
-    OGRVFPDataSource* poDS = (OGRVFPDataSource*) pUserData;
-    poDS->startElementValidateCbk(pszName, ppszAttr);
+    CPLFree(pszEncoding);
+    pszEncoding = pszEncodingIn ? CPLStrdup(pszEncodingIn) : NULL;
 }
 
-static void XMLCALL dataHandlerValidateCbk(void *pUserData, const char *data, int nLen)
+static void XMLCALL startElementScanCbk(void *pUserData, const char *pszName, const char **ppszAttr)
 {
-    OGRVFPDataSource* poDS = (OGRVFPDataSource*) pUserData;
-    poDS->dataHandlerValidateCbk(data, nLen);
+    ((OGRVFPDataSource*)pUserData)->startElementScanCbk(pszName, ppszAttr);
+}
+
+static void XMLCALL endElementScanCbk(void *pUserData, const char *pszName)
+{
+    ((OGRVFPDataSource*)pUserData)->endElementScanCbk(pszName);
+}
+
+static void XMLCALL dataHandlerScanCbk(void *pUserData, const char *data, int nLen)
+{
+    ((OGRVFPDataSource*)pUserData)->dataHandlerScanCbk(data, nLen);
+}
+
+static void XMLCALL xmlDeclScanCbk(void *pUserData,
+                                         CPL_UNUSED const XML_Char *pszVersion,
+                                         const XML_Char *pszEncoding,
+                                         CPL_UNUSED int nStandalone)
+{
+    ((OGRVFPDataSource*)pUserData)->xmlDeclScanCbk(pszEncoding);
 }
-#endif
 
 /************************************************************************/
-/*                                Open()                                */
+/*                            ParseSections()                           */
+/*                                                                      */
+/*      Find the elements of all layers in a single pass over the       */
+/*      file instead of letting each layer scan the whole document.     */
+/*      No reader uses the shared handle before the sections are        */
+/*      known, so it is read directly.                                  */
 /************************************************************************/
 
-int OGRVFPDataSource::Open( const char * pszFilename, int bUpdateIn)
+void OGRVFPDataSource::ParseSections()
 {
-    if (bUpdateIn)
+    VSILFILE* fp = fpVFP;
+    VSIFSeekL(fp, 0, SEEK_SET);
+
+    for( int i = 0; i < nLayers; i++ )
     {
-        CPLError(CE_Failure, CPLE_NotSupported,
-                    "OGR/VFP driver does not support opening a file in update mode");
-        return FALSE;
+        asSections[i].nStart = 0;
+        asSections[i].nEnd = 0;
+        asSections[i].asSplitPoints.clear();
+        asSections[i].nFeatureCount = 0;
+        asSections[i].bExtentScanned = FALSE;
+        asSections[i].bHasExtent = FALSE;
     }
-    
-#ifdef HAVE_EXPAT
-    pszName = CPLStrdup( pszFilename );
-
-    // try to open the file
-    VSILFILE* fp = VSIFOpenL(pszFilename, "r");
-    if (fp == NULL)
-        return FALSE;
 
-    validity = VFP_VALIDITY_UNKNOWN;
-    CPLFree(pszVersion);
-    pszVersion = NULL;
+    nSliceSize = atoi(CPLGetConfigOption("VFP_SLICE_SIZE", "4194304"));
+    if (nSliceSize < 1)
+        nSliceSize = 1;
 
     XML_Parser oParser = OGRCreateExpatXMLParser();
     oCurrentParser = oParser;
     XML_SetUserData(oParser, this);
-    XML_SetElementHandler(oParser, ::startElementValidateCbk, NULL);
-    XML_SetCharacterDataHandler(oParser, ::dataHandlerValidateCbk);
+    XML_SetElementHandler(oParser, ::startElementScanCbk, ::endElementScanCbk);
+    XML_SetCharacterDataHandler(oParser, ::dataHandlerScanCbk);
+    XML_SetXmlDeclHandler(oParser, ::xmlDeclScanCbk);
+
+    psCurSection = NULL;
+    bStopParsing = FALSE;
+    nWithoutEventCounter = 0;
+    depthLevel = 0;
+
+    OGRVFPMappedRange oMappedRange;
+    vsi_l_offset nOffset = 0;
+    if (bUseMmap && oMappedRange.Map(fp, 0, ~((vsi_l_offset)0)))
+        CPLDebug("VFP", "%s: scanning a mapping of the file", pszName);
 
-    char aBuf[BUFSIZ];
+    GIntBig nScanStart = 0;
     int nDone;
-    unsigned int nLen;
-    int nCount = 0;
-    
-    /* Begin to parse the file and look for the <v:vfp> element */
-    /* It *MUST* be the first element of an XML file */
-    /* So once we have read the first element, we know if we can */
-    /* handle the file or not with that driver */
     do
     {
         nDataHandlerCounter = 0;
-        nLen = (unsigned int) VSIFReadL( aBuf, 1, sizeof(aBuf), fp );
-        nDone = VSIFEofL(fp);
-        if (XML_Parse(oParser, aBuf, nLen, nDone) == XML_STATUS_ERROR)
+        if (bStats)
+            nScanStart = OGRVFPGetTimeNs();
+        if (oMappedRange.IsMapped())
         {
-            if (nLen <= BUFSIZ-1)
-                aBuf[nLen] = 0;
-            else
-                aBuf[BUFSIZ-1] = 0;
-            if (strstr(aBuf, "<?xml") && strstr(aBuf, "<v:vfp"))
+            /* the mapped bytes are parsed in place, in chunks so that
+               the checks below still apply */
+            int nLen = nReadChunkSize;
+            if (oMappedRange.GetEnd() - nOffset < (vsi_l_offset)nLen)
+                nLen = (int)(oMappedRange.GetEnd() - nOffset);
+            const char *pszData = oMappedRange.GetData(nOffset);
+            nOffset += nLen;
+            nDone = (nOffset == oMappedRange.GetEnd());
+            sScanStats.nBytesMapped += nLen;
+            const XML_Status eStatus = XML_Parse(oParser, pszData, nLen, nDone);
+            if (bStats)
+                sScanStats.nExpatNs += OGRVFPGetTimeNs() - nScanStart;
+            if (eStatus == XML_STATUS_ERROR)
             {
                 CPLError(CE_Failure, CPLE_AppDefined,
-                        "XML parsing of VFP file failed : %s at line %d, column %d",
-                        XML_ErrorString(XML_GetErrorCode(oParser)),
-                        (int)XML_GetCurrentLineNumber(oParser),
-                        (int)XML_GetCurrentColumnNumber(oParser));
+                         "XML parsing of VFP file failed : %s at line %d, column %d",
+                         XML_ErrorString(XML_GetErrorCode(oParser)),
+                         (int)XML_GetCurrentLineNumber(oParser),
+                         (int)XML_GetCurrentColumnNumber(oParser));
+                bStopParsing = TRUE;
+                break;
             }
-            validity = VFP_VALIDITY_INVALID;
-            break;
+            nWithoutEventCounter ++;
+            continue;
         }
-        
-        if (validity == VFP_VALIDITY_INVALID || validity == VFP_VALIDITY_VALID)
+
+        void *pBuf = XML_GetBuffer(oParser, nReadChunkSize);
+        if (pBuf == NULL)
         {
+            CPLError(CE_Failure, CPLE_OutOfMemory,
+                     "Cannot allocate XML parser buffer");
+            bStopParsing = TRUE;
             break;
         }
-        else
+        unsigned int nLen = (unsigned int)VSIFReadL( pBuf, 1, nReadChunkSize, fp );
+        nDone = VSIFEofL(fp);
+        sScanStats.nBytesRead += nLen;
+        sScanStats.nReadCalls++;
+        if (bStats)
         {
-            /* After reading 50 * BUFSIZE bytes, and not finding whether the file */
-            /* is VFP or not, we give up and fail silently */
-            nCount ++;
-            if (nCount == 50)
-                break;
+            const GIntBig nReadEnd = OGRVFPGetTimeNs();
+            sScanStats.nReadNs += nReadEnd - nScanStart;
+            nScanStart = nReadEnd;
         }
-    } while (!nDone && nLen > 0 );
-    
+        const XML_Status eStatus = XML_ParseBuffer(oParser, nLen, nDone);
+        if (bStats)
+            sScanStats.nExpatNs += OGRVFPGetTimeNs() - nScanStart;
+        if (eStatus == XML_STATUS_ERROR)
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "XML parsing of VFP file failed : %s at line %d, column %d",
+                     XML_ErrorString(XML_GetErrorCode(oParser)),
+                     (int)XML_GetCurrentLineNumber(oParser),
+                     (int)XML_GetCurrentColumnNumber(oParser));
+            bStopParsing = TRUE;
+            break;
+        }
+        nWithoutEventCounter ++;
+    } while (!nDone && !bStopParsing && nWithoutEventCounter < 10);
+
+    if (nWithoutEventCounter == 10)
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Too much data inside one element. File probably corrupted");
+        bStopParsing = TRUE;
+    }
+
     XML_ParserFree(oParser);
-    
-    VSIFCloseL(fp);
+    oCurrentParser = NULL;
+    psCurSection = NULL;
+    aosScanPath.clear();
+
+    for( int i = 0; i < nLayers; i++ )
+        sScanStats.nRecords += asSections[i].nFeatureCount;
+
+    oMappedRange.Unmap();
+}
+#endif
+
+/************************************************************************/
+/*                            ScanSections()                            */
+/*                                                                      */
+/*      The byte ranges of the layer elements are only needed once a    */
+/*      layer is read, so they are looked up on first use from the      */
+/*      .vfpi index or by parsing the file.                             */
+/************************************************************************/
+
+void OGRVFPDataSource::ScanSections()
+{
+    if (bSectionsScanned)
+        return;
+    bSectionsScanned = TRUE;
+
+#ifdef HAVE_EXPAT
+    if (bUseIndex && ReadIndex())
+        return;
+
+    ParseSections();
+    if (bUseIndex && !bStopParsing)
+        WriteIndex();
+#endif
+}
+
+/************************************************************************/
+/*                        SetSectionStatistics()                        */
+/*                                                                      */
+/*      Keep the feature count and the extent found by a layer, NULL    */
+/*      if it has no coordinates, and rewrite the .vfpi index so that   */
+/*      they are known when the file is opened again.                   */
+/************************************************************************/
+
+void OGRVFPDataSource::SetSectionStatistics( const OGRVFPSection *psSection,
+                                             GIntBig nFeatureCount,
+                                             const OGREnvelope *psExtent )
+{
+    OGRVFPSection *psTarget = &asSections[psSection - &asSections[0]];
+    psTarget->nFeatureCount = nFeatureCount;
+    psTarget->bExtentScanned = TRUE;
+    psTarget->bHasExtent = psExtent != NULL;
+    if (psExtent != NULL)
+        psTarget->sExtent = *psExtent;
+
+#ifdef HAVE_EXPAT
+    if (bUseIndex && !bStopParsing)
+        WriteIndex();
+#endif
+}
+
+/************************************************************************/
+/*                          GetIndexFilename()                          */
+/************************************************************************/
 
-    if (validity == VFP_VALIDITY_VALID)
+const char *OGRVFPDataSource::GetIndexFilename( const char *pszFilename )
+{
+    return CPLResetExtension(pszFilename, "vfpi");
+}
+
+/************************************************************************/
+/*                      GetSpatialIndexFilename()                       */
+/************************************************************************/
+
+const char *OGRVFPDataSource::GetSpatialIndexFilename( const char *pszFilename,
+                                                       const char *pszLayerName )
+{
+    return CPLResetExtension(pszFilename, CPLSPrintf("%s.vfpr", pszLayerName));
+}
+
+/************************************************************************/
+/*                      GetFeatureCacheFilename()                       */
+/************************************************************************/
+
+const char *OGRVFPDataSource::GetFeatureCacheFilename( const char *pszFilename,
+                                                       const char *pszLayerName )
+{
+    return CPLResetExtension(pszFilename, CPLSPrintf("%s.vfpc", pszLayerName));
+}
+
+/************************************************************************/
+/*                          DeleteLayerFiles()                          */
+/*                                                                      */
+/*      Remove the spatial indexes and feature caches of the layers     */
+/*      of the schema, by their exact names so that the files of        */
+/*      another data file sharing the prefix are kept.                  */
+/************************************************************************/
+
+void OGRVFPDataSource::DeleteLayerFiles( const char *pszFilename )
+{
+    VSIStatBufL sStatBuf;
+    const int nSchemaLayers = (int)(sizeof(asVFPLayers) / sizeof(asVFPLayers[0]));
+    for( int i = 0; i < nSchemaLayers; i++ )
     {
-        CPLDebug("VFP", "%s seems to be a VFP file.", pszFilename);
+        CPLString osFilename =
+            GetSpatialIndexFilename(pszFilename, asVFPLayers[i].pszName);
+        if( VSIStatL(osFilename, &sStatBuf) == 0 )
+            VSIUnlink(osFilename);
+
+        osFilename = GetFeatureCacheFilename(pszFilename, asVFPLayers[i].pszName);
+        if( VSIStatL(osFilename, &sStatBuf) == 0 )
+            VSIUnlink(osFilename);
+    }
+}
+
+/************************************************************************/
+/*                           GetHeaderHash()                            */
+/*                                                                      */
+/*      Hash of the first bytes of the file, checked by the feature     */
+/*      caches besides its size and modification time.                  */
+/************************************************************************/
+
+GUInt32 OGRVFPDataSource::GetHeaderHash()
+{
+    GByte abyHeader[VFP_SNIFF_MAX_BYTES];
+    const int nRead = ReadFile(0, abyHeader, VFP_SNIFF_MAX_BYTES);
+    return OGRVFPHash(abyHeader, nRead);
+}
 
-        if (pszVersion == NULL)
+/************************************************************************/
+/*                             ReadIndex()                              */
+/*                                                                      */
+/*      Read the byte ranges of the layer elements and their split      */
+/*      points from the .vfpi sidecar file. The index is used only      */
+/*      when it matches the size and modification time of the file.     */
+/************************************************************************/
+
+bool OGRVFPDataSource::ReadIndex()
+{
+    VSIStatBufL sStat, sIndexStat;
+    const char *pszIndexFilename = GetIndexFilename(pszName);
+
+    if (VSIStatL(pszName, &sStat) != 0 ||
+        VSIStatL(pszIndexFilename, &sIndexStat) != 0)
+        return FALSE;
+
+    CPLXMLNode *psRoot = CPLParseXMLFile(pszIndexFilename);
+    if (psRoot == NULL)
+        return FALSE;
+
+    CPLXMLNode *psIndex = CPLGetXMLNode(psRoot, "=VFPIndex");
+    if (psIndex == NULL ||
+        atoi(CPLGetXMLValue(psIndex, "Version", "0")) != 3 ||
+        CPLAtoGIntBig(CPLGetXMLValue(psIndex, "FileSize", "-1")) !=
+            (GIntBig)sStat.st_size ||
+        CPLAtoGIntBig(CPLGetXMLValue(psIndex, "FileMTime", "-1")) !=
+            (GIntBig)sStat.st_mtime)
+    {
+        CPLDebug("VFP", "%s is out of date, ignored", pszIndexFilename);
+        CPLDestroyXMLNode(psRoot);
+        return FALSE;
+    }
+
+    const char *pszIndexEncoding = CPLGetXMLValue(psIndex, "Encoding", NULL);
+    CPLFree(pszEncoding);
+    pszEncoding = pszIndexEncoding ? CPLStrdup(pszIndexEncoding) : NULL;
+
+    for( CPLXMLNode *psLayer = psIndex->psChild;
+         psLayer != NULL; psLayer = psLayer->psNext )
+    {
+        if( psLayer->eType != CXT_Element ||
+            strcmp(psLayer->pszValue, "Layer") != 0 )
+            continue;
+
+        const int iLayer = FindLayerIndex(CPLGetXMLValue(psLayer, "Name", ""));
+        if( iLayer < 0 )
+            continue;
+
+        OGRVFPSection *psSection = &asSections[iLayer];
+        psSection->nStart =
+            (vsi_l_offset)CPLAtoGIntBig(CPLGetXMLValue(psLayer, "SectionStart", "0"));
+        psSection->nEnd =
+            (vsi_l_offset)CPLAtoGIntBig(CPLGetXMLValue(psLayer, "SectionEnd", "0"));
+        psSection->asSplitPoints.clear();
+        psSection->nFeatureCount =
+            CPLAtoGIntBig(CPLGetXMLValue(psLayer, "FeatureCount", "-1"));
+
+        /* an empty Extent element if the layer has no coordinates */
+        CPLXMLNode *psExtent = CPLGetXMLNode(psLayer, "Extent");
+        psSection->bExtentScanned = psExtent != NULL;
+        psSection->bHasExtent = psExtent != NULL &&
+                                CPLGetXMLNode(psExtent, "MinX") != NULL;
+        if( psSection->bHasExtent )
         {
-            /* Default to 2.0 */
-            CPLError(CE_Warning, CPLE_AppDefined, "VFP schema version is unknown. "
-                     "The driver may not be able to handle the file correctly "
-                     "and will behave as if it is VFP 2.0.");
-            pszVersion = CPLStrdup("2.0");
+            psSection->sExtent.MinX = CPLAtof(CPLGetXMLValue(psExtent, "MinX", "0"));
+            psSection->sExtent.MinY = CPLAtof(CPLGetXMLValue(psExtent, "MinY", "0"));
+            psSection->sExtent.MaxX = CPLAtof(CPLGetXMLValue(psExtent, "MaxX", "0"));
+            psSection->sExtent.MaxY = CPLAtof(CPLGetXMLValue(psExtent, "MaxY", "0"));
         }
-        else if (strcmp(pszVersion, "2.0") == 0)
+
+        for( CPLXMLNode *psSplit = psLayer->psChild;
+             psSplit != NULL; psSplit = psSplit->psNext )
         {
-            /* Fine */
+            if( psSplit->eType != CXT_Element ||
+                strcmp(psSplit->pszValue, "Split") != 0 )
+                continue;
+
+            OGRVFPSplitPoint sSplit;
+            sSplit.nOffset =
+                (vsi_l_offset)CPLAtoGIntBig(CPLGetXMLValue(psSplit, "Offset", "0"));
+            sSplit.nFID = CPLAtoGIntBig(CPLGetXMLValue(psSplit, "FID", "0"));
+            sSplit.osPath = CPLGetXMLValue(psSplit, "Path", "");
+            psSection->asSplitPoints.push_back(sSplit);
         }
-        else
+    }
+
+    CPLDestroyXMLNode(psRoot);
+
+    CPLDebug("VFP", "Using %s", pszIndexFilename);
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                             WriteIndex()                             */
+/************************************************************************/
+
+void OGRVFPDataSource::WriteIndex()
+{
+    VSIStatBufL sStat;
+    if (VSIStatL(pszName, &sStat) != 0)
+        return;
+
+    CPLXMLNode *psIndex = CPLCreateXMLNode(NULL, CXT_Element, "VFPIndex");
+    CPLCreateXMLElementAndValue(psIndex, "Version", "3");
+    CPLCreateXMLElementAndValue(psIndex, "FileSize",
+                                CPLSPrintf(CPL_FRMT_GUIB, (GUIntBig)sStat.st_size));
+    CPLCreateXMLElementAndValue(psIndex, "FileMTime",
+                                CPLSPrintf(CPL_FRMT_GIB, (GIntBig)sStat.st_mtime));
+    if (pszEncoding)
+        CPLCreateXMLElementAndValue(psIndex, "Encoding", pszEncoding);
+
+    for( int i = 0; i < nLayers; i++ )
+    {
+        const OGRVFPSection *psSection = &asSections[i];
+        CPLXMLNode *psLayer = CPLCreateXMLNode(psIndex, CXT_Element, "Layer");
+        CPLCreateXMLElementAndValue(psLayer, "Name", asVFPLayers[i].pszName);
+        CPLCreateXMLElementAndValue(psLayer, "SectionStart",
+                                    CPLSPrintf(CPL_FRMT_GUIB, (GUIntBig)psSection->nStart));
+        CPLCreateXMLElementAndValue(psLayer, "SectionEnd",
+                                    CPLSPrintf(CPL_FRMT_GUIB, (GUIntBig)psSection->nEnd));
+        if (psSection->nFeatureCount >= 0)
+            CPLCreateXMLElementAndValue(psLayer, "FeatureCount",
+                                        CPLSPrintf(CPL_FRMT_GIB, psSection->nFeatureCount));
+        if (psSection->bExtentScanned)
+        {
+            CPLXMLNode *psExtent = CPLCreateXMLNode(psLayer, CXT_Element, "Extent");
+            if (psSection->bHasExtent)
+            {
+                CPLCreateXMLElementAndValue(psExtent, "MinX",
+                                            CPLSPrintf("%.18g", psSection->sExtent.MinX));
+                CPLCreateXMLElementAndValue(psExtent, "MinY",
+                                            CPLSPrintf("%.18g", psSection->sExtent.MinY));
+                CPLCreateXMLElementAndValue(psExtent, "MaxX",
+                                            CPLSPrintf("%.18g", psSection->sExtent.MaxX));
+                CPLCreateXMLElementAndValue(psExtent, "MaxY",
+                                            CPLSPrintf("%.18g", psSection->sExtent.MaxY));
+            }
+        }
+
+        const std::vector<OGRVFPSplitPoint>& asSplitPoints = psSection->asSplitPoints;
+        for( size_t iSplit = 0; iSplit < asSplitPoints.size(); iSplit++ )
         {
+            CPLXMLNode *psSplit = CPLCreateXMLNode(psLayer, CXT_Element, "Split");
+            CPLCreateXMLElementAndValue(psSplit, "Offset",
+                                        CPLSPrintf(CPL_FRMT_GUIB, (GUIntBig)asSplitPoints[iSplit].nOffset));
+            CPLCreateXMLElementAndValue(psSplit, "FID",
+                                        CPLSPrintf(CPL_FRMT_GIB, asSplitPoints[iSplit].nFID));
+            CPLCreateXMLElementAndValue(psSplit, "Path", asSplitPoints[iSplit].osPath);
+        }
+    }
+
+    /* the directory may be read-only, the index is just an optimization */
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    int bOK = CPLSerializeXMLTreeToFile(psIndex, GetIndexFilename(pszName));
+    CPLPopErrorHandler();
+
+    if (!bOK)
+        CPLDebug("VFP", "Cannot write %s", GetIndexFilename(pszName));
+
+    CPLDestroyXMLNode(psIndex);
+}
+
+/************************************************************************/
+/*                                Open()                                */
+/*                                                                      */
+/*      The root element and the version are taken from the header      */
+/*      bytes already read by GDALOpenInfo, the layer elements are      */
+/*      located on first read, see ScanSections().                      */
+/************************************************************************/
+
+int OGRVFPDataSource::Open( GDALOpenInfo *poOpenInfo )
+{
+    if (poOpenInfo->eAccess == GA_Update)
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                    "OGR/VFP driver does not support opening a file in update mode");
+        return FALSE;
+    }
+
+    CPLString osVersion;
+    OGRVFPSniffResult eSniff =
+        OGRVFPSniffHeader((const char *)poOpenInfo->pabyHeader,
+                          poOpenInfo->nHeaderBytes, &osVersion);
+    /* hlav did not fit in the header, e.g. after a long comment */
+    if (eSniff != VFP_SNIFF_NOT_VFP && osVersion.empty() &&
+        poOpenInfo->nHeaderBytes < VFP_SNIFF_MAX_BYTES &&
+        poOpenInfo->TryToIngest(VFP_SNIFF_MAX_BYTES))
+    {
+        eSniff = OGRVFPSniffHeader((const char *)poOpenInfo->pabyHeader,
+                                   poOpenInfo->nHeaderBytes, &osVersion);
+    }
+    if (eSniff != VFP_SNIFF_VFP)
+        return FALSE;
+
+#ifdef HAVE_EXPAT
+    pszName = CPLStrdup( poOpenInfo->pszFilename );
+    CPLDebug("VFP", "%s seems to be a VFP file.", pszName);
+
+    /* the handle is kept for the scan of the sections and the readers */
+    fpVFP = poOpenInfo->fpL;
+    poOpenInfo->fpL = NULL;
+    if (fpVFP == NULL)
+        fpVFP = VSIFOpenL(pszName, "r");
+    if (fpVFP == NULL)
+    {
+        CPLError(CE_Failure, CPLE_OpenFailed, "Cannot open %s", pszName);
+        return FALSE;
+    }
+    hFileMutex = CPLCreateMutex();
+    CPLReleaseMutex(hFileMutex);
+
+    char **papszOpenOptions = poOpenInfo->papszOpenOptions;
+
+    nReadChunkSize = atoi(CSLFetchNameValueDef(papszOpenOptions, "READ_CHUNK_SIZE",
+                              CPLGetConfigOption("VFP_READ_CHUNK_SIZE", "262144")));
+    if (nReadChunkSize < BUFSIZ)
+        nReadChunkSize = BUFSIZ;
+    bUseMmap = CSLTestBoolean(CSLFetchNameValueDef(papszOpenOptions, "USE_MMAP",
+                   CPLGetConfigOption("VFP_USE_MMAP", "YES"))) != FALSE;
+    nFeatureQueueSize = atoi(CSLFetchNameValueDef(papszOpenOptions, "FEATURE_QUEUE_SIZE",
+                                 CPLGetConfigOption("VFP_FEATURE_QUEUE_SIZE", "100")));
+    if (nFeatureQueueSize < 1)
+        nFeatureQueueSize = 1;
+    bParserThreads = CSLTestBoolean(CSLFetchNameValueDef(papszOpenOptions, "PARSER_THREADS",
+                         CPLGetConfigOption("VFP_PARSER_THREADS", "NO"))) != FALSE;
+    const char *pszNumThreads = CSLFetchNameValueDef(papszOpenOptions, "NUM_THREADS",
+                                    CPLGetConfigOption("VFP_NUM_THREADS", "1"));
+    if (EQUAL(pszNumThreads, "ALL_CPUS"))
+        nParseThreads = CPLGetNumCPUs();
+    else
+        nParseThreads = atoi(pszNumThreads);
+    if (nParseThreads < 1)
+        nParseThreads = 1;
+    bLinearize = CSLTestBoolean(CSLFetchNameValueDef(papszOpenOptions, "LINEARIZE",
+                     CPLGetConfigOption("VFP_LINEARIZE", "NO"))) != FALSE;
+    dfMaxAngleStep = CPLAtof(CSLFetchNameValueDef(papszOpenOptions, "MAX_ANGLE_STEP",
+                         CPLGetConfigOption("VFP_MAX_ANGLE_STEP", "0")));
+    const char *pszSpatialIndex = CSLFetchNameValueDef(papszOpenOptions, "SPATIAL_INDEX",
+                                      CPLGetConfigOption("VFP_SPATIAL_INDEX", "AUTO"));
+    if (EQUAL(pszSpatialIndex, "AUTO"))
+        eSpatialIndexMode = VFP_SPATIAL_INDEX_AUTO;
+    else if (CSLTestBoolean(pszSpatialIndex))
+        eSpatialIndexMode = VFP_SPATIAL_INDEX_YES;
+    else
+        eSpatialIndexMode = VFP_SPATIAL_INDEX_NO;
+    bFeatureCache = CSLTestBoolean(CSLFetchNameValueDef(papszOpenOptions, "FEATURE_CACHE",
+                        CPLGetConfigOption("VFP_FEATURE_CACHE", "NO"))) != FALSE;
+    bStats = CSLTestBoolean(CSLFetchNameValueDef(papszOpenOptions, "STATS",
+                 CPLGetConfigOption("VFP_STATS", "NO"))) != FALSE;
+
+    if (osVersion.empty())
+    {
+        CPLError(CE_Warning, CPLE_AppDefined, "VFP schema version is unknown. "
+                 "The driver may not be able to handle the file correctly "
+                 "and will behave as if it is VFP " VFP_SCHEMA_VERSION ".");
+        pszVersion = CPLStrdup(VFP_SCHEMA_VERSION);
+    }
+    else
+    {
+        pszVersion = CPLStrdup(osVersion);
+        if (strcmp(pszVersion, VFP_SCHEMA_VERSION) != 0)
             CPLError(CE_Warning, CPLE_AppDefined,
                      "VFP schema version '%s' is not handled by the driver. "
                      "The driver may not be able to handle the file correctly "
-                     "and will behave as if it is GPX 2.0.", pszVersion);
-        }
+                     "and will behave as if it is VFP " VFP_SCHEMA_VERSION ".",
+                     pszVersion);
+    }
+
+    nLayers = (int)(sizeof(asVFPLayers) / sizeof(asVFPLayers[0]));
+    papoLayers = (OGRVFPLayer **) CPLCalloc(nLayers, sizeof(OGRVFPLayer*));
+    asSections.resize(nLayers);
+    for( int i = 0; i < nLayers; i++ )
+    {
+        asSections[i].nStart = 0;
+        asSections[i].nEnd = 0;
+        asSections[i].nFeatureCount = -1;
+        asSections[i].bExtentScanned = FALSE;
+        asSections[i].bHasExtent = FALSE;
+    }
+
+    /* the layer elements are located on first read, see ScanSections() */
+    bUseIndex = CSLFetchBoolean(papszOpenOptions, "INDEX", TRUE) != FALSE;
+
+    if (eSpatialIndexMode == VFP_SPATIAL_INDEX_YES)
+    {
+        for( int i = 0; i < nLayers; i++ )
+            ((OGRVFPLayer *) GetLayer(i))->PrepareSpatialIndex();
+    }
 
-        /* TODO: readed it from XSD */
-        nLayers = 19;
-        papoLayers = (OGRVFPLayer **) CPLRealloc(papoLayers, nLayers * sizeof(OGRVFPLayer*));
-        papoLayers[0] = new OGRVFPLayer( pszName, "ucastnici", this);
-        papoLayers[1] = new OGRVFPLayer( pszName, "narok", this);
-        papoLayers[2] = new OGRVFPLayer( pszName, "navrh", this);
-        papoLayers[3] = new OGRVFPLayer( pszName, "pneres", this);
-        papoLayers[4] = new OGRVFPLayer( pszName, "pmimo", this);
-        papoLayers[5] = new OGRVFPLayer( pszName, "bpej", this);
-        papoLayers[6] = new OGRVFPLayer( pszName, "bpejr2", this);
-        papoLayers[7] = new OGRVFPLayer( pszName, "mdp", this);
-        papoLayers[8] = new OGRVFPLayer( pszName, "zs", this);
-        papoLayers[9] = new OGRVFPLayer( pszName, "opu", this);
-        papoLayers[10] = new OGRVFPLayer( pszName, "por", this);
-        papoLayers[11] = new OGRVFPLayer( pszName, "pbre", this);
-        papoLayers[12] = new OGRVFPLayer( pszName, "spoz", this);
-        papoLayers[13] = new OGRVFPLayer( pszName, "pm", this);
-        papoLayers[14] = new OGRVFPLayer( pszName, "mp", this);
-        papoLayers[15] = new OGRVFPLayer( pszName, "meos", this);
-        papoLayers[16] = new OGRVFPLayer( pszName, "meon", this);
-        papoLayers[17] = new OGRVFPLayer( pszName, "hvpsz", this);
-        papoLayers[18] = new OGRVFPLayer( pszName, "zs", this);
-    }
-
-    return (validity == VFP_VALIDITY_VALID);
+    return TRUE;
 #else
-    char aBuf[256];
-    VSILFILE* fp = VSIFOpenL(pszFilename, "r");
-    if (fp)
+    CPLError(CE_Failure, CPLE_NotSupported,
+             "OGR/VFP driver has not been built with read support. Expat library required");
+    return FALSE;
+#endif
+}
+
+/************************************************************************/
+/*                               Create()                               */
+/*                                                                      */
+/*      Start a new document: the root element and hlav are written     */
+/*      right away, the layers follow as features are created.          */
+/************************************************************************/
+
+int OGRVFPDataSource::Create( const char *pszFilename, char **papszOptions )
+{
+    pszName = CPLStrdup( pszFilename );
+
+    VSILFILE *fp = VSIFOpenL( pszFilename, "wb" );
+    if (fp == NULL)
     {
-        unsigned int nLen = (unsigned int)VSIFReadL( aBuf, 1, 255, fp );
-        aBuf[nLen] = 0;
-        if (strstr(aBuf, "<?xml") && strstr(aBuf, "<v:vfp"))
+        CPLError(CE_Failure, CPLE_OpenFailed, "Cannot create %s", pszFilename);
+        return FALSE;
+    }
+
+    const int nBufferSize = atoi(CSLFetchNameValueDef(papszOptions, "WRITE_BUFFER_SIZE",
+                                CPLGetConfigOption("VFP_WRITE_BUFFER_SIZE", "1048576")));
+    poWriter = new OGRVFPWriter(fp, nBufferSize);
+
+    /* attributes of hlav in the order of the schema, from the creation
+       options of the same names */
+    static const char * const apszHeaderAttributes[] = {
+        "dvz", "dkn", "aut", "et", "kk", "typ", "cpu", "ocv", "kv", "ksz",
+        "ver", "sw", "sx", "sy" };
+    static const char * const apszRequired[] = {
+        "dvz", "dkn", "aut", "et", "kk", "typ", "cpu", "ver", "sw" };
+
+    time_t nNow = time(NULL);
+    struct tm sNow;
+    VSILocalTime(&nNow, &sNow);
+    CPLString osNow;
+    osNow.Printf("%04d-%02d-%02dT%02d:%02d:%02d",
+                 sNow.tm_year + 1900, sNow.tm_mon + 1, sNow.tm_mday,
+                 sNow.tm_hour, sNow.tm_min, sNow.tm_sec);
+    CPLString osSoftware("GDAL ");
+    osSoftware += GDALVersionInfo("RELEASE_NAME");
+
+    poWriter->Write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                    "<v:vfp xmlns:v=\"http://www.hsi.cz/vfp\" "
+                    "xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\">\n"
+                    "  <hlav");
+    CPLString osMissing;
+    for( size_t i = 0; i < sizeof(apszHeaderAttributes) / sizeof(apszHeaderAttributes[0]); i++ )
+    {
+        const char *pszAttr = apszHeaderAttributes[i];
+        const char *pszValue = CSLFetchNameValue(papszOptions, CPLString(pszAttr).toupper());
+        if (EQUAL(pszAttr, "ver"))
+            pszValue = VFP_SCHEMA_VERSION;
+        else if (pszValue == NULL && (EQUAL(pszAttr, "dvz") || EQUAL(pszAttr, "dkn")))
+            pszValue = osNow;
+        else if (pszValue == NULL && EQUAL(pszAttr, "sw"))
+            pszValue = osSoftware;
+
+        if (pszValue != NULL)
         {
-            CPLError(CE_Failure, CPLE_NotSupported,
-                    "OGR/VFP driver has not been built with read support. Expat library required");
+            poWriter->WriteAttribute(pszAttr, pszValue);
+            continue;
+        }
+        for( size_t j = 0; j < sizeof(apszRequired) / sizeof(apszRequired[0]); j++ )
+        {
+            if (EQUAL(pszAttr, apszRequired[j]))
+            {
+                if (!osMissing.empty())
+                    osMissing += ", ";
+                osMissing += CPLString(pszAttr).toupper();
+            }
         }
-        VSIFCloseL(fp);
     }
-#endif
-    return FALSE;
+    poWriter->Write("/>\n");
+
+    if (!osMissing.empty())
+        CPLError(CE_Warning, CPLE_AppDefined,
+                 "The %s creation options are not set, the attributes of hlav "
+                 "they give are required by the VFP schema.", osMissing.c_str());
+
+    CPLDebug("VFP", "Creating %s.", pszName);
+
+    return !poWriter->HasError();
+}
+
+/************************************************************************/
+/*                           FindLayerIndex()                           */
+/************************************************************************/
+
+int OGRVFPDataSource::FindLayerIndex( const char *pszElementName )
+
+{
+    return FindLayerIndex(OGRVFPGetToken(pszElementName));
+}
+
+int OGRVFPDataSource::FindLayerIndex( OGRVFPToken eToken )
+
+{
+    if( eToken == VFP_TOKEN_UNKNOWN )
+        return -1;
+
+    for( int i = 0; i < nLayers; i++ )
+    {
+        if( asVFPLayers[i].eToken == eToken )
+            return i;
+    }
+    return -1;
+}
+
+/************************************************************************/
+/*                           GetLayerCount()                            */
+/************************************************************************/
+
+int OGRVFPDataSource::GetLayerCount()
+
+{
+    if( poWriter != NULL )
+        return (int)apoWriterLayers.size();
+    return nLayers;
 }
 
 /************************************************************************/
 /*                              GetLayer()                              */
+/*                                                                      */
+/*      The layers are instantiated on first request, most uses of a    */
+/*      VFP file only read a few of them.                               */
 /************************************************************************/
 
 OGRLayer *OGRVFPDataSource::GetLayer( int iLayer )
 
 {
+    if( poWriter != NULL )
+    {
+        if( iLayer < 0 || iLayer >= (int)apoWriterLayers.size() )
+            return NULL;
+        return apoWriterLayers[iLayer];
+    }
+
     if( iLayer < 0 || iLayer >= nLayers )
         return NULL;
-    else
-        return papoLayers[iLayer];
+
+    if( papoLayers[iLayer] == NULL )
+        papoLayers[iLayer] = new OGRVFPLayer( pszName, &asVFPLayers[iLayer],
+                                              &asSections[iLayer], this );
+    return papoLayers[iLayer];
+}
+
+/************************************************************************/
+/*                           GetLayerByName()                           */
+/*                                                                      */
+/*      Looked up in the schema so that the other layers are not        */
+/*      instantiated.                                                   */
+/************************************************************************/
+
+OGRLayer *OGRVFPDataSource::GetLayerByName( const char *pszLayerName )
+
+{
+    if( pszLayerName == NULL )
+        return NULL;
+
+    /* the layers created so far */
+    if( poWriter != NULL )
+    {
+        for( size_t i = 0; i < apoWriterLayers.size(); i++ )
+        {
+            if( EQUAL(apoWriterLayers[i]->GetName(), pszLayerName) )
+                return apoWriterLayers[i];
+        }
+        return NULL;
+    }
+
+    for( int i = 0; i < nLayers; i++ )
+    {
+        if( EQUAL(asVFPLayers[i].pszName, pszLayerName) )
+            return GetLayer(i);
+    }
+    return NULL;
+}
+
+/************************************************************************/
+/*                            ICreateLayer()                            */
+/*                                                                      */
+/*      Only the layers of the schema can be created, each once.        */
+/************************************************************************/
+
+OGRLayer *OGRVFPDataSource::ICreateLayer( const char *pszLayerName,
+                                          OGRSpatialReference *poSRSIn,
+                                          CPL_UNUSED OGRwkbGeometryType eType,
+                                          CPL_UNUSED char **papszOptions )
+
+{
+    if( poWriter == NULL )
+    {
+        CPLError( CE_Failure, CPLE_NoWriteAccess,
+                  "Data source %s opened read-only.\n"
+                  "New layer %s cannot be created.",
+                  pszName, pszLayerName );
+        return NULL;
+    }
+
+    int iLayer = -1;
+    const int nSchemaLayers = (int)(sizeof(asVFPLayers) / sizeof(asVFPLayers[0]));
+    for( int i = 0; i < nSchemaLayers; i++ )
+    {
+        if( EQUAL(asVFPLayers[i].pszName, pszLayerName) )
+            iLayer = i;
+    }
+    if( iLayer < 0 )
+    {
+        CPLError( CE_Failure, CPLE_NotSupported,
+                  "Layer %s is not defined by the VFP schema.", pszLayerName );
+        return NULL;
+    }
+    if( GetLayerByName(pszLayerName) != NULL )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Layer %s already exists.", pszLayerName );
+        return NULL;
+    }
+
+    if( poSRSIn != NULL && GetSpatialRef() != NULL &&
+        !poSRSIn->IsSame(GetSpatialRef()) )
+        CPLError( CE_Warning, CPLE_AppDefined,
+                  "The coordinates of layer %s are written as they are, "
+                  "VFP files are in S-JTSK / Krovak East North (EPSG:5514).",
+                  pszLayerName );
+
+    OGRVFPWriterLayer *poLayer =
+        new OGRVFPWriterLayer( poWriter, iLayer, &asVFPLayers[iLayer],
+                               GetSpatialRef() );
+    apoWriterLayers.push_back(poLayer);
+    return poLayer;
+}
+
+/************************************************************************/
+/*                           TestCapability()                           */
+/************************************************************************/
+
+int OGRVFPDataSource::TestCapability( const char * pszCap )
+
+{
+    if( EQUAL(pszCap, ODsCCreateLayer) )
+        return poWriter != NULL;
+
+    if( EQUAL(pszCap, ODsCCurveGeometries) )
+        return TRUE;
+
+    return FALSE;
+}
+
+/************************************************************************/
+/*                            GetJoinWhere()                            */
+/*                                                                      */
+/*      WHERE clause with the fields given as a.x and b.y renamed to    */
+/*      those of the join result, x and "b.y". Literals and quoted      */
+/*      identifiers are copied as they are.                             */
+/************************************************************************/
+
+static bool IsIdentifierChar( char ch )
+{
+    return isalnum((unsigned char)ch) || ch == '_';
+}
+
+static CPLString GetJoinWhere( const char *pszWhere, const char *pszPrimary,
+                               const char *pszSecondary,
+                               const char *pszSecondaryLayer )
+{
+    CPLString osWhere;
+    const char *p = pszWhere;
+    while( *p != '\0' )
+    {
+        if( *p == '\'' || *p == '"' )
+        {
+            /* a doubled quote does not end it */
+            const char chQuote = *p;
+            osWhere += *p++;
+            while( *p != '\0' )
+            {
+                osWhere += *p;
+                if( *p++ == chQuote )
+                {
+                    if( *p != chQuote )
+                        break;
+                    osWhere += *p++;
+                }
+            }
+        }
+        else if( isalpha((unsigned char)*p) || *p == '_' )
+        {
+            const char *pszStart = p;
+            while( IsIdentifierChar(*p) )
+                p++;
+            CPLString osName(pszStart, p - pszStart);
+            if( *p == '.' && (isalpha((unsigned char)p[1]) || p[1] == '_') )
+            {
+                const char *pszField = ++p;
+                while( IsIdentifierChar(*p) )
+                    p++;
+                CPLString osField(pszField, p - pszField);
+                if( EQUAL(osName, pszPrimary) )
+                    osWhere += osField;
+                else if( EQUAL(osName, pszSecondary) )
+                    osWhere += CPLSPrintf("\"%s.%s\"", pszSecondaryLayer,
+                                          osField.c_str());
+                else
+                    osWhere += osName + "." + osField;
+            }
+            else
+                osWhere += osName;
+        }
+        else if( IsIdentifierChar(*p) )
+        {
+            /* a number, with its decimal point */
+            while( IsIdentifierChar(*p) || *p == '.' )
+                osWhere += *p++;
+        }
+        else
+            osWhere += *p++;
+    }
+    return osWhere;
+}
+
+/************************************************************************/
+/*                            ExecuteJoin()                             */
+/*                                                                      */
+/*      Recognizes                                                      */
+/*                                                                      */
+/*        SELECT * FROM a [LEFT] JOIN b ON a.x = b.y [WHERE ...]        */
+/*                                                                      */
+/*      on two layers of the file. The generic OGR SQL join looks up    */
+/*      the secondary layer once per primary feature with an attribute  */
+/*      filter, that is a full parse of it every time. Like OGR SQL,    */
+/*      the join is a left join with the first match, unless           */
+/*      bOneToMany (VFP dialect) where a feature is joined with all     */
+/*      its matches, JOIN and INNER JOIN drop the features without      */
+/*      any, and LEFT [OUTER] JOIN keeps them.                          */
+/************************************************************************/
+
+OGRLayer *OGRVFPDataSource::ExecuteJoin( const char *pszStatement,
+                                         bool bOneToMany )
+
+{
+    if( poWriter != NULL || !STARTS_WITH_CI(pszStatement, "SELECT") )
+        return NULL;
+
+    /* the WHERE clause is evaluated on the result, see GetJoinWhere() */
+    CPLString osStatement(pszStatement);
+    CPLString osWhere;
+    for( size_t i = 1; i + 6 < osStatement.size(); i++ )
+    {
+        if( isspace((unsigned char)osStatement[i - 1]) &&
+            EQUALN(osStatement.c_str() + i, "WHERE", 5) &&
+            isspace((unsigned char)osStatement[i + 5]) )
+        {
+            osWhere = osStatement.substr(i + 6);
+            osStatement.resize(i);
+            break;
+        }
+    }
+
+    CPLString osJoin;
+    for( size_t i = 0; i < osStatement.size(); i++ )
+    {
+        if( osStatement[i] == '=' )
+            osJoin += " = ";
+        else
+            osJoin += osStatement[i];
+    }
+
+    char **papszTokens = CSLTokenizeString2( osJoin, " \t\r\n",
+                                             CSLT_HONOURSTRINGS );
+    const int nTokens = CSLCount(papszTokens);
+    int iToken = 4;
+    bool bLeftJoin = FALSE;
+    if( nTokens >= 5 && EQUAL(papszTokens[4], "LEFT") )
+    {
+        bLeftJoin = TRUE;
+        iToken++;
+        if( bOneToMany && nTokens >= 6 && EQUAL(papszTokens[5], "OUTER") )
+            iToken++;
+    }
+    else if( bOneToMany && nTokens >= 5 && EQUAL(papszTokens[4], "INNER") )
+        iToken++;
+    if( !bOneToMany )
+        bLeftJoin = TRUE;
+
+    if( nTokens != iToken + 6 ||
+        !EQUAL(papszTokens[1], "*") || !EQUAL(papszTokens[2], "FROM") ||
+        !EQUAL(papszTokens[iToken], "JOIN") ||
+        !EQUAL(papszTokens[iToken + 2], "ON") ||
+        !EQUAL(papszTokens[iToken + 4], "=") )
+    {
+        CSLDestroy(papszTokens);
+        return NULL;
+    }
+
+    CPLString osPrimary(papszTokens[3]);
+    CPLString osSecondary(papszTokens[iToken + 1]);
+    CPLString osPrimaryKey, osSecondaryKey;
+    for( int i = iToken + 3; i <= iToken + 5; i += 2 )
+    {
+        const char *pszDot = strchr(papszTokens[i], '.');
+        if( pszDot == NULL )
+            break;
+        CPLString osTable(papszTokens[i], pszDot - papszTokens[i]);
+        if( EQUAL(osTable, osPrimary) )
+            osPrimaryKey = pszDot + 1;
+        else if( EQUAL(osTable, osSecondary) )
+            osSecondaryKey = pszDot + 1;
+    }
+    CSLDestroy(papszTokens);
+
+    if( osPrimaryKey.empty() || osSecondaryKey.empty() ||
+        EQUAL(osPrimary, osSecondary) )
+        return NULL;
+
+    /* no writer, so these are OGRVFPLayer */
+    OGRVFPLayer *poPrimary = (OGRVFPLayer *) GetLayerByName(osPrimary);
+    OGRVFPLayer *poSecondary = (OGRVFPLayer *) GetLayerByName(osSecondary);
+    if( poPrimary == NULL || poSecondary == NULL )
+        return NULL;
+
+    const int iPrimaryField =
+        poPrimary->GetLayerDefn()->GetFieldIndex(osPrimaryKey);
+    const int iSecondaryField =
+        poSecondary->GetLayerDefn()->GetFieldIndex(osSecondaryKey);
+    OGRFieldType eKeyType;
+    if( iPrimaryField < 0 || iSecondaryField < 0 ||
+        !OGRVFPJoinLayer::GetKeyType(
+            poPrimary->GetLayerDefn()->GetFieldDefn(iPrimaryField)->GetType(),
+            poSecondary->GetLayerDefn()->GetFieldDefn(iSecondaryField)->GetType(),
+            &eKeyType) )
+        return NULL;
+
+    OGRLayer *poLayer = new OGRVFPJoinLayer( poPrimary, iPrimaryField,
+                                             poSecondary, iSecondaryField,
+                                             bLeftJoin, bOneToMany );
+    if( !osWhere.empty() )
+    {
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        const OGRErr eErr = poLayer->SetAttributeFilter(
+            GetJoinWhere(osWhere, osPrimary, osSecondary, poSecondary->GetName()));
+        CPLPopErrorHandler();
+        if( eErr != OGRERR_NONE )
+        {
+            CPLDebug( "VFP", "%s: WHERE clause not supported by the join, "
+                      "using OGR SQL", osWhere.c_str() );
+            delete poLayer;
+            return NULL;
+        }
+    }
+
+    return poLayer;
+}
+
+/************************************************************************/
+/*                             ExecuteSQL()                             */
+/*                                                                      */
+/*      The joins of OGR SQL run by ExecuteJoin() keep their result.    */
+/*      The VFP dialect only has the one to many joins.                 */
+/************************************************************************/
+
+OGRLayer *OGRVFPDataSource::ExecuteSQL( const char *pszStatement,
+                                        OGRGeometry *poSpatialFilter,
+                                        const char *pszDialect )
+
+{
+    const bool bVFPDialect = pszDialect != NULL && EQUAL(pszDialect, "VFP");
+    if( bVFPDialect || pszDialect == NULL || EQUAL(pszDialect, "") ||
+        EQUAL(pszDialect, "OGRSQL") )
+    {
+        OGRLayer *poLayer = ExecuteJoin( pszStatement, bVFPDialect );
+        if( poLayer != NULL )
+        {
+            if( poSpatialFilter != NULL )
+                poLayer->SetSpatialFilter( poSpatialFilter );
+            return poLayer;
+        }
+    }
+
+    if( bVFPDialect )
+    {
+        CPLError( CE_Failure, CPLE_NotSupported,
+                  "The VFP dialect only supports SELECT * FROM a "
+                  "[INNER | LEFT [OUTER]] JOIN b ON a.x = b.y [WHERE ...] "
+                  "on two string or two numeric fields: %s", pszStatement );
+        return NULL;
+    }
+
+    return OGRDataSource::ExecuteSQL( pszStatement, poSpatialFilter,
+                                      pszDialect );
 }
@@ -32,6 +32,33 @@
 
 CPL_CVSID("$Id$");
 
+/************************************************************************/
+/*                              Identify()                              */
+/*                                                                      */
+/*      Only the header bytes read by GDALOpenInfo are looked at, more  */
+/*      are read only if they end before the root element.              */
+/************************************************************************/
+
+static int OGRVFPDriverIdentify( GDALOpenInfo* poOpenInfo )
+
+{
+    if( poOpenInfo->fpL == NULL || poOpenInfo->nHeaderBytes == 0 )
+        return FALSE;
+
+    OGRVFPSniffResult eSniff =
+        OGRVFPSniffHeader( (const char*)poOpenInfo->pabyHeader,
+                           poOpenInfo->nHeaderBytes, NULL );
+    if( eSniff == VFP_SNIFF_NEED_MORE &&
+        poOpenInfo->nHeaderBytes < VFP_SNIFF_MAX_BYTES &&
+        poOpenInfo->TryToIngest( VFP_SNIFF_MAX_BYTES ) )
+    {
+        eSniff = OGRVFPSniffHeader( (const char*)poOpenInfo->pabyHeader,
+                                    poOpenInfo->nHeaderBytes, NULL );
+    }
+
+    return eSniff == VFP_SNIFF_VFP;
+}
+
 /************************************************************************/
 /*                                Open()                                */
 /************************************************************************/
@@ -39,15 +66,12 @@ CPL_CVSID("$Id$");
 static GDALDataset *OGRVFPDriverOpen( GDALOpenInfo* poOpenInfo )
 
 {
-    if( poOpenInfo->eAccess == GA_Update || poOpenInfo->fpL == NULL )
-        return NULL;
-
-    if( strstr((const char*)poOpenInfo->pabyHeader, "<v:vfp") == NULL )
+    if( poOpenInfo->eAccess == GA_Update || !OGRVFPDriverIdentify( poOpenInfo ) )
         return NULL;
 
     OGRVFPDataSource   *poDS = new OGRVFPDataSource();
 
-    if( !poDS->Open( poOpenInfo->pszFilename, FALSE ) )
+    if( !poDS->Open( poOpenInfo ) )
     {
         delete poDS;
         poDS = NULL;
@@ -56,6 +80,27 @@ static GDALDataset *OGRVFPDriverOpen( GDALOpenInfo* poOpenInfo )
     return poDS;
 }
 
+/************************************************************************/
+/*                               Create()                               */
+/************************************************************************/
+
+static GDALDataset *OGRVFPDriverCreate( const char * pszName,
+                                        CPL_UNUSED int nBands,
+                                        CPL_UNUSED int nXSize,
+                                        CPL_UNUSED int nYSize,
+                                        CPL_UNUSED GDALDataType eDT,
+                                        char **papszOptions )
+{
+    OGRVFPDataSource   *poDS = new OGRVFPDataSource();
+
+    if( !poDS->Create( pszName, papszOptions ) )
+    {
+        delete poDS;
+        poDS = NULL;
+    }
+
+    return poDS;
+}
 
 /************************************************************************/
 /*                               Delete()                               */
@@ -64,6 +109,15 @@ static GDALDataset *OGRVFPDriverOpen( GDALOpenInfo* poOpenInfo )
 static CPLErr OGRVFPDriverDelete( const char *pszFilename )
 
 {
+    VSIStatBufL sStatBuf;
+    const char *pszIndexFilename = OGRVFPDataSource::GetIndexFilename( pszFilename );
+    if( VSIStatL( pszIndexFilename, &sStatBuf ) == 0 )
+        VSIUnlink( pszIndexFilename );
+
+    /* spatial indexes and feature caches of the layers,
+       <file>.<layer>.vfpr and <file>.<layer>.vfpc */
+    OGRVFPDataSource::DeleteLayerFiles( pszFilename );
+
     if( VSIUnlink( pszFilename ) == 0 )
         return CE_None;
     else
@@ -94,8 +148,54 @@ void RegisterOGRVFP()
                                    "drv_vfp.html" );
 
         poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
+        poDriver->SetMetadataItem( GDAL_DCAP_CURVE_GEOMETRIES, "YES" );
+
+        poDriver->SetMetadataItem( GDAL_DMD_OPENOPTIONLIST,
+"<OpenOptionList>"
+"  <Option name='INDEX' type='boolean' description='Whether to use and write the .vfpi index file with byte offsets of the layers' default='YES'/>"
+"  <Option name='READ_CHUNK_SIZE' type='int' description='Number of bytes read from the file and passed to the XML parser at once' default='262144'/>"
+"  <Option name='USE_MMAP' type='boolean' description='Whether to parse local files from a memory mapping instead of reading them' default='YES'/>"
+"  <Option name='FEATURE_QUEUE_SIZE' type='int' description='Maximum number of parsed features buffered by a layer' default='100'/>"
+"  <Option name='PARSER_THREADS' type='boolean' description='Whether to parse the file in a background thread of each layer' default='NO'/>"
+"  <Option name='NUM_THREADS' type='string' description='Number of threads parsing a layer concurrently (integer or ALL_CPUS)' default='1'/>"
+"  <Option name='LINEARIZE' type='boolean' description='Whether to approximate arcs and circles with line strings' default='NO'/>"
+"  <Option name='MAX_ANGLE_STEP' type='float' description='Largest step in degrees along an arc when linearizing, 0 to use OGR_ARC_STEPSIZE' default='0'/>"
+"  <Option name='SPATIAL_INDEX' type='string-select' description='Whether to use a .vfpr spatial index, built on the first spatial query (AUTO) or when opening the file (YES)' default='AUTO'>"
+"    <Value>AUTO</Value>"
+"    <Value>YES</Value>"
+"    <Value>NO</Value>"
+"  </Option>"
+"  <Option name='FEATURE_CACHE' type='boolean' description='Whether to write a .vfpc binary cache of the features of each layer read completely, and read the features from it' default='NO'/>"
+"  <Option name='STATS' type='boolean' description='Whether to time the phases of the parsing, reported in the VFP_STATS metadata domain' default='NO'/>"
+"</OpenOptionList>");
+
+        poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
+"<CreationOptionList>"
+"  <Option name='DVZ' type='string' description='Date and time of the creation of the data (hlav/@dvz), YYYY-MM-DDTHH:MM:SS. Defaults to now'/>"
+"  <Option name='DKN' type='string' description='Date and time of the cadastral data (hlav/@dkn), YYYY-MM-DDTHH:MM:SS. Defaults to now'/>"
+"  <Option name='AUT' type='string' description='Author of the data (hlav/@aut)'/>"
+"  <Option name='ET' type='string' description='Stage of the land consolidation (hlav/@et)'/>"
+"  <Option name='KK' type='int' description='Code of the cadastral area (hlav/@kk)'/>"
+"  <Option name='TYP' type='string-select' description='Type of the land consolidation (hlav/@typ)'>"
+"    <Value>kopu</Value>"
+"    <Value>jpu</Value>"
+"  </Option>"
+"  <Option name='CPU' type='int' description='Number of the land consolidation (hlav/@cpu)'/>"
+"  <Option name='OCV' type='string' description='hlav/@ocv, as month/year'/>"
+"  <Option name='KV' type='float' description='hlav/@kv coefficient'/>"
+"  <Option name='KSZ' type='float' description='hlav/@ksz coefficient'/>"
+"  <Option name='SW' type='string' description='Software that created the data (hlav/@sw). Defaults to GDAL and its version'/>"
+"  <Option name='SX' type='float' description='hlav/@sx coordinate'/>"
+"  <Option name='SY' type='float' description='hlav/@sy coordinate'/>"
+"  <Option name='WRITE_BUFFER_SIZE' type='int' description='Number of bytes formatted in memory before they are written to the file' default='1048576'/>"
+"</CreationOptionList>");
+
+        poDriver->SetMetadataItem( GDAL_DMD_CREATIONFIELDDATATYPES,
+                                   "Integer Integer64 Real String" );
 
         poDriver->pfnOpen = OGRVFPDriverOpen;
+        poDriver->pfnIdentify = OGRVFPDriverIdentify;
+        poDriver->pfnCreate = OGRVFPDriverCreate;
         poDriver->pfnDelete = OGRVFPDriverDelete;
 
         GetGDALDriverManager()->RegisterDriver( poDriver );
@@ -0,0 +1,808 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  VFP Translator
+ * Purpose:  Implements OGRVFPGeometryBuilder class.
+ * Author:   Martin Landa, landa.martin gmail.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, Martin Landa <landa.martin gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ogr_vfp.h"
+#include "cpl_conv.h"
+#include "cpl_string.h"
+
+CPL_CVSID("$Id$");
+
+/************************************************************************/
+/*                       OGRVFPGeometryBuilder()                        */
+/************************************************************************/
+
+OGRVFPGeometryBuilder::OGRVFPGeometryBuilder( bool bLinearizeIn,
+                                              double dfMaxAngleStepIn,
+                                              OGRVFPArena *poArenaIn )
+{
+    bLinearize = bLinearizeIn;
+    dfMaxAngleStep = dfMaxAngleStepIn;
+    poArena = poArenaIn;
+
+    nRegions = 0;
+    bHas3D = FALSE;
+    bHasEnvelope = FALSE;
+
+    bInSegment = FALSE;
+    iCurPath = -1;
+    iCurRegion = -1;
+}
+
+/************************************************************************/
+/*                       ~OGRVFPGeometryBuilder()                       */
+/************************************************************************/
+
+OGRVFPGeometryBuilder::~OGRVFPGeometryBuilder()
+
+{
+}
+
+/************************************************************************/
+/*                               Reset()                                */
+/************************************************************************/
+
+void OGRVFPGeometryBuilder::Reset()
+
+{
+    adfX.resize(0);
+    adfY.resize(0);
+    adfZ.resize(0);
+    anPartStart.resize(0);
+    abPartIsArc.resize(0);
+    asPaths.resize(0);
+    nRegions = 0;
+    bHas3D = FALSE;
+    bHasEnvelope = FALSE;
+
+    bInSegment = FALSE;
+    iCurPath = -1;
+    iCurRegion = -1;
+}
+
+/************************************************************************/
+/*                             GetXSIType()                             */
+/*                                                                      */
+/*      Value of the xsi:type attribute without its namespace prefix.   */
+/************************************************************************/
+
+static const char *GetXSIType( const char **ppszAttr )
+{
+    for( int i = 0; ppszAttr[i] != NULL; i += 2 )
+    {
+        if( strcmp(ppszAttr[i], "xsi:type") == 0 )
+        {
+            const char *pszType = strchr(ppszAttr[i + 1], ':');
+            return pszType ? pszType + 1 : ppszAttr[i + 1];
+        }
+    }
+    return "";
+}
+
+/************************************************************************/
+/*                            OGRVFPStrtod()                            */
+/*                                                                      */
+/*      Locale independent conversion of the decimal numbers used for   */
+/*      coordinates, e.g. "-744185.31". A number with at most 15        */
+/*      significant digits and no exponent is computed as an exact      */
+/*      integer divided by an exact power of ten, which gives the       */
+/*      correctly rounded double without any allocation. Other          */
+/*      numbers are passed to CPLStrtod().                              */
+/************************************************************************/
+
+double OGRVFPStrtod( const char *pszStr, char **ppszEnd )
+{
+    static const double adfPow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const char *p = pszStr;
+    while( *p == ' ' || *p == '\t' || *p == '\n' || *p == '\r' )
+        p++;
+
+    bool bNegative = FALSE;
+    if( *p == '-' )
+    {
+        bNegative = TRUE;
+        p++;
+    }
+    else if( *p == '+' )
+        p++;
+
+    GUIntBig nMantissa = 0;
+    int nSignificantDigits = 0;
+    int nFractionDigits = 0;
+    const char *pszDigits = p;
+
+    for( ; *p >= '0' && *p <= '9'; p++ )
+    {
+        nMantissa = nMantissa * 10 + (*p - '0');
+        if( nMantissa != 0 )
+            nSignificantDigits++;
+    }
+    if( *p == '.' )
+    {
+        for( p++; *p >= '0' && *p <= '9'; p++ )
+        {
+            nMantissa = nMantissa * 10 + (*p - '0');
+            if( nMantissa != 0 )
+                nSignificantDigits++;
+            nFractionDigits++;
+        }
+    }
+
+    /* 10^15 < 2^53: the mantissa is exact, and so is 10^n for n <= 22 */
+    if( nSignificantDigits > 15 || nFractionDigits > 22 ||
+        p == pszDigits || (p == pszDigits + 1 && *pszDigits == '.') ||
+        *p == 'e' || *p == 'E' )
+        return CPLStrtod(pszStr, ppszEnd);
+
+    if( ppszEnd != NULL )
+        *ppszEnd = (char *) p;
+
+    const double dfValue = (double) nMantissa / adfPow10[nFractionDigits];
+    return bNegative ? -dfValue : dfValue;
+}
+
+/************************************************************************/
+/*                               AddXYZ()                               */
+/************************************************************************/
+
+void OGRVFPGeometryBuilder::AddXYZ( double dfX, double dfY, double dfZ )
+{
+    adfX.push_back(dfX);
+    adfY.push_back(dfY);
+    adfZ.push_back(dfZ);
+
+    if( !bHasEnvelope )
+    {
+        sEnvelope.MinX = sEnvelope.MaxX = dfX;
+        sEnvelope.MinY = sEnvelope.MaxY = dfY;
+        bHasEnvelope = TRUE;
+    }
+    else
+    {
+        if( dfX < sEnvelope.MinX ) sEnvelope.MinX = dfX;
+        else if( dfX > sEnvelope.MaxX ) sEnvelope.MaxX = dfX;
+        if( dfY < sEnvelope.MinY ) sEnvelope.MinY = dfY;
+        else if( dfY > sEnvelope.MaxY ) sEnvelope.MaxY = dfY;
+    }
+}
+
+/************************************************************************/
+/*                           AddCoordinate()                            */
+/*                                                                      */
+/*      Append the x, y and optional z attributes of a c element to     */
+/*      the point buffer. The buffer is kept between records, so it     */
+/*      does not allocate once it has grown.                            */
+/************************************************************************/
+
+void OGRVFPGeometryBuilder::AddCoordinate( const char **ppszAttr )
+{
+    double dfX = 0.0, dfY = 0.0, dfZ = 0.0;
+
+    for( int i = 0; ppszAttr[i] != NULL; i += 2 )
+    {
+        const char *pszAttr = ppszAttr[i];
+        if( pszAttr[0] == '\0' || pszAttr[1] != '\0' )
+            continue;
+        if( pszAttr[0] == 'x' )
+            dfX = OGRVFPStrtod(ppszAttr[i + 1], NULL);
+        else if( pszAttr[0] == 'y' )
+            dfY = OGRVFPStrtod(ppszAttr[i + 1], NULL);
+        else if( pszAttr[0] == 'z' )
+        {
+            dfZ = OGRVFPStrtod(ppszAttr[i + 1], NULL);
+            bHas3D = TRUE;
+        }
+    }
+
+    AddXYZ(dfX, dfY, dfZ);
+}
+
+/************************************************************************/
+/*                             StartPath()                              */
+/************************************************************************/
+
+void OGRVFPGeometryBuilder::StartPath( int eType )
+{
+    OGRVFPPath sPath;
+
+    sPath.eType = eType;
+    sPath.nFirstPoint = sPath.nEndPoint = (int)adfX.size();
+    sPath.nFirstPart = sPath.nEndPart = (int)anPartStart.size();
+    sPath.iRegion = (eType == VFP_PATH_RING || eType == VFP_PATH_CIRCLE) ?
+        iCurRegion : -1;
+    sPath.dfRadius = 0.0;
+
+    asPaths.push_back(sPath);
+    iCurPath = (int)asPaths.size() - 1;
+}
+
+/************************************************************************/
+/*                            StartElement()                            */
+/************************************************************************/
+
+void OGRVFPGeometryBuilder::StartElement( OGRVFPToken eToken,
+                                          const char **ppszAttr )
+{
+    switch( eToken )
+    {
+        case VFP_TOKEN_C:
+            if( iCurPath >= 0 &&
+                (bInSegment || asPaths[iCurPath].eType != VFP_PATH_LINE) )
+            {
+                AddCoordinate(ppszAttr);
+            }
+            else
+            {
+                /* point of a cell (b), a text (t) or a point record */
+                StartPath(VFP_PATH_POINT);
+                AddCoordinate(ppszAttr);
+                asPaths[iCurPath].nEndPoint = (int)adfX.size();
+                iCurPath = -1;
+            }
+            break;
+
+        case VFP_TOKEN_SEGMENT:
+        case VFP_TOKEN_SE:
+        case VFP_TOKEN_AR:
+            if( iCurPath >= 0 )
+            {
+                bInSegment = TRUE;
+                anPartStart.push_back((int)adfX.size());
+                abPartIsArc.push_back(eToken == VFP_TOKEN_AR ||
+                                      OGRVFPGetToken(GetXSIType(ppszAttr)) == VFP_TOKEN_AR);
+            }
+            break;
+
+        case VFP_TOKEN_POLYGON:
+        case VFP_TOKEN_LINPOL:
+        case VFP_TOKEN_CIRCLE:
+        {
+            const bool bCircle = eToken == VFP_TOKEN_CIRCLE ||
+                                 OGRVFPGetToken(GetXSIType(ppszAttr)) == VFP_TOKEN_CIRCLE;
+            StartPath(bCircle ? VFP_PATH_CIRCLE : VFP_PATH_RING);
+            for( int i = 0; ppszAttr[i] != NULL; i += 2 )
+            {
+                if( strcmp(ppszAttr[i], "r") == 0 )
+                    asPaths[iCurPath].dfRadius = OGRVFPStrtod(ppszAttr[i + 1], NULL);
+            }
+            break;
+        }
+
+        case VFP_TOKEN_LIN:
+            StartPath(VFP_PATH_LINE);
+            break;
+
+        case VFP_TOKEN_REG:
+            iCurRegion = nRegions++;
+            break;
+
+        default:
+        {
+            /* sou and psou points are given as attributes */
+            const char *pszSX = NULL, *pszSY = NULL, *pszSZ = NULL;
+            for( int i = 0; ppszAttr[i] != NULL; i += 2 )
+            {
+                if( strcmp(ppszAttr[i], "sx") == 0 )
+                    pszSX = ppszAttr[i + 1];
+                else if( strcmp(ppszAttr[i], "sy") == 0 )
+                    pszSY = ppszAttr[i + 1];
+                else if( strcmp(ppszAttr[i], "sz") == 0 )
+                    pszSZ = ppszAttr[i + 1];
+            }
+            if( pszSX != NULL && pszSY != NULL && iCurPath < 0 )
+            {
+                StartPath(VFP_PATH_POINT);
+                if( pszSZ != NULL )
+                    bHas3D = TRUE;
+                AddXYZ(OGRVFPStrtod(pszSX, NULL), OGRVFPStrtod(pszSY, NULL),
+                       pszSZ != NULL ? OGRVFPStrtod(pszSZ, NULL) : 0.0);
+                asPaths[iCurPath].nEndPoint = (int)adfX.size();
+                iCurPath = -1;
+            }
+            break;
+        }
+    }
+}
+
+/************************************************************************/
+/*                             EndElement()                             */
+/************************************************************************/
+
+void OGRVFPGeometryBuilder::EndElement( OGRVFPToken eToken )
+{
+    switch( eToken )
+    {
+        case VFP_TOKEN_SEGMENT:
+        case VFP_TOKEN_SE:
+        case VFP_TOKEN_AR:
+            if( bInSegment && abPartIsArc.back() )
+                MergeArcEnvelope(anPartStart.back(), (int)adfX.size());
+            bInSegment = FALSE;
+            break;
+
+        case VFP_TOKEN_POLYGON:
+        case VFP_TOKEN_LINPOL:
+        case VFP_TOKEN_CIRCLE:
+        case VFP_TOKEN_LIN:
+        {
+            if( iCurPath < 0 )
+                break;
+
+            OGRVFPPath *psPath = &asPaths[iCurPath];
+            psPath->nEndPoint = (int)adfX.size();
+            psPath->nEndPart = (int)anPartStart.size();
+
+            /* the envelope of a circle is not given by its center */
+            if( psPath->eType == VFP_PATH_CIRCLE &&
+                psPath->nEndPoint > psPath->nFirstPoint )
+            {
+                const double dfX = adfX[psPath->nFirstPoint];
+                const double dfY = adfY[psPath->nFirstPoint];
+                const double dfR = psPath->dfRadius;
+                if( dfX - dfR < sEnvelope.MinX ) sEnvelope.MinX = dfX - dfR;
+                if( dfX + dfR > sEnvelope.MaxX ) sEnvelope.MaxX = dfX + dfR;
+                if( dfY - dfR < sEnvelope.MinY ) sEnvelope.MinY = dfY - dfR;
+                if( dfY + dfR > sEnvelope.MaxY ) sEnvelope.MaxY = dfY + dfR;
+            }
+            iCurPath = -1;
+            break;
+        }
+
+        case VFP_TOKEN_REG:
+            iCurRegion = -1;
+            break;
+
+        default:
+            break;
+    }
+}
+
+/************************************************************************/
+/*                          MergeArcEnvelope()                          */
+/*                                                                      */
+/*      An arc may bulge out of the envelope of its start, middle and   */
+/*      end points: merge the envelope of the full circle through       */
+/*      them. It is larger than needed, which is fine for filtering.    */
+/************************************************************************/
+
+void OGRVFPGeometryBuilder::MergeArcEnvelope( int nStart, int nEnd )
+{
+    for( int i = nStart; i + 2 < nEnd; i += 2 )
+    {
+        /* relative to the start point to keep the precision */
+        const double dfX1 = adfX[i + 1] - adfX[i], dfY1 = adfY[i + 1] - adfY[i];
+        const double dfX2 = adfX[i + 2] - adfX[i], dfY2 = adfY[i + 2] - adfY[i];
+        const double dfD = 2.0 * (dfX1 * dfY2 - dfY1 * dfX2);
+        if( dfD == 0.0 )
+            continue;
+
+        const double dfS1 = dfX1 * dfX1 + dfY1 * dfY1;
+        const double dfS2 = dfX2 * dfX2 + dfY2 * dfY2;
+        const double dfCX = (dfY2 * dfS1 - dfY1 * dfS2) / dfD;
+        const double dfCY = (dfX1 * dfS2 - dfX2 * dfS1) / dfD;
+        const double dfR = sqrt(dfCX * dfCX + dfCY * dfCY);
+
+        const double dfX = adfX[i] + dfCX, dfY = adfY[i] + dfCY;
+        if( dfX - dfR < sEnvelope.MinX ) sEnvelope.MinX = dfX - dfR;
+        if( dfX + dfR > sEnvelope.MaxX ) sEnvelope.MaxX = dfX + dfR;
+        if( dfY - dfR < sEnvelope.MinY ) sEnvelope.MinY = dfY - dfR;
+        if( dfY + dfR > sEnvelope.MaxY ) sEnvelope.MaxY = dfY + dfR;
+    }
+}
+
+/************************************************************************/
+/*                             Intersects()                             */
+/*                                                                      */
+/*      Whether the envelope of all the coordinates of the record       */
+/*      intersects sFilter. A record without coordinates does not.      */
+/************************************************************************/
+
+bool OGRVFPGeometryBuilder::Intersects( const OGREnvelope &sFilter ) const
+{
+    return bHasEnvelope && sEnvelope.Intersects(sFilter);
+}
+
+/************************************************************************/
+/*                            GetEnvelope()                             */
+/************************************************************************/
+
+bool OGRVFPGeometryBuilder::GetEnvelope( OGREnvelope *psEnvelope ) const
+{
+    if( !bHasEnvelope )
+        return FALSE;
+    *psEnvelope = sEnvelope;
+    return TRUE;
+}
+
+/************************************************************************/
+/*                           CompactPoints()                            */
+/*                                                                      */
+/*      Consecutive segments share their end points: remove the         */
+/*      repeated points of [nStart, nEnd) in place, which is fine as    */
+/*      a path is built only once. Returns the number of points kept.   */
+/************************************************************************/
+
+int OGRVFPGeometryBuilder::CompactPoints( int nStart, int nEnd )
+{
+    if( nEnd <= nStart )
+        return 0;
+
+    double *padfX = &adfX[nStart];
+    double *padfY = &adfY[nStart];
+    double *padfZ = &adfZ[nStart];
+    int nOut = 1;
+    for( int i = 1; i < nEnd - nStart; i++ )
+    {
+        if( padfX[i] == padfX[nOut - 1] && padfY[i] == padfY[nOut - 1] )
+            continue;
+        padfX[nOut] = padfX[i];
+        padfY[nOut] = padfY[i];
+        padfZ[nOut] = padfZ[i];
+        nOut++;
+    }
+    return nOut;
+}
+
+/************************************************************************/
+/*                             SetPoints()                              */
+/*                                                                      */
+/*      Fill a curve with nCount points of the buffer in one exactly    */
+/*      sized allocation. If bClose is set and the points are not       */
+/*      closed, the first point is appended through scratch arrays      */
+/*      of the arena instead of growing the curve with addPoint().      */
+/************************************************************************/
+
+void OGRVFPGeometryBuilder::SetPoints( OGRSimpleCurve *poCurve, int nStart,
+                                       int nCount, bool bClose )
+{
+    double *padfX = &adfX[nStart];
+    double *padfY = &adfY[nStart];
+    double *padfZ = &adfZ[nStart];
+    const int nLast = nStart + nCount - 1;
+
+    if( bClose && (adfX[nStart] != adfX[nLast] || adfY[nStart] != adfY[nLast]) )
+    {
+        const size_t nSize = (nCount + 1) * sizeof(double);
+        padfX = (double *) memcpy(poArena->Alloc(nSize), padfX, nSize - sizeof(double));
+        padfY = (double *) memcpy(poArena->Alloc(nSize), padfY, nSize - sizeof(double));
+        padfZ = (double *) memcpy(poArena->Alloc(nSize), padfZ, nSize - sizeof(double));
+        padfX[nCount] = padfX[0];
+        padfY[nCount] = padfY[0];
+        padfZ[nCount] = padfZ[0];
+        nCount++;
+    }
+
+    poCurve->setPoints(nCount, padfX, padfY, bHas3D ? padfZ : NULL);
+}
+
+/************************************************************************/
+/*                             BuildPath()                              */
+/*                                                                      */
+/*      Build a curve from the segments of a lin or linpol polygon.     */
+/*      Consecutive se segments are merged into one line string, ar     */
+/*      segments become circular strings of a compound curve. A path    */
+/*      of se segments only is returned as a line string, or as a       */
+/*      linear ring if bRing is set.                                    */
+/************************************************************************/
+
+OGRCurve *OGRVFPGeometryBuilder::BuildPath( OGRVFPPath *psPath, bool bRing )
+{
+    const int nFirst = psPath->nFirstPoint;
+    const int nEnd = psPath->nEndPoint;
+    const int nFirstPart = psPath->nFirstPart;
+    const int nParts = psPath->nEndPart - nFirstPart;
+    OGRCurve *poRet = NULL;
+
+    bool bHasArcs = FALSE;
+    for( int iPart = 0; iPart < nParts; iPart++ )
+    {
+        if( abPartIsArc[nFirstPart + iPart] )
+            bHasArcs = TRUE;
+    }
+
+    if( nEnd - nFirst >= 2 && !bHasArcs )
+    {
+        const int nOut = CompactPoints(nFirst, nEnd);
+        if( nOut >= 2 )
+        {
+            OGRLineString *poLS = bRing ? new OGRLinearRing() : new OGRLineString();
+            SetPoints(poLS, nFirst, nOut, bRing);
+            poRet = poLS;
+        }
+    }
+    else if( nEnd - nFirst >= 2 )
+    {
+        OGRCompoundCurve *poCC = new OGRCompoundCurve();
+        OGRPoint oEnd;
+        double adfGapX[2], adfGapY[2], adfGapZ[2];
+
+        /* the parts are split into runs of se segments, which give one
+           line string, and single ar segments */
+        for( int iPart = 0; iPart < nParts; )
+        {
+            const int nStart = anPartStart[nFirstPart + iPart];
+            int nStop = (iPart + 1 < nParts) ? anPartStart[nFirstPart + iPart + 1] : nEnd;
+            /* an arc is given by its start, middle and end points */
+            const bool bArc = abPartIsArc[nFirstPart + iPart] &&
+                              (nStop - nStart) >= 3 && (nStop - nStart) % 2 == 1;
+            iPart++;
+            if( !bArc )
+            {
+                while( iPart < nParts )
+                {
+                    const int nNextStop = (iPart + 1 < nParts) ?
+                        anPartStart[nFirstPart + iPart + 1] : nEnd;
+                    if( abPartIsArc[nFirstPart + iPart] &&
+                        (nNextStop - nStop) >= 3 && (nNextStop - nStop) % 2 == 1 )
+                        break;
+                    nStop = nNextStop;
+                    iPart++;
+                }
+            }
+
+            const int nCount = bArc ? nStop - nStart : CompactPoints(nStart, nStop);
+            if( nCount == 0 )
+                continue;
+
+            if( poCC->getNumCurves() > 0 )
+            {
+                /* keep the compound curve continuous */
+                poCC->EndPoint(&oEnd);
+                if( oEnd.getX() != adfX[nStart] || oEnd.getY() != adfY[nStart] )
+                {
+                    OGRLineString *poGap = new OGRLineString();
+                    adfGapX[0] = oEnd.getX();
+                    adfGapY[0] = oEnd.getY();
+                    adfGapZ[0] = oEnd.getZ();
+                    adfGapX[1] = adfX[nStart];
+                    adfGapY[1] = adfY[nStart];
+                    adfGapZ[1] = adfZ[nStart];
+                    poGap->setPoints(2, adfGapX, adfGapY, bHas3D ? adfGapZ : NULL);
+                    if( poCC->addCurveDirectly(poGap) != OGRERR_NONE )
+                        delete poGap;
+                }
+            }
+
+            if( nCount < 2 )
+                continue;
+            OGRSimpleCurve *poPart = bArc ? (OGRSimpleCurve *) new OGRCircularString()
+                                          : (OGRSimpleCurve *) new OGRLineString();
+            SetPoints(poPart, nStart, nCount, FALSE);
+            if( poCC->addCurveDirectly(poPart) != OGRERR_NONE )
+                delete poPart;
+        }
+
+        if( bRing && poCC->getNumCurves() > 0 && !poCC->get_IsClosed() )
+        {
+            OGRPoint oStart;
+            poCC->StartPoint(&oStart);
+            poCC->EndPoint(&oEnd);
+            OGRLineString *poClose = new OGRLineString();
+            adfGapX[0] = oEnd.getX();
+            adfGapY[0] = oEnd.getY();
+            adfGapZ[0] = oEnd.getZ();
+            adfGapX[1] = oStart.getX();
+            adfGapY[1] = oStart.getY();
+            adfGapZ[1] = oStart.getZ();
+            poClose->setPoints(2, adfGapX, adfGapY, bHas3D ? adfGapZ : NULL);
+            if( poCC->addCurveDirectly(poClose) != OGRERR_NONE )
+                delete poClose;
+        }
+
+        if( poCC->getNumCurves() > 0 )
+            poRet = poCC;
+        else
+            delete poCC;
+    }
+
+    return poRet;
+}
+
+/************************************************************************/
+/*                            BuildCircle()                             */
+/*                                                                      */
+/*      A full circle is a closed circular string whose middle point    */
+/*      is opposite to its start point.                                 */
+/************************************************************************/
+
+OGRCurve *OGRVFPGeometryBuilder::BuildCircle( const OGRVFPPath *psPath )
+{
+    if( psPath->nEndPoint == psPath->nFirstPoint || psPath->dfRadius <= 0.0 )
+        return NULL;
+
+    const double dfX = adfX[psPath->nFirstPoint];
+    const double dfY = adfY[psPath->nFirstPoint];
+    const double dfZ = adfZ[psPath->nFirstPoint];
+    const double dfRadius = psPath->dfRadius;
+    double adfCX[3] = { dfX + dfRadius, dfX - dfRadius, dfX + dfRadius };
+    double adfCY[3] = { dfY, dfY, dfY };
+    double adfCZ[3] = { dfZ, dfZ, dfZ };
+
+    OGRCircularString *poCS = new OGRCircularString();
+    poCS->setPoints(3, adfCX, adfCY, bHas3D ? adfCZ : NULL);
+
+    return poCS;
+}
+
+/************************************************************************/
+/*                            BuildRegion()                             */
+/*                                                                      */
+/*      The solid polygon is the exterior ring, the polygons of holes   */
+/*      the interior rings. A region with linear rings only is          */
+/*      returned as a plain polygon.                                    */
+/************************************************************************/
+
+OGRGeometry *OGRVFPGeometryBuilder::BuildRegion( int iFirstPath, int iEndPath )
+{
+    bool bLinear = TRUE;
+
+    apoRings.resize(0);
+    for( int i = iFirstPath; i < iEndPath; i++ )
+    {
+        OGRVFPPath *psPath = &asPaths[i];
+        OGRCurve *poRing = psPath->eType == VFP_PATH_CIRCLE ?
+            BuildCircle(psPath) : BuildPath(psPath, TRUE);
+        if( poRing == NULL )
+            continue;
+        if( wkbFlatten(poRing->getGeometryType()) != wkbLineString )
+            bLinear = FALSE;
+        apoRings.push_back(poRing);
+    }
+
+    if( apoRings.empty() )
+        return NULL;
+
+    OGRCurvePolygon *poSurface = NULL;
+    if( bLinear )
+    {
+        OGRPolygon *poPolygon = new OGRPolygon();
+        for( size_t i = 0; i < apoRings.size(); i++ )
+            poPolygon->addRingDirectly(apoRings[i]);
+        poSurface = poPolygon;
+    }
+    else
+    {
+        poSurface = new OGRCurvePolygon();
+        for( size_t i = 0; i < apoRings.size(); i++ )
+        {
+            OGRCurve *poRing = apoRings[i];
+            /* linear rings are not allowed in curve polygons */
+            if( wkbFlatten(poRing->getGeometryType()) == wkbLineString )
+                poRing = OGRCurve::CastToLineString(poRing);
+            if( poSurface->addRingDirectly(poRing) != OGRERR_NONE )
+                delete poRing;
+        }
+    }
+    apoRings.resize(0);
+
+    return poSurface;
+}
+
+/************************************************************************/
+/*                            GetGeometry()                             */
+/*                                                                      */
+/*      Geometry of the record, the caller takes ownership. Regions     */
+/*      take precedence over lines and lines over points, e.g. the      */
+/*      label point of a parcel area is not part of its geometry.       */
+/************************************************************************/
+
+OGRGeometry *OGRVFPGeometryBuilder::GetGeometry()
+{
+    const int nPaths = (int)asPaths.size();
+    OGRGeometryCollection *poColl = NULL;
+    bool bLinear = TRUE;
+
+    apoGeoms.resize(0);
+
+    /* the polygons of a reg are consecutive paths */
+    for( int i = 0; i < nPaths; )
+    {
+        int j = i + 1;
+        if( asPaths[i].iRegion >= 0 )
+        {
+            while( j < nPaths && asPaths[j].iRegion == asPaths[i].iRegion )
+                j++;
+            OGRGeometry *poSurface = BuildRegion(i, j);
+            if( poSurface != NULL )
+            {
+                if( wkbFlatten(poSurface->getGeometryType()) != wkbPolygon )
+                    bLinear = FALSE;
+                apoGeoms.push_back(poSurface);
+            }
+        }
+        i = j;
+    }
+    if( !apoGeoms.empty() )
+    {
+        if( apoGeoms.size() > 1 )
+            poColl = bLinear ? new OGRMultiPolygon() : new OGRMultiSurface();
+    }
+
+    if( apoGeoms.empty() )
+    {
+        for( int i = 0; i < nPaths; i++ )
+        {
+            if( asPaths[i].eType != VFP_PATH_LINE )
+                continue;
+            OGRCurve *poCurve = BuildPath(&asPaths[i], FALSE);
+            if( poCurve != NULL )
+            {
+                if( wkbFlatten(poCurve->getGeometryType()) != wkbLineString )
+                    bLinear = FALSE;
+                apoGeoms.push_back(poCurve);
+            }
+        }
+        if( apoGeoms.size() > 1 )
+            poColl = bLinear ? new OGRMultiLineString() : new OGRMultiCurve();
+    }
+
+    if( apoGeoms.empty() )
+    {
+        for( int i = 0; i < nPaths; i++ )
+        {
+            const int iPoint = asPaths[i].nFirstPoint;
+            if( asPaths[i].eType != VFP_PATH_POINT )
+                continue;
+            if( bHas3D )
+                apoGeoms.push_back(new OGRPoint(adfX[iPoint], adfY[iPoint], adfZ[iPoint]));
+            else
+                apoGeoms.push_back(new OGRPoint(adfX[iPoint], adfY[iPoint]));
+        }
+        if( apoGeoms.size() > 1 )
+            poColl = new OGRMultiPoint();
+    }
+
+    Reset();
+
+    if( apoGeoms.empty() )
+        return NULL;
+
+    OGRGeometry *poGeom = NULL;
+    if( poColl != NULL )
+    {
+        for( size_t i = 0; i < apoGeoms.size(); i++ )
+            poColl->addGeometryDirectly(apoGeoms[i]);
+        poGeom = poColl;
+    }
+    else
+        poGeom = apoGeoms[0];
+    apoGeoms.resize(0);
+
+    if( bLinearize && poGeom->hasCurveGeometry() )
+    {
+        OGRGeometry *poLinear = poGeom->getLinearGeometry(dfMaxAngleStep);
+        delete poGeom;
+        poGeom = poLinear;
+    }
+
+    return poGeom;
+}
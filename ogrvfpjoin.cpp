@@ -0,0 +1,449 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  VFP Translator
+ * Purpose:  Implements OGRVFPJoinLayer class.
+ * Author:   Martin Landa, landa.martin gmail.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, Martin Landa <landa.martin gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ogr_vfp.h"
+#include "cpl_conv.h"
+#include "cpl_string.h"
+
+CPL_CVSID("$Id$");
+
+/************************************************************************/
+/*                          OGRVFPJoinLayer()                           */
+/*                                                                      */
+/*      The fields of the result are those of the primary layer, then   */
+/*      those of the secondary layer prefixed with its name, as in      */
+/*      the results of OGR SQL joins. The geometry is the one of the    */
+/*      primary layer. As with OGR SQL, the filters of both layers      */
+/*      are cleared while the join exists.                              */
+/************************************************************************/
+
+static char *SaveAttributeFilter( OGRVFPLayer *poLayer )
+{
+    const char *pszFilter = poLayer->GetAttributeFilter();
+    return pszFilter != NULL ? CPLStrdup(pszFilter) : NULL;
+}
+
+static OGRGeometry *SaveSpatialFilter( OGRVFPLayer *poLayer )
+{
+    OGRGeometry *poGeom = poLayer->GetSpatialFilter();
+    return poGeom != NULL ? poGeom->clone() : NULL;
+}
+
+OGRVFPJoinLayer::OGRVFPJoinLayer( OGRVFPLayer *poPrimaryIn, int iPrimaryFieldIn,
+                                  OGRVFPLayer *poSecondaryIn, int iSecondaryFieldIn,
+                                  bool bLeftJoinIn, bool bOneToManyIn )
+{
+    poPrimary = poPrimaryIn;
+    poSecondary = poSecondaryIn;
+    iPrimaryField = iPrimaryFieldIn;
+    iSecondaryField = iSecondaryFieldIn;
+    bLeftJoin = bLeftJoinIn;
+    bOneToMany = bOneToManyIn;
+
+    pszPrimaryAttrFilter = SaveAttributeFilter( poPrimary );
+    poPrimaryFilterGeom = SaveSpatialFilter( poPrimary );
+    pszSecondaryAttrFilter = SaveAttributeFilter( poSecondary );
+    poSecondaryFilterGeom = SaveSpatialFilter( poSecondary );
+    poPrimary->SetAttributeFilter( NULL );
+    poPrimary->SetSpatialFilter( NULL );
+    poSecondary->SetAttributeFilter( NULL );
+    poSecondary->SetSpatialFilter( NULL );
+
+    OGRFeatureDefn *poPrimaryDefn = poPrimary->GetLayerDefn();
+    OGRFeatureDefn *poSecondaryDefn = poSecondary->GetLayerDefn();
+
+    eKeyType = OFTString;
+    GetKeyType( poPrimaryDefn->GetFieldDefn(iPrimaryField)->GetType(),
+                poSecondaryDefn->GetFieldDefn(iSecondaryField)->GetType(),
+                &eKeyType );
+
+    poFeatureDefn = new OGRFeatureDefn( CPLSPrintf("%s_%s", poPrimary->GetName(),
+                                                   poSecondary->GetName()) );
+    SetDescription( poFeatureDefn->GetName() );
+    poFeatureDefn->Reference();
+    poFeatureDefn->SetGeomType( poPrimaryDefn->GetGeomType() );
+    if( poFeatureDefn->GetGeomFieldCount() != 0 )
+        poFeatureDefn->GetGeomFieldDefn(0)->SetSpatialRef( poPrimary->GetSpatialRef() );
+
+    for( int i = 0; i < poPrimaryDefn->GetFieldCount(); i++ )
+        poFeatureDefn->AddFieldDefn( poPrimaryDefn->GetFieldDefn(i) );
+    for( int i = 0; i < poSecondaryDefn->GetFieldCount(); i++ )
+    {
+        OGRFieldDefn *poSrcDefn = poSecondaryDefn->GetFieldDefn(i);
+        OGRFieldDefn oFieldDefn( CPLSPrintf("%s.%s", poSecondary->GetName(),
+                                            poSrcDefn->GetNameRef()),
+                                 poSrcDefn->GetType() );
+        poFeatureDefn->AddFieldDefn( &oFieldDefn );
+    }
+
+    bIndexBuilt = FALSE;
+    poPrimaryFeature = NULL;
+    iNextMatch = 0;
+    nNextFID = 0;
+}
+
+/************************************************************************/
+/*                          ~OGRVFPJoinLayer()                          */
+/************************************************************************/
+
+OGRVFPJoinLayer::~OGRVFPJoinLayer()
+
+{
+    delete poPrimaryFeature;
+    for( size_t i = 0; i < apoSecondaryFeatures.size(); i++ )
+        delete apoSecondaryFeatures[i];
+
+    /* the spatial filter of the join was handed to the primary layer */
+    poPrimary->SetAttributeFilter( pszPrimaryAttrFilter );
+    poPrimary->SetSpatialFilter( poPrimaryFilterGeom );
+    poSecondary->SetAttributeFilter( pszSecondaryAttrFilter );
+    poSecondary->SetSpatialFilter( poSecondaryFilterGeom );
+    CPLFree( pszPrimaryAttrFilter );
+    delete poPrimaryFilterGeom;
+    CPLFree( pszSecondaryAttrFilter );
+    delete poSecondaryFilterGeom;
+
+    poFeatureDefn->Release();
+}
+
+/************************************************************************/
+/*                             GetKeyType()                             */
+/*                                                                      */
+/*      Type in which two key fields are compared, as the OGR SQL       */
+/*      comparison of their values would: integers as integers, an      */
+/*      integer and a real as reals, strings as strings. Other          */
+/*      combinations are left to OGR SQL.                               */
+/************************************************************************/
+
+static OGRFieldType GetKeyClass( OGRFieldType eType )
+{
+    if( eType == OFTInteger || eType == OFTInteger64 )
+        return OFTInteger64;
+    if( eType == OFTReal || eType == OFTString )
+        return eType;
+    return OFTBinary;
+}
+
+bool OGRVFPJoinLayer::GetKeyType( OGRFieldType ePrimaryType,
+                                  OGRFieldType eSecondaryType,
+                                  OGRFieldType *peKeyType )
+{
+    const OGRFieldType eClass1 = GetKeyClass(ePrimaryType);
+    const OGRFieldType eClass2 = GetKeyClass(eSecondaryType);
+    if( eClass1 == OFTBinary || eClass2 == OFTBinary )
+        return FALSE;
+
+    if( eClass1 == eClass2 )
+        *peKeyType = eClass1;
+    else if( eClass1 != OFTString && eClass2 != OFTString )
+        *peKeyType = OFTReal;
+    else
+        return FALSE;
+    return TRUE;
+}
+
+/************************************************************************/
+/*                              HashKey()                               */
+/************************************************************************/
+
+GUInt32 OGRVFPJoinLayer::HashKey( OGRFeature *poFeature, int iField )
+
+{
+    if( eKeyType == OFTInteger64 )
+    {
+        const GIntBig nValue = poFeature->GetFieldAsInteger64(iField);
+        return OGRVFPHash( &nValue, sizeof(nValue) );
+    }
+    if( eKeyType == OFTReal )
+    {
+        double dfValue = poFeature->GetFieldAsDouble(iField);
+        if( dfValue == 0.0 )
+            dfValue = 0.0; /* same hash for -0.0 */
+        return OGRVFPHash( &dfValue, sizeof(dfValue) );
+    }
+    const char *pszValue = poFeature->GetFieldAsString(iField);
+    return OGRVFPHash( pszValue, strlen(pszValue) );
+}
+
+/************************************************************************/
+/*                             EqualKeys()                              */
+/************************************************************************/
+
+bool OGRVFPJoinLayer::EqualKeys( OGRFeature *poFeature1, int iField1,
+                                 OGRFeature *poFeature2, int iField2 )
+
+{
+    if( eKeyType == OFTInteger64 )
+        return poFeature1->GetFieldAsInteger64(iField1) ==
+               poFeature2->GetFieldAsInteger64(iField2);
+    if( eKeyType == OFTReal )
+        return poFeature1->GetFieldAsDouble(iField1) ==
+               poFeature2->GetFieldAsDouble(iField2);
+    return strcmp( poFeature1->GetFieldAsString(iField1),
+                   poFeature2->GetFieldAsString(iField2) ) == 0;
+}
+
+/************************************************************************/
+/*                           FindFirstMatch()                           */
+/*                                                                      */
+/*      Index of the first secondary feature read whose key equals      */
+/*      the one of poFeature, -1 if there is none.                      */
+/************************************************************************/
+
+int OGRVFPJoinLayer::FindFirstMatch( OGRFeature *poFeature, int iField,
+                                     GUInt32 nHash )
+
+{
+    const std::vector<int> &anBucket = aanBuckets[nHash & (aanBuckets.size() - 1)];
+    for( size_t i = 0; i < anBucket.size(); i++ )
+    {
+        if( EqualKeys( apoSecondaryFeatures[anBucket[i]], iSecondaryField,
+                       poFeature, iField ) )
+            return anBucket[i];
+    }
+    return -1;
+}
+
+/************************************************************************/
+/*                             BuildIndex()                             */
+/*                                                                      */
+/*      Read the secondary layer once. Features without a key cannot    */
+/*      match and are dropped, as are the geometries, and without       */
+/*      bOneToMany the features whose key was already read.             */
+/************************************************************************/
+
+void OGRVFPJoinLayer::BuildIndex()
+
+{
+    bIndexBuilt = TRUE;
+
+    poSecondary->ResetReading();
+
+    /* grown as the features are read, at most two keys by bucket on
+       average */
+    aanBuckets.resize( 16 );
+
+    OGRFeature *poFeature;
+    while( (poFeature = poSecondary->GetNextFeature()) != NULL )
+    {
+        if( !poFeature->IsFieldSet(iSecondaryField) )
+        {
+            delete poFeature;
+            continue;
+        }
+
+        const GUInt32 nHash = HashKey( poFeature, iSecondaryField );
+        if( !bOneToMany &&
+            FindFirstMatch( poFeature, iSecondaryField, nHash ) >= 0 )
+        {
+            delete poFeature;
+            continue;
+        }
+
+        poFeature->SetGeometryDirectly( NULL );
+        aanBuckets[nHash & (aanBuckets.size() - 1)].push_back(
+            (int)apoSecondaryFeatures.size() );
+        apoSecondaryFeatures.push_back( poFeature );
+
+        if( apoSecondaryFeatures.size() > 2 * aanBuckets.size() )
+        {
+            const size_t nBuckets = 2 * aanBuckets.size();
+            aanBuckets.resize( 0 );
+            aanBuckets.resize( nBuckets );
+            for( size_t i = 0; i < apoSecondaryFeatures.size(); i++ )
+            {
+                const GUInt32 nKeyHash =
+                    HashKey( apoSecondaryFeatures[i], iSecondaryField );
+                aanBuckets[nKeyHash & (nBuckets - 1)].push_back( (int)i );
+            }
+        }
+    }
+
+    CPLDebug( "VFP", "%s: %d features of %s indexed on %s",
+              GetName(), (int)apoSecondaryFeatures.size(), poSecondary->GetName(),
+              poSecondary->GetLayerDefn()->GetFieldDefn(iSecondaryField)->GetNameRef() );
+}
+
+/************************************************************************/
+/*                            FindMatches()                             */
+/************************************************************************/
+
+void OGRVFPJoinLayer::FindMatches( OGRFeature *poFeature )
+
+{
+    anMatches.resize(0);
+    iNextMatch = 0;
+    if( !poFeature->IsFieldSet(iPrimaryField) )
+        return;
+
+    const GUInt32 nHash = HashKey( poFeature, iPrimaryField );
+    if( !bOneToMany )
+    {
+        const int iMatch = FindFirstMatch( poFeature, iPrimaryField, nHash );
+        if( iMatch >= 0 )
+            anMatches.push_back( iMatch );
+        return;
+    }
+
+    const std::vector<int> &anBucket = aanBuckets[nHash & (aanBuckets.size() - 1)];
+    for( size_t i = 0; i < anBucket.size(); i++ )
+    {
+        if( EqualKeys( apoSecondaryFeatures[anBucket[i]], iSecondaryField,
+                       poFeature, iPrimaryField ) )
+            anMatches.push_back( anBucket[i] );
+    }
+}
+
+/************************************************************************/
+/*                            BuildFeature()                            */
+/*                                                                      */
+/*      Joined feature of the current primary feature, whose geometry   */
+/*      is moved to the last joined feature.                            */
+/************************************************************************/
+
+OGRFeature *OGRVFPJoinLayer::BuildFeature( OGRFeature *poSecondaryFeature )
+
+{
+    /* as in OGR SQL, the FID of the primary feature for one to one
+       joins */
+    OGRFeature *poFeature = new OGRFeature( poFeatureDefn );
+    if( bOneToMany )
+        poFeature->SetFID( nNextFID++ );
+    else
+        poFeature->SetFID( poPrimaryFeature->GetFID() );
+
+    const int nPrimaryFields = poPrimary->GetLayerDefn()->GetFieldCount();
+    for( int i = 0; i < nPrimaryFields; i++ )
+    {
+        if( poPrimaryFeature->IsFieldSet(i) )
+            poFeature->SetField( i, poPrimaryFeature->GetRawFieldRef(i) );
+    }
+    if( poSecondaryFeature != NULL )
+    {
+        const int nSecondaryFields = poSecondary->GetLayerDefn()->GetFieldCount();
+        for( int i = 0; i < nSecondaryFields; i++ )
+        {
+            if( poSecondaryFeature->IsFieldSet(i) )
+                poFeature->SetField( nPrimaryFields + i,
+                                     poSecondaryFeature->GetRawFieldRef(i) );
+        }
+    }
+
+    if( iNextMatch >= anMatches.size() )
+        poFeature->SetGeometryDirectly( poPrimaryFeature->StealGeometry() );
+    else if( poPrimaryFeature->GetGeometryRef() != NULL )
+        poFeature->SetGeometry( poPrimaryFeature->GetGeometryRef() );
+
+    return poFeature;
+}
+
+/************************************************************************/
+/*                            ResetReading()                            */
+/************************************************************************/
+
+void OGRVFPJoinLayer::ResetReading()
+
+{
+    poPrimary->ResetReading();
+    delete poPrimaryFeature;
+    poPrimaryFeature = NULL;
+    anMatches.resize(0);
+    iNextMatch = 0;
+    nNextFID = 0;
+}
+
+/************************************************************************/
+/*                           GetNextFeature()                           */
+/************************************************************************/
+
+OGRFeature *OGRVFPJoinLayer::GetNextFeature()
+
+{
+    if( !bIndexBuilt )
+    {
+        BuildIndex();
+        poPrimary->ResetReading();
+    }
+
+    while( TRUE )
+    {
+        OGRFeature *poFeature = NULL;
+        if( poPrimaryFeature != NULL && iNextMatch < anMatches.size() )
+        {
+            OGRFeature *poSecondaryFeature = apoSecondaryFeatures[anMatches[iNextMatch++]];
+            poFeature = BuildFeature( poSecondaryFeature );
+        }
+        else
+        {
+            delete poPrimaryFeature;
+            poPrimaryFeature = poPrimary->GetNextFeature();
+            if( poPrimaryFeature == NULL )
+                return NULL;
+            FindMatches( poPrimaryFeature );
+            if( anMatches.empty() && bLeftJoin )
+                poFeature = BuildFeature( NULL );
+        }
+
+        if( poFeature == NULL )
+            continue;
+
+        if( m_poAttrQuery == NULL || m_poAttrQuery->Evaluate(poFeature) )
+            return poFeature;
+
+        delete poFeature;
+    }
+}
+
+/************************************************************************/
+/*                          SetSpatialFilter()                          */
+/*                                                                      */
+/*      Applied by the primary layer, which skips the records outside   */
+/*      of it while parsing.                                            */
+/************************************************************************/
+
+void OGRVFPJoinLayer::SetSpatialFilter( OGRGeometry *poGeom )
+
+{
+    InstallFilter( poGeom );
+    poPrimary->SetSpatialFilter( poGeom );
+    ResetReading();
+}
+
+/************************************************************************/
+/*                           TestCapability()                           */
+/************************************************************************/
+
+int OGRVFPJoinLayer::TestCapability( const char * pszCap )
+
+{
+    if( EQUAL(pszCap, OLCStringsAsUTF8) )
+        return TRUE;
+
+    return FALSE;
+}
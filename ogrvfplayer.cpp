@@ -32,6 +32,8 @@
 #include "cpl_string.h"
 #include "cpl_minixml.h"
 #include "ogr_p.h"
+#include "cpl_atomic_ops.h"
+#include "swq.h"
 
 CPL_CVSID("$Id$");
 
@@ -41,46 +43,112 @@ CPL_CVSID("$Id$");
 /************************************************************************/
 
 OGRVFPLayer::OGRVFPLayer( const char* pszFilename,
-                          const char* pszLayerName,
+                          const OGRVFPLayerDesc *psDesc,
+                          const OGRVFPSection *psSection,
                           OGRVFPDataSource* poDS)
 {
     this->poDS = poDS;
+    this->psSection = psSection;
 
-    pszElementToScan = pszLayerName;
+    pszElementToScan = psDesc->pszName;
+    eElementToken = psDesc->eToken;
+    nRecordDepth = psDesc->nRecordDepth;
 
-    nFeatures = 0;
-
-    poFeatureDefn = new OGRFeatureDefn( pszLayerName );
+    poFeatureDefn = new OGRFeatureDefn( psDesc->pszName );
     SetDescription( poFeatureDefn->GetName() );
     poFeatureDefn->Reference();
+    if (!psDesc->bHasGeometry)
+        poFeatureDefn->SetGeomType(wkbNone);
 
-    /* set spatial reference 
-       default is S-JTSK (EPSG: 5514) */
-    poSRS = new OGRSpatialReference();
-    if( poSRS->importFromEPSG(5514) != OGRERR_NONE)
+    /* the schema is known in advance, the file is not read here */
+    anFieldByToken.resize(VFP_TOKEN_COUNT, -1);
+    for (int i = 0; i < psDesc->nFields; i++)
     {
-        delete poSRS;
-        poSRS = NULL;
+        OGRFieldDefn oFieldDefn(psDesc->pasFields[i].pszName,
+                                psDesc->pasFields[i].eType);
+        poFeatureDefn->AddFieldDefn(&oFieldDefn);
+
+        const OGRVFPToken eToken = OGRVFPGetToken(psDesc->pasFields[i].pszName);
+        if (eToken != VFP_TOKEN_UNKNOWN)
+            anFieldByToken[eToken] = i;
     }
+
+    /* S-JTSK (EPSG: 5514), owned by the datasource */
+    poSRS = poDS->GetSpatialRef();
+    if( poSRS != NULL )
+        poSRS->Reference();
     if( poFeatureDefn->GetGeomFieldCount() != 0 )
         poFeatureDefn->GetGeomFieldDefn(0)->SetSpatialRef(poSRS);
 
-     poFeature = NULL;
+    bStats = poDS->CollectStats();
+    OGRVFPResetStats(&sStats);
+    papszStatsMetadata = NULL;
 
-#ifdef HAVE_EXPAT
-    oParser = NULL;
-    oSchemaParser = NULL;
-#endif
+    poReader = new OGRVFPReader(this, poDS->GetFeatureQueueSize());
 
-    fpVFP = VSIFOpenL( pszFilename, "r" );
-    if( fpVFP == NULL )
-        {
-            CPLError(CE_Failure, CPLE_AppDefined, "Cannot open %s", pszFilename);
-            return;
-        }
+    bUseParserThread = poDS->UseParserThreads();
+
+    bRecordRangesComplete = FALSE;
+    poRandomReader = NULL;
+    nStartFID = 0;
+    nStartOffset = 0;
+    /* not from the PARSER_THREADS worker, GetFeature() could not read
+       the table while it is appended to */
+    if (!bUseParserThread)
+        poReader->SetRecordRanges(&asRecordRanges, &aosRecordPaths, FALSE);
+    hParserThread = NULL;
+    hRingMutex = NULL;
+    hRingCond = NULL;
+    papoRing = NULL;
+    nRingSize = 0;
+    nRingHead = 0;
+    nRingTail = 0;
+    nRingWaiters = 0;
+    bParserThreadDone = FALSE;
+    bAbortParserThread = FALSE;
+    OGRVFPResetStats(&sParserThreadStats);
+    if (bUseParserThread)
+    {
+        /* one slot is always left empty to tell a full ring from an empty one */
+        nRingSize = poDS->GetFeatureQueueSize() + 1;
+        papoRing = (OGRFeature **) CPLMalloc(nRingSize * sizeof(OGRFeature*));
+        hRingMutex = CPLCreateMutex();
+        CPLReleaseMutex(hRingMutex);
+        hRingCond = CPLCreateCond();
+    }
+
+    nParseThreads = poDS->GetParseThreads();
+    hSliceMutex = NULL;
+    hSliceCond = NULL;
+    nNextSliceToParse = 0;
+    nCurrentSlice = 0;
+    bAbortSlices = FALSE;
+    if (nParseThreads > 1)
+    {
+        hSliceMutex = CPLCreateMutex();
+        CPLReleaseMutex(hSliceMutex);
+        hSliceCond = CPLCreateCond();
+    }
+
+    poRTree = NULL;
+    bRTreeChecked = FALSE;
+    bRTreeBuildFailed = FALSE;
+    osRTreeFilename = OGRVFPDataSource::GetSpatialIndexFilename(pszFilename,
+                                                                psDesc->pszName);
+    bRTreeInMemory = FALSE;
+    iNextCandidate = 0;
+    bCandidatesFetched = FALSE;
+
+    poFeatureCache = NULL;
+    bFeatureCacheChecked = FALSE;
+    osFeatureCacheFilename =
+        OGRVFPDataSource::GetFeatureCacheFilename(pszFilename, psDesc->pszName);
+    nNextCachedFID = 0;
+    poCacheWriter = NULL;
+    bCacheWritePending = FALSE;
+    bCacheWriteFailed = FALSE;
+    bReadFailed = FALSE;
 
-    LoadSchema();
-     
     ResetReading();
 }
 
@@ -91,20 +159,48 @@ OGRVFPLayer::OGRVFPLayer( const char* pszFilename,
 OGRVFPLayer::~OGRVFPLayer()
 
 {
-#ifdef HAVE_EXPAT
-    if (oParser)
-        XML_ParserFree(oParser);
-#endif
+    StopParserThread();
+    CPLFree(papoRing);
+    if (hRingCond)
+        CPLDestroyCond(hRingCond);
+    if (hRingMutex)
+        CPLDestroyMutex(hRingMutex);
+
+    StopSliceThreads();
+    if (hSliceCond)
+        CPLDestroyCond(hSliceCond);
+    if (hSliceMutex)
+        CPLDestroyMutex(hSliceMutex);
+
+    AbortCacheWriter();
+    delete poFeatureCache;
+
+    delete poReader;
+    delete poRandomReader;
+
+    if (bStats && sStats.nRecords > 0)
+    {
+        char **papszList = OGRVFPStatsToList(&sStats, NULL);
+        CPLString osStats;
+        for (int i = 0; papszList[i] != NULL; i++)
+        {
+            if (i > 0)
+                osStats += ", ";
+            osStats += papszList[i];
+        }
+        CPLDebug("VFP", "%s: %s", GetName(), osStats.c_str());
+        CSLDestroy(papszList);
+    }
+    CSLDestroy(papszStatsMetadata);
+
+    delete poRTree;
+    if (bRTreeInMemory)
+        VSIUnlink(osRTreeFilename);
+
     poFeatureDefn->Release();
     
     if( poSRS != NULL )
         poSRS->Release();
-
-    if (poFeature)
-        delete poFeature;
-
-    if (fpVFP)
-        VSIFCloseL( fpVFP );
 }
 
 /************************************************************************/
@@ -114,134 +210,1413 @@ OGRVFPLayer::~OGRVFPLayer()
 void OGRVFPLayer::ResetReading()
 
 {
+    StopParserThread();
+    StopSliceThreads();
+    poReader->Stop();
+
+    anCandidateFIDs.resize(0);
+    iNextCandidate = 0;
+    bCandidatesFetched = FALSE;
+
+    nStartFID = 0;
+    nStartOffset = 0;
+    osStartPrefix = "";
+
+    AbortCacheWriter();
+    nNextCachedFID = 0;
+    bReadFailed = FALSE;
+    bCacheWritePending = poDS->UseFeatureCache() && !bCacheWriteFailed;
 }
 
 /************************************************************************/
 /*                           GetNextFeature()                           */
+/*                                                                      */
+/*      An ignored geometry is only built for the spatial filter, and   */
+/*      dropped once the feature passed it.                             */
 /************************************************************************/
 
 OGRFeature *OGRVFPLayer::GetNextFeature()
 {
-    return FALSE;
+    if (bCacheWritePending)
+        StartCacheWriter();
+
+    while (TRUE)
+    {
+        OGRFeature *poFeatureRet = GetNextRawFeature();
+        if (poCacheWriter != NULL)
+        {
+            if (poFeatureRet == NULL)
+                FinishCacheWriter();
+            else if (!poCacheWriter->AddFeature(poFeatureRet))
+                AbortCacheWriter();
+        }
+        if (poFeatureRet == NULL)
+            return NULL;
+
+        const GIntBig nStart = bStats ? OGRVFPGetTimeNs() : 0;
+        const bool bPass =
+            (m_poFilterGeom == NULL ||
+             FilterGeometry(poFeatureRet->GetGeometryRef())) &&
+            (m_poAttrQuery == NULL ||
+             m_poAttrQuery->Evaluate(poFeatureRet));
+        if (bStats)
+            sStats.nFilterNs += OGRVFPGetTimeNs() - nStart;
+
+        if (bPass)
+        {
+            if (m_poFilterGeom != NULL && poFeatureDefn->IsGeometryIgnored())
+                poFeatureRet->SetGeometryDirectly(NULL);
+            sStats.nFeaturesReturned++;
+            return poFeatureRet;
+        }
+
+        sStats.nFeaturesFiltered++;
+        delete poFeatureRet;
+    }
 }
 
 /************************************************************************/
-/*                           TestCapability()                           */
+/*                         GetNextRawFeature()                          */
+/*                                                                      */
+/*      Features are parsed in chunks of nReadChunkSize bytes from      */
+/*      the byte range of the layer element only. At most              */
+/*      nFeatureTabSize features are buffered, the parser is            */
+/*      suspended when the queue is full and resumed once it has        */
+/*      been drained, so memory does not depend on the file size.      */
 /************************************************************************/
 
-int OGRVFPLayer::TestCapability( const char * pszCap )
+OGRFeature *OGRVFPLayer::GetNextRawFeature()
 {
-    return FALSE;
+    poDS->ScanSections();
+
+    if (GetFeatureCache() != NULL)
+        return GetNextCachedFeature();
+
+    if (m_poFilterGeom != NULL && GetRTree(TRUE) != NULL)
+        return GetNextIndexedFeature();
+
+    if (nParseThreads > 1 && !psSection->asSplitPoints.empty() && nStartFID == 0)
+    {
+        if (!apoSlices.empty() || StartSliceThreads())
+            return GetNextSliceFeature();
+
+        /* no worker could be started, parse sequentially from now on */
+        CPLDebug("VFP", "%s: no parsing thread, reading sequentially",
+                 pszElementToScan);
+        StopSliceThreads();
+        nParseThreads = 1;
+    }
+
+    if (bUseParserThread)
+    {
+        if (hParserThread == NULL)
+        {
+            if (bParserThreadDone)
+                return NULL;
+            sParserThreadStats = *poReader->GetStats();
+            hParserThread = CPLCreateJoinableThread(ParserThreadFunc, this);
+            if (hParserThread == NULL)
+            {
+                bReadFailed = TRUE;
+                return NULL;
+            }
+        }
+        return PopFeature();
+    }
+
+    if (!poReader->IsStarted())
+        StartReader();
+
+    while (TRUE)
+    {
+        OGRFeature *poFeatureRet = poReader->GetNextQueuedFeature();
+        if (poFeatureRet != NULL)
+            return poFeatureRet;
+        if (poReader->IsFinished())
+        {
+            /* all the records went through the FID table */
+            if (!poReader->HasFailed() &&
+                poReader->GetNextFID() == (GIntBig)asRecordRanges.size())
+                bRecordRangesComplete = TRUE;
+            return NULL;
+        }
+        poReader->ParseNextChunk();
+    }
+}
+
+/************************************************************************/
+/*                          GetFeatureCache()                           */
+/*                                                                      */
+/*      Feature cache of the layer, opened on the first call when       */
+/*      FEATURE_CACHE=YES and it is up to date.                         */
+/************************************************************************/
+
+OGRVFPFeatureCache *OGRVFPLayer::GetFeatureCache()
+
+{
+    if (poFeatureCache != NULL || bFeatureCacheChecked || !poDS->UseFeatureCache())
+        return poFeatureCache;
+
+    bFeatureCacheChecked = TRUE;
+    if (psSection->nEnd > psSection->nStart)
+        poFeatureCache = OGRVFPFeatureCache::Open(osFeatureCacheFilename,
+                                                  poDS->GetName(),
+                                                  poDS->GetHeaderHash(),
+                                                  psSection->nStart,
+                                                  poFeatureDefn,
+                                                  poDS->GetLinearize(),
+                                                  poDS->GetMaxAngleStep(),
+                                                  poDS->UseMmap());
+
+    return poFeatureCache;
+}
+
+/************************************************************************/
+/*                        GetNextCachedFeature()                        */
+/*                                                                      */
+/*      Records whose envelope does not intersect the spatial filter    */
+/*      are skipped without decoding them. A corrupted cache is         */
+/*      removed, the next read of the layer parses the XML again.       */
+/************************************************************************/
+
+OGRFeature *OGRVFPLayer::GetNextCachedFeature()
+
+{
+    while (nNextCachedFID < poFeatureCache->GetFeatureCount())
+    {
+        bool bSkipped = FALSE, bError = FALSE;
+        OGRFeature *poFeature =
+            poFeatureCache->GetFeature(nNextCachedFID++, poFeatureDefn, poSRS,
+                                       m_poFilterGeom ? &m_sFilterEnvelope : NULL,
+                                       &bSkipped, &bError);
+        sStats.nRecords++;
+        if (poFeature != NULL)
+        {
+            sStats.nFeaturesBuilt++;
+            return poFeature;
+        }
+        if (bError)
+        {
+            CPLError(CE_Failure, CPLE_FileIO,
+                     "%s is corrupted and is removed", osFeatureCacheFilename.c_str());
+            delete poFeatureCache;
+            poFeatureCache = NULL;
+            VSIUnlink(osFeatureCacheFilename);
+            return NULL;
+        }
+        sStats.nRecordsSkipped++;
+    }
+
+    return NULL;
+}
+
+/************************************************************************/
+/*                          StartCacheWriter()                          */
+/*                                                                      */
+/*      The cache is written by a read of the whole layer from its      */
+/*      first record, without filters or ignored fields.                */
+/************************************************************************/
+
+void OGRVFPLayer::StartCacheWriter()
+
+{
+    bCacheWritePending = FALSE;
+
+    poDS->ScanSections();
+    if (GetFeatureCache() != NULL || m_poFilterGeom != NULL ||
+        m_poAttrQuery != NULL || psSection->nEnd <= psSection->nStart ||
+        (poFeatureDefn->GetGeomFieldCount() > 0 && poFeatureDefn->IsGeometryIgnored()))
+        return;
+    for (int i = 0; i < poFeatureDefn->GetFieldCount(); i++)
+    {
+        if (poFeatureDefn->GetFieldDefn(i)->IsIgnored())
+            return;
+    }
+
+    poCacheWriter = new OGRVFPFeatureCacheWriter();
+    if (!poCacheWriter->Create(osFeatureCacheFilename))
+    {
+        CPLDebug("VFP", "Cannot write %s", osFeatureCacheFilename.c_str());
+        delete poCacheWriter;
+        poCacheWriter = NULL;
+        bCacheWriteFailed = TRUE;
+    }
 }
 
 /************************************************************************/
-/*                       LoadExtensionsSchema()                         */
+/*                         FinishCacheWriter()                          */
+/*                                                                      */
+/*      Called at the end of the layer. The cache is kept only if all   */
+/*      the records were read, it is used after the next                */
+/*      ResetReading().                                                 */
 /************************************************************************/
 
-#ifdef HAVE_EXPAT
+void OGRVFPLayer::FinishCacheWriter()
 
-static void XMLCALL startElementLoadSchemaCbk(void *pUserData, const char *pszName, const char **ppszAttr)
 {
-    ((OGRVFPLayer*)pUserData)->startElementLoadSchemaCbk(pszName, ppszAttr);
+    if (bReadFailed || poReader->HasFailed() ||
+        (psSection->nFeatureCount >= 0 &&
+         poCacheWriter->GetFeatureCount() != psSection->nFeatureCount))
+    {
+        AbortCacheWriter();
+        return;
+    }
+
+    if (poCacheWriter->Finish(poDS->GetName(), poDS->GetHeaderHash(),
+                              psSection->nStart, poFeatureDefn,
+                              poDS->GetLinearize(), poDS->GetMaxAngleStep()))
+    {
+        /* positioned at its end, as the read that wrote it */
+        bFeatureCacheChecked = FALSE;
+        if (GetFeatureCache() != NULL)
+            nNextCachedFID = poFeatureCache->GetFeatureCount();
+    }
+    else
+        bCacheWriteFailed = TRUE;
+    delete poCacheWriter;
+    poCacheWriter = NULL;
 }
 
-static void XMLCALL endElementLoadSchemaCbk(void *pUserData, const char *pszName)
+/************************************************************************/
+/*                          AbortCacheWriter()                          */
+/************************************************************************/
+
+void OGRVFPLayer::AbortCacheWriter()
+
 {
-    ((OGRVFPLayer*)pUserData)->endElementLoadSchemaCbk(pszName);
+    if (poCacheWriter == NULL)
+        return;
+
+    poCacheWriter->Abort();
+    delete poCacheWriter;
+    poCacheWriter = NULL;
 }
 
-static void XMLCALL dataHandlerLoadSchemaCbk(void *pUserData, const char *data, int nLen)
+/************************************************************************/
+/*                            StartReader()                             */
+/*                                                                      */
+/*      Start the sequential read at the beginning of the layer         */
+/*      element, or at the record selected by SetNextByIndex().         */
+/************************************************************************/
+
+bool OGRVFPLayer::StartReader()
+
 {
-    ((OGRVFPLayer*)pUserData)->dataHandlerLoadSchemaCbk(data, nLen);
+    if (nStartFID > 0)
+        return poReader->Start(poDS->GetFile(), FALSE, nStartOffset,
+                               psSection->nEnd, nStartFID, osStartPrefix);
+    return poReader->Start(poDS->GetFile(), FALSE, psSection->nStart,
+                           psSection->nEnd, 0);
 }
 
-void OGRVFPLayer::LoadSchema()
+/************************************************************************/
+/*                          ParserThreadFunc()                          */
+/*                                                                      */
+/*      With PARSER_THREADS=YES the expat parse and the building of     */
+/*      the features run in a worker thread (the producer) while        */
+/*      GetNextFeature() pops the features from a ring (the             */
+/*      consumer). The ring indices are updated with atomic             */
+/*      operations, the mutex and the condition are only used to        */
+/*      sleep when the ring is full or empty.                           */
+/************************************************************************/
+
+void OGRVFPLayer::ParserThreadFunc( void *pData )
+
 {
-    oSchemaParser = OGRCreateExpatXMLParser();
-    XML_SetElementHandler(oSchemaParser, ::startElementLoadSchemaCbk, ::endElementLoadSchemaCbk);
-    XML_SetCharacterDataHandler(oSchemaParser, ::dataHandlerLoadSchemaCbk);
-    XML_SetUserData(oSchemaParser, this);
+    ((OGRVFPLayer *) pData)->RunParserThread();
+}
 
-    VSIFSeekL( fpVFP, 0, SEEK_SET );
+void OGRVFPLayer::RunParserThread()
 
-    bStopParsing = FALSE;
-    nWithoutEventCounter = 0;
-    interestingDepthLevel = depthLevel = 0;
-    inInterestingElement = FALSE;
-    
-    char aBuf[BUFSIZ];
-    int nDone;
-    do
-    {
-        nDataHandlerCounter = 0;
-        unsigned int nLen = (unsigned int)VSIFReadL( aBuf, 1, sizeof(aBuf), fpVFP );
-        nDone = VSIFEofL(fpVFP);
-        if (XML_Parse(oSchemaParser, aBuf, nLen, nDone) == XML_STATUS_ERROR)
-        {
-            CPLError(CE_Failure, CPLE_AppDefined,
-                     "XML parsing of GPX file failed : %s at line %d, column %d",
-                     XML_ErrorString(XML_GetErrorCode(oSchemaParser)),
-                     (int)XML_GetCurrentLineNumber(oSchemaParser),
-                     (int)XML_GetCurrentColumnNumber(oSchemaParser));
-            bStopParsing = TRUE;
-            break;
+{
+    StartReader();
+
+    while (!poReader->IsFinished() && !CPLAtomicAdd(&bAbortParserThread, 0))
+    {
+        poReader->ParseNextChunk();
+
+        OGRFeature *poFeatureIn;
+        while ((poFeatureIn = poReader->GetNextQueuedFeature()) != NULL)
+        {
+            if (!PushFeature(poFeatureIn))
+                break;
         }
-        nWithoutEventCounter ++;
-    } while (!nDone && !bStopParsing && nWithoutEventCounter < 10);
 
-    if (nWithoutEventCounter == 10)
+        CPLAcquireMutex(hRingMutex, 1000.0);
+        sParserThreadStats = *poReader->GetStats();
+        CPLReleaseMutex(hRingMutex);
+    }
+    /* seen by the consumer once bParserThreadDone is set */
+    if (poReader->HasFailed())
+        bReadFailed = TRUE;
+
+    CPLAtomicInc(&bParserThreadDone);
+    WakeUpRingWaiter();
+}
+
+/************************************************************************/
+/*                          StopParserThread()                          */
+/************************************************************************/
+
+void OGRVFPLayer::StopParserThread()
+
+{
+    if (hParserThread == NULL)
+        return;
+
+    CPLAtomicInc(&bAbortParserThread);
+    CPLAcquireMutex(hRingMutex, 1000.0);
+    CPLCondBroadcast(hRingCond);
+    CPLReleaseMutex(hRingMutex);
+
+    CPLJoinThread(hParserThread);
+    hParserThread = NULL;
+    poReader->Stop();
+
+    while (nRingHead != nRingTail)
+    {
+        delete papoRing[nRingHead];
+        nRingHead = (nRingHead + 1) % nRingSize;
+    }
+    nRingHead = 0;
+    nRingTail = 0;
+    nRingWaiters = 0;
+    bParserThreadDone = FALSE;
+    bAbortParserThread = FALSE;
+}
+
+/************************************************************************/
+/*                          WakeUpRingWaiter()                          */
+/************************************************************************/
+
+void OGRVFPLayer::WakeUpRingWaiter()
+
+{
+    if (CPLAtomicAdd(&nRingWaiters, 0) > 0)
+    {
+        CPLAcquireMutex(hRingMutex, 1000.0);
+        CPLCondBroadcast(hRingCond);
+        CPLReleaseMutex(hRingMutex);
+    }
+}
+
+/************************************************************************/
+/*                            PushFeature()                             */
+/*                                                                      */
+/*      Called from the parser thread. Blocks while the ring is full.   */
+/************************************************************************/
+
+bool OGRVFPLayer::PushFeature( OGRFeature *poFeatureIn )
+
+{
+    const int nTail = nRingTail;
+    const int nNext = (nTail + 1) % nRingSize;
+
+    while (nNext == CPLAtomicAdd(&nRingHead, 0))
     {
-        CPLError(CE_Failure, CPLE_AppDefined,
-                 "Too much data inside one element. File probably corrupted");
-        bStopParsing = TRUE;
+        if (CPLAtomicAdd(&bAbortParserThread, 0))
+        {
+            delete poFeatureIn;
+            return FALSE;
+        }
+
+        CPLAcquireMutex(hRingMutex, 1000.0);
+        CPLAtomicInc(&nRingWaiters);
+        if (nNext == CPLAtomicAdd(&nRingHead, 0) &&
+            !CPLAtomicAdd(&bAbortParserThread, 0))
+            CPLCondWait(hRingCond, hRingMutex);
+        CPLAtomicDec(&nRingWaiters);
+        CPLReleaseMutex(hRingMutex);
     }
 
-    XML_ParserFree(oSchemaParser);
-    oSchemaParser = NULL;
+    papoRing[nTail] = poFeatureIn;
+    CPLAtomicCompareAndExchange(&nRingTail, nTail, nNext);
+    WakeUpRingWaiter();
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                             PopFeature()                             */
+/*                                                                      */
+/*      Called from GetNextFeature(). Blocks while the ring is empty    */
+/*      and the parser thread is running.                               */
+/************************************************************************/
+
+OGRFeature *OGRVFPLayer::PopFeature()
+
+{
+    while (TRUE)
+    {
+        const int nHead = nRingHead;
+        if (nHead != CPLAtomicAdd(&nRingTail, 0))
+        {
+            OGRFeature *poFeatureRet = papoRing[nHead];
+            CPLAtomicCompareAndExchange(&nRingHead, nHead, (nHead + 1) % nRingSize);
+            WakeUpRingWaiter();
+            return poFeatureRet;
+        }
+
+        if (CPLAtomicAdd(&bParserThreadDone, 0))
+        {
+            /* the last features may have been pushed just before */
+            if (nHead == CPLAtomicAdd(&nRingTail, 0))
+                return NULL;
+            continue;
+        }
 
-    VSIFSeekL( fpVFP, 0, SEEK_SET );
+        CPLAcquireMutex(hRingMutex, 1000.0);
+        CPLAtomicInc(&nRingWaiters);
+        if (nHead == CPLAtomicAdd(&nRingTail, 0) &&
+            !CPLAtomicAdd(&bParserThreadDone, 0))
+            CPLCondWait(hRingCond, hRingMutex);
+        CPLAtomicDec(&nRingWaiters);
+        CPLReleaseMutex(hRingMutex);
+    }
 }
 
-void OGRVFPLayer::startElementLoadSchemaCbk(const char *pszName,
-                                            CPL_UNUSED const char **ppszAttr)
+/************************************************************************/
+/*                          SliceThreadFunc()                           */
+/*                                                                      */
+/*      With NUM_THREADS > 1 the layer element is cut at the split      */
+/*      points recorded by the schema pass. Each slice is parsed by     */
+/*      a worker with its own file handle; the elements enclosing the   */
+/*      records of a slice are given to its parser as a prefix and a    */
+/*      suffix so that it sees a well-formed document. Slices are       */
+/*      returned in document order and the workers stay at most         */
+/*      2 * NUM_THREADS slices ahead of the reader to bound memory.     */
+/************************************************************************/
+
+void OGRVFPLayer::SliceThreadFunc( void *pData )
+
 {
-    if (bStopParsing) return;
+    ((OGRVFPLayer *) pData)->RunSliceThread();
+}
+
+void OGRVFPLayer::RunSliceThread()
 
-    nWithoutEventCounter = 0;
+{
+    const int nWindow = 2 * nParseThreads;
 
-    if (strcmp(pszElementToScan, pszName) == 0)
+    while (TRUE)
     {
-        inInterestingElement = TRUE;
-        interestingDepthLevel = depthLevel;
-        
-        if (strcmp(pszName, "ucastnici") == 0)
+        CPLAcquireMutex(hSliceMutex, 1000.0);
+        while (!bAbortSlices &&
+               nNextSliceToParse < (int)apoSlices.size() &&
+               nNextSliceToParse >= nCurrentSlice + nWindow)
+            CPLCondWait(hSliceCond, hSliceMutex);
+        if (bAbortSlices || nNextSliceToParse >= (int)apoSlices.size())
+        {
+            CPLReleaseMutex(hSliceMutex);
+            return;
+        }
+        OGRVFPSlice *psSlice = apoSlices[nNextSliceToParse++];
+        CPLReleaseMutex(hSliceMutex);
+
+        OGRVFPReader *poSliceReader = new OGRVFPReader(this, 0);
+        if (poSliceReader->Start(VSIFOpenL(poDS->GetName(), "r"), TRUE,
+                                 psSlice->nStart, psSlice->nEnd,
+                                 psSlice->nFirstFID,
+                                 psSlice->osPrefix, psSlice->osSuffix))
         {
+            while (!poSliceReader->IsFinished() &&
+                   !CPLAtomicAdd(&bAbortSlices, 0))
+                poSliceReader->ParseNextChunk();
         }
+
+        CPLAcquireMutex(hSliceMutex, 1000.0);
+        psSlice->poReader = poSliceReader;
+        psSlice->bDone = TRUE;
+        CPLCondBroadcast(hSliceCond);
+        CPLReleaseMutex(hSliceMutex);
     }
-    else if (inInterestingElement)
+}
+
+/************************************************************************/
+/*                         StartSliceThreads()                          */
+/************************************************************************/
+
+static CPLString GetOpenTags( const char *pszPath )
+{
+    CPLString osTags;
+    char **papszNames = CSLTokenizeString2(pszPath, "/", 0);
+    for( int i = 0; papszNames != NULL && papszNames[i] != NULL; i++ )
+        osTags += CPLSPrintf("<%s>", papszNames[i]);
+    CSLDestroy(papszNames);
+    return osTags;
+}
+
+static CPLString GetCloseTags( const char *pszPath )
+{
+    CPLString osTags;
+    char **papszNames = CSLTokenizeString2(pszPath, "/", 0);
+    for( int i = CSLCount(papszNames) - 1; i >= 0; i-- )
+        osTags += CPLSPrintf("</%s>", papszNames[i]);
+    CSLDestroy(papszNames);
+    return osTags;
+}
+
+bool OGRVFPLayer::StartSliceThreads()
+
+{
+    const std::vector<OGRVFPSplitPoint>& asSplitPoints = psSection->asSplitPoints;
+    const int nSplits = (int)asSplitPoints.size();
+
+    for( int i = 0; i <= nSplits; i++ )
     {
-        if (depthLevel == interestingDepthLevel + 1)
+        OGRVFPSlice *psSlice = new OGRVFPSlice;
+        if (i == 0)
+        {
+            psSlice->nStart = psSection->nStart;
+            psSlice->nFirstFID = 0;
+        }
+        else
         {
-            
+            psSlice->nStart = asSplitPoints[i - 1].nOffset;
+            psSlice->nFirstFID = asSplitPoints[i - 1].nFID;
+            psSlice->osPrefix = GetOpenTags(asSplitPoints[i - 1].osPath);
         }
+        if (i == nSplits)
+            psSlice->nEnd = psSection->nEnd;
         else
         {
-            bStopParsing = TRUE;
+            psSlice->nEnd = asSplitPoints[i].nOffset;
+            psSlice->osSuffix = GetCloseTags(asSplitPoints[i].osPath);
         }
+        psSlice->poReader = NULL;
+        psSlice->bDone = FALSE;
+        apoSlices.push_back(psSlice);
+    }
+
+    nNextSliceToParse = 0;
+    nCurrentSlice = 0;
+    bAbortSlices = FALSE;
+
+    const int nThreads = MIN(nParseThreads, (int)apoSlices.size());
+    for( int i = 0; i < nThreads; i++ )
+    {
+        CPLJoinableThread *hThread =
+            CPLCreateJoinableThread(SliceThreadFunc, this);
+        if (hThread == NULL)
+            break;
+        ahSliceThreads.push_back(hThread);
     }
 
-    depthLevel++;
+    CPLDebug("VFP", "%s: parsing %d slices with %d threads",
+             pszElementToScan, (int)apoSlices.size(), (int)ahSliceThreads.size());
+
+    return !ahSliceThreads.empty();
 }
 
-void OGRVFPLayer::endElementLoadSchemaCbk(const char *pszName)
+/************************************************************************/
+/*                          StopSliceThreads()                          */
+/************************************************************************/
+
+void OGRVFPLayer::StopSliceThreads()
+
 {
+    if (apoSlices.empty())
+        return;
+
+    CPLAcquireMutex(hSliceMutex, 1000.0);
+    CPLAtomicInc(&bAbortSlices);
+    CPLCondBroadcast(hSliceCond);
+    CPLReleaseMutex(hSliceMutex);
+
+    for( size_t i = 0; i < ahSliceThreads.size(); i++ )
+        CPLJoinThread(ahSliceThreads[i]);
+    ahSliceThreads.clear();
+
+    for( size_t i = 0; i < apoSlices.size(); i++ )
+    {
+        delete apoSlices[i]->poReader;
+        delete apoSlices[i];
+    }
+    apoSlices.clear();
+
+    nNextSliceToParse = 0;
+    nCurrentSlice = 0;
+    bAbortSlices = FALSE;
 }
 
-void OGRVFPLayer::dataHandlerLoadSchemaCbk(const char *data, int nLen)
+/************************************************************************/
+/*                        GetNextSliceFeature()                         */
+/************************************************************************/
+
+OGRFeature *OGRVFPLayer::GetNextSliceFeature()
+
 {
+    while (nCurrentSlice < (int)apoSlices.size())
+    {
+        OGRVFPSlice *psSlice = apoSlices[nCurrentSlice];
+
+        CPLAcquireMutex(hSliceMutex, 1000.0);
+        while (!psSlice->bDone)
+            CPLCondWait(hSliceCond, hSliceMutex);
+        CPLReleaseMutex(hSliceMutex);
+
+        OGRFeature *poFeatureRet = psSlice->poReader->GetNextQueuedFeature();
+        if (poFeatureRet != NULL)
+            return poFeatureRet;
+
+        CPLAcquireMutex(hSliceMutex, 1000.0);
+        if (psSlice->poReader->HasFailed())
+        {
+            /* do not return the records after a broken slice */
+            nCurrentSlice = (int)apoSlices.size();
+            bReadFailed = TRUE;
+        }
+        else
+            nCurrentSlice++;
+        delete psSlice->poReader;
+        psSlice->poReader = NULL;
+        CPLCondBroadcast(hSliceCond);
+        CPLReleaseMutex(hSliceMutex);
+    }
+
+    return NULL;
 }
-#else
-void OGRVFPLayer::LoadSchema()
+
+/************************************************************************/
+/*                              GetRTree()                              */
+/*                                                                      */
+/*      Spatial index of the layer. An up to date .vfpr file is         */
+/*      opened on the first call; if there is none it is built when     */
+/*      bBuild is set, unless SPATIAL_INDEX=NO.                         */
+/************************************************************************/
+
+OGRVFPRTree *OGRVFPLayer::GetRTree( bool bBuild )
+
 {
+    poDS->ScanSections();
+
+    if (poRTree != NULL || poFeatureDefn->GetGeomFieldCount() == 0 ||
+        poDS->GetSpatialIndexMode() == VFP_SPATIAL_INDEX_NO ||
+        psSection->nEnd <= psSection->nStart)
+        return poRTree;
+
+    if (!bRTreeChecked)
+    {
+        bRTreeChecked = TRUE;
+        poRTree = OGRVFPRTree::Open(osRTreeFilename, poDS->GetName(), psSection->nStart);
+    }
+
+    if (poRTree == NULL && bBuild && !bRTreeBuildFailed)
+    {
+        if (!BuildRTree())
+            bRTreeBuildFailed = TRUE;
+    }
+
+    return poRTree;
+}
+
+/************************************************************************/
+/*                            HasOpenRTree()                            */
+/*                                                                      */
+/*      Whether the spatial index is open, or can be opened without     */
+/*      locating the layer element first.                               */
+/************************************************************************/
+
+bool OGRVFPLayer::HasOpenRTree()
+
+{
+    if (poRTree != NULL)
+        return TRUE;
+    if (!poDS->SectionsScanned())
+        return FALSE;
+    return GetRTree(FALSE) != NULL;
+}
+
+/************************************************************************/
+/*                        PrepareSpatialIndex()                         */
+/************************************************************************/
+
+void OGRVFPLayer::PrepareSpatialIndex()
+
+{
+    GetRTree(TRUE);
+}
+
+/************************************************************************/
+/*                             BuildRTree()                             */
+/*                                                                      */
+/*      Parse the layer element once, collecting the byte range and     */
+/*      the envelope of each record without building its feature,       */
+/*      and write them to the .vfpr file. If it cannot be written       */
+/*      next to the data file, the index is kept in /vsimem/ for the    */
+/*      lifetime of the layer.                                          */
+/************************************************************************/
+
+bool OGRVFPLayer::BuildRTree()
+
+{
+    std::vector<OGRVFPRecordInfo> asRecords;
+    std::vector<CPLString> aosPaths;
+
+    OGRVFPReader oReader(this, 0);
+    oReader.SetScanMode(&asRecords, &aosPaths);
+    if (!oReader.Start(VSIFOpenL(poDS->GetName(), "r"), TRUE,
+                       psSection->nStart, psSection->nEnd, 0))
+        return FALSE;
+    while (!oReader.IsFinished())
+        oReader.ParseNextChunk();
+    if (oReader.HasFailed())
+        return FALSE;
+    oReader.Stop();
+
+    if (!OGRVFPRTree::Build(osRTreeFilename, poDS->GetName(), psSection->nStart,
+                            asRecords, aosPaths))
+    {
+        CPLDebug("VFP", "Cannot write %s, keeping the spatial index in memory",
+                 osRTreeFilename.c_str());
+        osRTreeFilename = CPLSPrintf("/vsimem/vfp_%p/%s", this,
+                                     CPLGetFilename(osRTreeFilename));
+        bRTreeInMemory = TRUE;
+        if (!OGRVFPRTree::Build(osRTreeFilename, poDS->GetName(), psSection->nStart,
+                                asRecords, aosPaths))
+            return FALSE;
+    }
+
+    poRTree = OGRVFPRTree::Open(osRTreeFilename, poDS->GetName(), psSection->nStart);
+
+    return poRTree != NULL;
+}
+
+/************************************************************************/
+/*                       GetNextIndexedFeature()                        */
+/*                                                                      */
+/*      With a spatial filter and a spatial index, only the records     */
+/*      whose envelope intersects the filter are parsed. Consecutive    */
+/*      candidate records are parsed as one range.                      */
+/************************************************************************/
+
+OGRFeature *OGRVFPLayer::GetNextIndexedFeature()
+{
+    if (!bCandidatesFetched)
+    {
+        bCandidatesFetched = TRUE;
+        iNextCandidate = 0;
+        if (!poRTree->Search(m_sFilterEnvelope, anCandidateFIDs))
+            anCandidateFIDs.resize(0);
+    }
+
+    while (TRUE)
+    {
+        if (poReader->IsStarted())
+        {
+            OGRFeature *poFeatureRet = poReader->GetNextQueuedFeature();
+            if (poFeatureRet != NULL)
+                return poFeatureRet;
+            if (!poReader->IsFinished())
+            {
+                poReader->ParseNextChunk();
+                continue;
+            }
+            if (poReader->HasFailed())
+                return NULL;
+        }
+
+        if (iNextCandidate >= anCandidateFIDs.size())
+            return NULL;
+
+        const GIntBig nFirstFID = anCandidateFIDs[iNextCandidate];
+        vsi_l_offset nStart = 0, nOffset = 0;
+        GUInt32 nSize = 0;
+        const char *pszPath = NULL, *pszNextPath = NULL;
+        if (!poRTree->GetRecord(nFirstFID, &nStart, &nSize, &pszPath))
+            return NULL;
+
+        vsi_l_offset nEnd = nStart + nSize;
+        for (iNextCandidate++; iNextCandidate < anCandidateFIDs.size(); iNextCandidate++)
+        {
+            if (anCandidateFIDs[iNextCandidate] != anCandidateFIDs[iNextCandidate - 1] + 1 ||
+                !poRTree->GetRecord(anCandidateFIDs[iNextCandidate],
+                                    &nOffset, &nSize, &pszNextPath) ||
+                strcmp(pszNextPath, pszPath) != 0)
+                break;
+            nEnd = nOffset + nSize;
+        }
+
+        poReader->Start(poDS->GetFile(), FALSE, nStart, nEnd, nFirstFID,
+                        GetOpenTags(pszPath), GetCloseTags(pszPath));
+    }
+}
+
+/************************************************************************/
+/*                           GetRecordRange()                           */
+/*                                                                      */
+/*      Byte range and enclosing elements of the record of nFID,        */
+/*      from the FID table of the layer or from its .vfpr file,         */
+/*      which holds the same table. Otherwise the table is extended     */
+/*      up to nFID.                                                     */
+/************************************************************************/
+
+bool OGRVFPLayer::GetRecordRange( GIntBig nFID, vsi_l_offset *pnOffset,
+                                  GUInt32 *pnSize, const char **ppszPath )
+
+{
+    poDS->ScanSections();
+
+    if (nFID < 0)
+        return FALSE;
+
+    if (nFID >= (GIntBig)asRecordRanges.size() && !bRecordRangesComplete)
+    {
+        OGRVFPRTree *poTree = GetRTree(FALSE);
+        if (poTree != NULL)
+            return poTree->GetRecord(nFID, pnOffset, pnSize, ppszPath);
+
+        ScanRecordRanges(nFID);
+    }
+
+    if (nFID >= (GIntBig)asRecordRanges.size())
+        return FALSE;
+
+    const OGRVFPRecordRange &sRange = asRecordRanges[(size_t)nFID];
+    *pnOffset = sRange.nOffset;
+    *pnSize = sRange.nSize;
+    *ppszPath = aosRecordPaths[sRange.iPath].c_str();
+    return TRUE;
+}
+
+/************************************************************************/
+/*                          ScanRecordRanges()                          */
+/*                                                                      */
+/*      Extend the FID table up to nFID, parsing the layer element      */
+/*      from the end of the last record known without building any      */
+/*      feature.                                                        */
+/************************************************************************/
+
+void OGRVFPLayer::ScanRecordRanges( GIntBig nFID )
+
+{
+    OGRVFPReader oReader(this, 0);
+    oReader.SetRecordRanges(&asRecordRanges, &aosRecordPaths, TRUE);
+
+    bool bStarted;
+    if (asRecordRanges.empty())
+        bStarted = oReader.Start(poDS->GetFile(), FALSE, psSection->nStart,
+                                 psSection->nEnd, 0);
+    else
+    {
+        const OGRVFPRecordRange &sLast = asRecordRanges.back();
+        bStarted = oReader.Start(poDS->GetFile(), FALSE,
+                                 sLast.nOffset + sLast.nSize, psSection->nEnd,
+                                 (GIntBig)asRecordRanges.size(),
+                                 GetOpenTags(aosRecordPaths[sLast.iPath]));
+    }
+    if (!bStarted)
+        return;
+
+    while (!oReader.IsFinished() && nFID >= (GIntBig)asRecordRanges.size())
+        oReader.ParseNextChunk();
+
+    if (oReader.IsFinished() && !oReader.HasFailed())
+        bRecordRangesComplete = TRUE;
+}
+
+/************************************************************************/
+/*                             GetFeature()                             */
+/*                                                                      */
+/*      Only the element of the record is parsed. The filters do not    */
+/*      apply and the sequential read is not disturbed.                 */
+/************************************************************************/
+
+OGRFeature *OGRVFPLayer::GetFeature( GIntBig nFID )
+
+{
+    poDS->ScanSections();
+    if (GetFeatureCache() != NULL)
+    {
+        bool bSkipped = FALSE, bError = FALSE;
+        OGRFeature *poFeature = poFeatureCache->GetFeature(nFID, poFeatureDefn, poSRS,
+                                                           NULL, &bSkipped, &bError);
+        if (bError)
+            CPLError(CE_Failure, CPLE_FileIO, "Cannot read feature " CPL_FRMT_GIB
+                     " from %s", nFID, osFeatureCacheFilename.c_str());
+        return poFeature;
+    }
+
+    vsi_l_offset nOffset = 0;
+    GUInt32 nSize = 0;
+    const char *pszPath = NULL;
+    if (!GetRecordRange(nFID, &nOffset, &nSize, &pszPath))
+        return NULL;
+
+    if (poRandomReader == NULL)
+    {
+        poRandomReader = new OGRVFPReader(this, 0);
+        poRandomReader->SetIgnoreFilters(TRUE);
+    }
+    if (!poRandomReader->Start(poDS->GetFile(), FALSE, nOffset, nOffset + nSize,
+                               nFID, GetOpenTags(pszPath), GetCloseTags(pszPath)))
+        return NULL;
+
+    OGRFeature *poFeature = NULL;
+    while (poFeature == NULL && !poRandomReader->IsFinished())
+    {
+        poRandomReader->ParseNextChunk();
+        poFeature = poRandomReader->GetNextQueuedFeature();
+    }
+    poRandomReader->Stop();
+
+    return poFeature;
+}
+
+/************************************************************************/
+/*                           SetNextByIndex()                           */
+/*                                                                      */
+/*      Without filters the index is the FID, the sequential read       */
+/*      then starts at the element of its record.                       */
+/************************************************************************/
+
+OGRErr OGRVFPLayer::SetNextByIndex( GIntBig nIndex )
+
+{
+    if (m_poFilterGeom != NULL || m_poAttrQuery != NULL)
+        return OGRLayer::SetNextByIndex(nIndex);
+
+    ResetReading();
+    if (nIndex == 0)
+        return OGRERR_NONE;
+
+    bCacheWritePending = FALSE;
+    poDS->ScanSections();
+    if (GetFeatureCache() != NULL)
+    {
+        if (nIndex < 0 || nIndex >= poFeatureCache->GetFeatureCount())
+            return OGRERR_FAILURE;
+        nNextCachedFID = nIndex;
+        return OGRERR_NONE;
+    }
+
+    vsi_l_offset nOffset = 0;
+    GUInt32 nSize = 0;
+    const char *pszPath = NULL;
+    if (!GetRecordRange(nIndex, &nOffset, &nSize, &pszPath))
+        return OGRERR_FAILURE;
+
+    nStartFID = nIndex;
+    nStartOffset = nOffset;
+    osStartPrefix = GetOpenTags(pszPath);
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                          SetSpatialFilter()                          */
+/*                                                                      */
+/*      OGRLayer::InstallFilter() replaces the filter geometry before   */
+/*      ResetReading() is called, while the slice and parser threads   */
+/*      may still read it. They are stopped first.                      */
+/************************************************************************/
+
+void OGRVFPLayer::SetSpatialFilter( OGRGeometry *poGeom )
+
+{
+    if (hParserThread != NULL || !apoSlices.empty())
+        ResetReading();
+    OGRLayer::SetSpatialFilter(poGeom);
+}
+
+void OGRVFPLayer::SetSpatialFilter( int iGeomField, OGRGeometry *poGeom )
+
+{
+    if (hParserThread != NULL || !apoSlices.empty())
+        ResetReading();
+    OGRLayer::SetSpatialFilter(iGeomField, poGeom);
+}
+
+/************************************************************************/
+/*                         SetAttributeFilter()                         */
+/*                                                                      */
+/*      The comparisons of a field with constants that are ANDed at     */
+/*      the top of the filter are handed to the readers, which drop     */
+/*      the records that fail them before building any feature. The     */
+/*      whole filter is still evaluated by GetNextFeature().            */
+/************************************************************************/
+
+OGRErr OGRVFPLayer::SetAttributeFilter( const char *pszQuery )
+
+{
+    /* resets the reading, so no reader uses the predicates below */
+    OGRErr eErr = OGRLayer::SetAttributeFilter(pszQuery);
+
+    asPredicates.resize(0);
+    if (eErr == OGRERR_NONE && m_poAttrQuery != NULL)
+    {
+        CompilePredicates((swq_expr_node *) m_poAttrQuery->GetSWQExpr());
+        CPLDebug("VFP", "%s: %d predicate(s) evaluated while parsing",
+                 GetName(), (int)asPredicates.size());
+    }
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                          SetIgnoredFields()                          */
+/*                                                                      */
+/*      The readers take the ignored fields and geometry from the       */
+/*      feature definition when they start, so the reading is reset     */
+/*      as for the filters.                                             */
+/************************************************************************/
+
+OGRErr OGRVFPLayer::SetIgnoredFields( const char **papszFields )
+
+{
+    OGRErr eErr = OGRLayer::SetIgnoredFields(papszFields);
+    ResetReading();
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                         CompilePredicates()                          */
+/************************************************************************/
+
+void OGRVFPLayer::CompilePredicates( swq_expr_node *poNode )
+
+{
+    if (poNode == NULL || poNode->eNodeType != SNT_OPERATION)
+        return;
+
+    if (poNode->nOperation == SWQ_AND)
+    {
+        for (int i = 0; i < poNode->nSubExprCount; i++)
+            CompilePredicates(poNode->papoSubExpr[i]);
+        return;
+    }
+
+    int nOperation = poNode->nOperation;
+    if (nOperation != SWQ_EQ && nOperation != SWQ_NE &&
+        nOperation != SWQ_LT && nOperation != SWQ_LE &&
+        nOperation != SWQ_GT && nOperation != SWQ_GE &&
+        nOperation != SWQ_IN && nOperation != SWQ_BETWEEN)
+        return;
+    if (poNode->nSubExprCount < 2)
+        return;
+    if (nOperation == SWQ_BETWEEN && poNode->nSubExprCount != 3)
+        return;
+
+    /* field on the left, or a binary comparison the other way round */
+    int iColumn = 0;
+    if (poNode->nSubExprCount == 2 &&
+        poNode->papoSubExpr[0]->eNodeType == SNT_CONSTANT &&
+        poNode->papoSubExpr[1]->eNodeType == SNT_COLUMN)
+    {
+        iColumn = 1;
+        if (nOperation == SWQ_LT) nOperation = SWQ_GT;
+        else if (nOperation == SWQ_GT) nOperation = SWQ_LT;
+        else if (nOperation == SWQ_LE) nOperation = SWQ_GE;
+        else if (nOperation == SWQ_GE) nOperation = SWQ_LE;
+    }
+
+    swq_expr_node *poColumn = poNode->papoSubExpr[iColumn];
+    if (poColumn->eNodeType != SNT_COLUMN || poColumn->table_index != 0 ||
+        poColumn->field_index < 0 ||
+        poColumn->field_index >= poFeatureDefn->GetFieldCount())
+        return;
+
+    OGRVFPPredicate oPredicate;
+    oPredicate.iField = poColumn->field_index;
+    oPredicate.eFieldType = poFeatureDefn->GetFieldDefn(oPredicate.iField)->GetType();
+    oPredicate.nOperation = nOperation;
+
+    const bool bString = oPredicate.eFieldType == OFTString;
+    if (!bString && oPredicate.eFieldType != OFTInteger &&
+        oPredicate.eFieldType != OFTInteger64 && oPredicate.eFieldType != OFTReal)
+        return;
+
+    for (int i = 0; i < poNode->nSubExprCount; i++)
+    {
+        if (i == iColumn)
+            continue;
+        swq_expr_node *poConstant = poNode->papoSubExpr[i];
+        if (poConstant->eNodeType != SNT_CONSTANT || poConstant->is_null)
+            return;
+
+        if (bString)
+        {
+            if (poConstant->field_type != SWQ_STRING)
+                return;
+            oPredicate.aosValues.push_back(poConstant->string_value);
+        }
+        else if (poConstant->field_type == SWQ_INTEGER ||
+                 poConstant->field_type == SWQ_INTEGER64)
+            oPredicate.adfValues.push_back((double)poConstant->int_value);
+        else if (poConstant->field_type == SWQ_FLOAT)
+            oPredicate.adfValues.push_back(poConstant->float_value);
+        else
+            return;
+    }
+
+    asPredicates.push_back(oPredicate);
+}
+
+/************************************************************************/
+/*                      OGRVFPPredicate::Evaluate()                     */
+/*                                                                      */
+/*      Same comparisons as the OGR SQL evaluator on the value that     */
+/*      the field gets. Empty values are let through, they are left     */
+/*      to the full filter.                                             */
+/************************************************************************/
+
+bool OGRVFPPredicate::Evaluate( const char *pszValue ) const
+
+{
+    if (pszValue[0] == '\0')
+        return TRUE;
+
+    if (eFieldType == OFTString)
+    {
+        switch (nOperation)
+        {
+            case SWQ_EQ:
+                return EQUAL(pszValue, aosValues[0]);
+            case SWQ_NE:
+                return !EQUAL(pszValue, aosValues[0]);
+            case SWQ_LT:
+                return strcmp(pszValue, aosValues[0]) < 0;
+            case SWQ_LE:
+                return strcmp(pszValue, aosValues[0]) <= 0;
+            case SWQ_GT:
+                return strcmp(pszValue, aosValues[0]) > 0;
+            case SWQ_GE:
+                return strcmp(pszValue, aosValues[0]) >= 0;
+            case SWQ_BETWEEN:
+                return strcmp(pszValue, aosValues[0]) >= 0 &&
+                       strcmp(pszValue, aosValues[1]) <= 0;
+            case SWQ_IN:
+                for (size_t i = 0; i < aosValues.size(); i++)
+                {
+                    if (EQUAL(pszValue, aosValues[i]))
+                        return TRUE;
+                }
+                return FALSE;
+            default:
+                return TRUE;
+        }
+    }
+
+    double dfValue;
+    if (eFieldType == OFTInteger)
+        dfValue = atoi(pszValue);
+    else if (eFieldType == OFTInteger64)
+        dfValue = (double)CPLAtoGIntBig(pszValue);
+    else
+        dfValue = CPLAtof(pszValue);
+
+    switch (nOperation)
+    {
+        case SWQ_EQ:
+            return dfValue == adfValues[0];
+        case SWQ_NE:
+            return dfValue != adfValues[0];
+        case SWQ_LT:
+            return dfValue < adfValues[0];
+        case SWQ_LE:
+            return dfValue <= adfValues[0];
+        case SWQ_GT:
+            return dfValue > adfValues[0];
+        case SWQ_GE:
+            return dfValue >= adfValues[0];
+        case SWQ_BETWEEN:
+            return dfValue >= adfValues[0] && dfValue <= adfValues[1];
+        case SWQ_IN:
+            for (size_t i = 0; i < adfValues.size(); i++)
+            {
+                if (dfValue == adfValues[i])
+                    return TRUE;
+            }
+            return FALSE;
+        default:
+            return TRUE;
+    }
+}
+
+/************************************************************************/
+/*                           CountFeatures()                            */
+/*                                                                      */
+/*      Parse the layer element once, counting the records and          */
+/*      merging the envelopes of their coordinates. Neither features    */
+/*      nor geometries are built. The result is kept by the             */
+/*      datasource in the section of the layer and in the .vfpi index.  */
+/************************************************************************/
+
+bool OGRVFPLayer::CountFeatures()
+
+{
+    OGRVFPReader oReader(this, 0);
+    oReader.SetCountMode();
+    oReader.SetIgnoreFilters(TRUE);
+    if (psSection->nEnd > psSection->nStart)
+    {
+        if (!oReader.Start(poDS->GetFile(), FALSE, psSection->nStart,
+                           psSection->nEnd, 0))
+            return FALSE;
+        while (!oReader.IsFinished())
+            oReader.ParseNextChunk();
+        if (oReader.HasFailed())
+            return FALSE;
+        oReader.Stop();
+        CPLDebug("VFP", "%s: " CPL_FRMT_GIB " features counted",
+                 GetName(), oReader.GetNextFID());
+    }
+
+    OGREnvelope sExtent;
+    const bool bHasExtent = oReader.GetCountExtent(&sExtent);
+    poDS->SetSectionStatistics(psSection, oReader.GetNextFID(),
+                               bHasExtent ? &sExtent : NULL);
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                          GetFeatureCount()                           */
+/*                                                                      */
+/*      Without filters, the records counted when the layer element     */
+/*      was located are returned. An index from an older version of     */
+/*      the driver may lack them, they are then counted once.           */
+/************************************************************************/
+
+GIntBig OGRVFPLayer::GetFeatureCount( int bForce )
+
+{
+    if (m_poFilterGeom != NULL || m_poAttrQuery != NULL)
+        return OGRLayer::GetFeatureCount(bForce);
+
+    poDS->ScanSections();
+    if (psSection->nFeatureCount < 0)
+    {
+        if (GetRTree(FALSE) != NULL)
+            return poRTree->GetFeatureCount();
+        if (!bForce || !CountFeatures())
+            return -1;
+    }
+
+    return psSection->nFeatureCount;
+}
+
+/************************************************************************/
+/*                             GetExtent()                              */
+/*                                                                      */
+/*      The extent is read from the .vfpi or the spatial index.         */
+/*      When neither has it and bForce is set, it is found by           */
+/*      CountFeatures(), which is cheaper than reading the features.    */
+/************************************************************************/
+
+OGRErr OGRVFPLayer::GetExtent( OGREnvelope *psExtent, int bForce )
+
+{
+    if (poFeatureDefn->GetGeomFieldCount() == 0)
+        return OGRERR_FAILURE;
+
+    poDS->ScanSections();
+    if (!psSection->bExtentScanned)
+    {
+        if (GetRTree(FALSE) != NULL)
+            return poRTree->GetExtent(psExtent) ? OGRERR_NONE : OGRERR_FAILURE;
+        if (!bForce || !CountFeatures())
+            return OGRERR_FAILURE;
+    }
+
+    if (!psSection->bHasExtent)
+        return OGRERR_FAILURE;
+    *psExtent = psSection->sExtent;
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                           TestCapability()                           */
+/************************************************************************/
+
+int OGRVFPLayer::TestCapability( const char * pszCap )
+{
+    if (EQUAL(pszCap, OLCStringsAsUTF8))
+        return TRUE;
+
+    /* answered from what is already known, a probe must not parse the
+       file nor write the .vfpi and .vfpr files */
+    if (EQUAL(pszCap, OLCFastSpatialFilter))
+        return HasOpenRTree();
+
+    /* known once the layer element is located, see GetFeatureCount() */
+    if (EQUAL(pszCap, OLCFastFeatureCount))
+    {
+        if (m_poFilterGeom != NULL || m_poAttrQuery != NULL)
+            return FALSE;
+        return (poDS->SectionsScanned() && psSection->nFeatureCount >= 0) ||
+               HasOpenRTree();
+    }
+
+    if (EQUAL(pszCap, OLCFastGetExtent))
+        return (poDS->SectionsScanned() && psSection->bExtentScanned) ||
+               HasOpenRTree();
+
+    if (EQUAL(pszCap, OLCCurveGeometries))
+        return TRUE;
+
+    if (EQUAL(pszCap, OLCIgnoreFields))
+        return TRUE;
+
+    if (EQUAL(pszCap, OLCRandomRead))
+        return TRUE;
+
+    if (EQUAL(pszCap, OLCFastSetNextByIndex))
+        return m_poFilterGeom == NULL && m_poAttrQuery == NULL;
+
+    return FALSE;
+}
+
+/************************************************************************/
+/*                       GetMetadataDomainList()                        */
+/************************************************************************/
+
+char **OGRVFPLayer::GetMetadataDomainList()
+{
+    return BuildMetadataDomainList(OGRLayer::GetMetadataDomainList(),
+                                   TRUE, "VFP_STATS", NULL);
+}
+
+/************************************************************************/
+/*                            GetMetadata()                             */
+/*                                                                      */
+/*      VFP_STATS: counters and timers of the readers of the layer so   */
+/*      far, refreshed by each call.                                    */
+/************************************************************************/
+
+char **OGRVFPLayer::GetMetadata( const char *pszDomain )
+{
+    if (pszDomain == NULL || !EQUAL(pszDomain, "VFP_STATS"))
+        return OGRLayer::GetMetadata(pszDomain);
+
+    OGRVFPStats sAllStats = sStats;
+    /* the reader of a PARSER_THREADS worker is only read by its thread */
+    if (hParserThread != NULL)
+    {
+        CPLAcquireMutex(hRingMutex, 1000.0);
+        OGRVFPAddStats(&sAllStats, &sParserThreadStats);
+        CPLReleaseMutex(hRingMutex);
+    }
+    else
+        OGRVFPAddStats(&sAllStats, poReader->GetStats());
+    if (poRandomReader != NULL)
+        OGRVFPAddStats(&sAllStats, poRandomReader->GetStats());
+
+    CSLDestroy(papszStatsMetadata);
+    papszStatsMetadata = OGRVFPStatsToList(&sAllStats, NULL);
+    return papszStatsMetadata;
+}
+
+/************************************************************************/
+/*                          GetMetadataItem()                           */
+/************************************************************************/
+
+const char *OGRVFPLayer::GetMetadataItem( const char *pszName,
+                                          const char *pszDomain )
+{
+    if (pszDomain == NULL || !EQUAL(pszDomain, "VFP_STATS"))
+        return OGRLayer::GetMetadataItem(pszName, pszDomain);
+
+    return CSLFetchNameValue(GetMetadata(pszDomain), pszName);
 }
-#endif
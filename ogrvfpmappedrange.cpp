@@ -0,0 +1,140 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  VFP Translator
+ * Purpose:  Implements OGRVFPMappedRange class.
+ * Author:   Martin Landa, landa.martin gmail.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, Martin Landa <landa.martin gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ogr_vfp.h"
+#include "cpl_conv.h"
+
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
+CPL_CVSID("$Id$");
+
+/* largest range mapped at once in a 32 bit address space */
+#define VFP_MAX_MAPPED_SIZE_32BIT (256 * 1024 * 1024)
+
+/************************************************************************/
+/*                         OGRVFPMappedRange()                          */
+/************************************************************************/
+
+OGRVFPMappedRange::OGRVFPMappedRange()
+{
+    psMem = NULL;
+    nStart = 0;
+    nEnd = 0;
+}
+
+/************************************************************************/
+/*                         ~OGRVFPMappedRange()                         */
+/************************************************************************/
+
+OGRVFPMappedRange::~OGRVFPMappedRange()
+
+{
+    Unmap();
+}
+
+/************************************************************************/
+/*                                Map()                                 */
+/*                                                                      */
+/*      Map the bytes from nStartIn to nEndIn of the file, or to its    */
+/*      end if it is shorter. The position of fp is not changed.        */
+/************************************************************************/
+
+bool OGRVFPMappedRange::Map( VSILFILE *fp, vsi_l_offset nStartIn,
+                             vsi_l_offset nEndIn )
+{
+    Unmap();
+
+    if( !CPLIsVirtualMemFileMapAvailable() ||
+        VSIFGetNativeFileDescriptorL(fp) == NULL )
+        return FALSE;
+
+    /* touching a mapped page past the end of the file is fatal */
+    const vsi_l_offset nSavedOffset = VSIFTellL(fp);
+    VSIFSeekL(fp, 0, SEEK_END);
+    const vsi_l_offset nFileSize = VSIFTellL(fp);
+    VSIFSeekL(fp, nSavedOffset, SEEK_SET);
+    if( nEndIn > nFileSize )
+        nEndIn = nFileSize;
+    if( nEndIn <= nStartIn )
+        return FALSE;
+    if( sizeof(void *) < 8 && nEndIn - nStartIn > VFP_MAX_MAPPED_SIZE_32BIT )
+        return FALSE;
+
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    psMem = CPLVirtualMemFileMapNew(fp, nStartIn, nEndIn - nStartIn,
+                                    VIRTUALMEM_READONLY, NULL, NULL);
+    CPLPopErrorHandler();
+    if( psMem == NULL )
+    {
+        CPLErrorReset();
+        return FALSE;
+    }
+
+    nStart = nStartIn;
+    nEnd = nEndIn;
+
+#if defined(HAVE_MMAP) && defined(MADV_SEQUENTIAL)
+    /* the range is parsed once from its start to its end: let the
+       kernel read ahead and drop the pages behind */
+    const GUIntBig nAddr = (GUIntBig)(size_t) CPLVirtualMemGetAddr(psMem);
+    const GUIntBig nPageStart = nAddr - nAddr % CPLGetPageSize();
+    madvise((void *)(size_t) nPageStart,
+            (size_t)(nAddr - nPageStart) + CPLVirtualMemGetSize(psMem),
+            MADV_SEQUENTIAL);
+#endif
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                               Unmap()                                */
+/************************************************************************/
+
+void OGRVFPMappedRange::Unmap()
+
+{
+    if( psMem != NULL )
+        CPLVirtualMemFree(psMem);
+    psMem = NULL;
+    nStart = 0;
+    nEnd = 0;
+}
+
+/************************************************************************/
+/*                              GetData()                               */
+/************************************************************************/
+
+const char *OGRVFPMappedRange::GetData( vsi_l_offset nOffset ) const
+{
+    if( psMem == NULL || nOffset < nStart || nOffset > nEnd )
+        return NULL;
+    return (const char *) CPLVirtualMemGetAddr(psMem) + (size_t)(nOffset - nStart);
+}
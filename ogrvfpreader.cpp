@@ -0,0 +1,934 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  VFP Translator
+ * Purpose:  Implements OGRVFPReader class.
+ * Author:   Martin Landa, landa.martin gmail.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, Martin Landa <landa.martin gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ogr_vfp.h"
+#include "cpl_conv.h"
+#include "cpl_string.h"
+
+CPL_CVSID("$Id$");
+
+/************************************************************************/
+/*                            OGRVFPReader()                            */
+/************************************************************************/
+
+OGRVFPReader::OGRVFPReader( OGRVFPLayer *poLayerIn, int nMaxQueuedFeatures )
+{
+    poLayer = poLayerIn;
+    poFeatureDefn = poLayer->poFeatureDefn;
+    nRecordDepth = poLayer->nRecordDepth;
+
+    fp = NULL;
+    bOwnFile = FALSE;
+
+    nEndOffset = 0;
+    nReadOffset = 0;
+    nReadChunkSize = poLayer->poDS->GetReadChunkSize();
+
+#ifdef HAVE_EXPAT
+    oParser = NULL;
+    bParserSuspended = FALSE;
+    bLastChunk = FALSE;
+#endif
+
+    bStarted = FALSE;
+    bEOF = FALSE;
+    nNextFID = 0;
+
+    nFeatureTabSize = nMaxQueuedFeatures;
+    nFeatureTabAlloc = 0;
+    ppoFeatureTab = NULL;
+    if (nFeatureTabSize > 0)
+    {
+        nFeatureTabAlloc = nFeatureTabSize;
+        ppoFeatureTab = (OGRFeature **) CPLMalloc(nFeatureTabAlloc * sizeof(OGRFeature*));
+    }
+    nFeatureTabLength = 0;
+    nFeatureTabIndex = 0;
+
+    bInRecord = FALSE;
+    pasAttrs = NULL;
+    nAttrs = 0;
+    poGeomBuilder = NULL;
+    if (poFeatureDefn->GetGeomFieldCount() > 0)
+        poGeomBuilder = new OGRVFPGeometryBuilder(poLayer->poDS->GetLinearize(),
+                                                  poLayer->poDS->GetMaxAngleStep(),
+                                                  &oArena);
+    bStats = poLayer->poDS->CollectStats();
+    OGRVFPResetStats(&sStats);
+    bIgnoreAllFields = FALSE;
+    bIgnoreGeometry = FALSE;
+    bIgnoreFilters = FALSE;
+    bFilterGeom = FALSE;
+    pasPredicates = NULL;
+    bSkipRecord = FALSE;
+
+    pasRecordInfo = NULL;
+    poArrowBatch = NULL;
+    nArrowBatchSize = 0;
+    poArrowFilterGeom = NULL;
+    bArrowFilterIsEnvelope = FALSE;
+    poArrowAttrQuery = NULL;
+    bCountOnly = FALSE;
+    bHasCountExtent = FALSE;
+    pasRecordRanges = NULL;
+    bRecordRangesOnly = FALSE;
+    paosRecordPaths = NULL;
+    iRecordPath = -1;
+    nHeadOffset = 0;
+    nRecordOffset = 0;
+    nRecordTagEnd = 0;
+
+    bStopParsing = FALSE;
+    bError = FALSE;
+    nWithoutEventCounter = 0;
+    nDataHandlerCounter = 0;
+    depthLevel = 0;
+}
+
+/************************************************************************/
+/*                           ~OGRVFPReader()                            */
+/************************************************************************/
+
+OGRVFPReader::~OGRVFPReader()
+
+{
+    Stop();
+    CPLFree(ppoFeatureTab);
+    delete poGeomBuilder;
+    delete poArrowFilterGeom;
+    delete poArrowAttrQuery;
+
+    if (sStats.nFeaturesBuilt > 0)
+        CPLDebug("VFP", "%s: " CPL_FRMT_GIB " features built, arena of %d bytes "
+                 "allocated " CPL_FRMT_GIB " times",
+                 poLayer->GetName(), sStats.nFeaturesBuilt,
+                 (int)oArena.GetSize(), oArena.GetBlockAllocs());
+
+    poLayer->AddStats(&sStats);
+}
+
+/************************************************************************/
+/*                                Stop()                                */
+/*                                                                      */
+/*      Discard the parser and the features not fetched yet.            */
+/************************************************************************/
+
+void OGRVFPReader::Stop()
+
+{
+#ifdef HAVE_EXPAT
+    if (oParser)
+        XML_ParserFree(oParser);
+    oParser = NULL;
+    bParserSuspended = FALSE;
+    bLastChunk = FALSE;
+#endif
+
+    for( int i = nFeatureTabIndex; i < nFeatureTabLength; i++ )
+        delete ppoFeatureTab[i];
+    nFeatureTabIndex = 0;
+    nFeatureTabLength = 0;
+
+    bInRecord = FALSE;
+    bSkipRecord = FALSE;
+    if (poGeomBuilder)
+        poGeomBuilder->Reset();
+    aosPath.resize(0);
+    iRecordPath = -1;
+
+    oMappedRange.Unmap();
+    if (fp && bOwnFile)
+        VSIFCloseL(fp);
+    fp = NULL;
+    bOwnFile = FALSE;
+
+    bStarted = FALSE;
+    bEOF = FALSE;
+    bStopParsing = FALSE;
+    bError = FALSE;
+    depthLevel = 0;
+}
+
+/************************************************************************/
+/*                            SetScanMode()                             */
+/*                                                                      */
+/*      Instead of features, append the byte range and the envelope     */
+/*      of each record to pasRecordInfoIn. The enclosing elements of    */
+/*      the records, e.g. "zs/plins", are stored in paosRecordPathsIn.  */
+/************************************************************************/
+
+void OGRVFPReader::SetScanMode( std::vector<OGRVFPRecordInfo> *pasRecordInfoIn,
+                                std::vector<CPLString> *paosRecordPathsIn )
+
+{
+    pasRecordInfo = pasRecordInfoIn;
+    paosRecordPaths = paosRecordPathsIn;
+}
+
+/************************************************************************/
+/*                          SetRecordRanges()                           */
+/*                                                                      */
+/*      Append the byte range of each record whose FID is the size of   */
+/*      pasRecordRangesIn, so that records parsed again or out of       */
+/*      order are ignored. With bRecordRangesOnlyIn no feature is       */
+/*      built.                                                          */
+/************************************************************************/
+
+void OGRVFPReader::SetRecordRanges( std::vector<OGRVFPRecordRange> *pasRecordRangesIn,
+                                    std::vector<CPLString> *paosRecordPathsIn,
+                                    bool bRecordRangesOnlyIn )
+
+{
+    pasRecordRanges = pasRecordRangesIn;
+    paosRecordPaths = paosRecordPathsIn;
+    bRecordRangesOnly = bRecordRangesOnlyIn;
+}
+
+/************************************************************************/
+/*                        GetNextQueuedFeature()                        */
+/************************************************************************/
+
+OGRFeature *OGRVFPReader::GetNextQueuedFeature()
+
+{
+    if (nFeatureTabIndex < nFeatureTabLength)
+        return ppoFeatureTab[nFeatureTabIndex++];
+
+    nFeatureTabIndex = 0;
+    nFeatureTabLength = 0;
+
+    return NULL;
+}
+
+/************************************************************************/
+/*                           GetCountExtent()                           */
+/*                                                                      */
+/*      Envelope of the records counted in count mode, FALSE if none    */
+/*      of them has coordinates.                                        */
+/************************************************************************/
+
+bool OGRVFPReader::GetCountExtent( OGREnvelope *psExtent )
+{
+    if (!bHasCountExtent)
+        return FALSE;
+    *psExtent = sCountExtent;
+    return TRUE;
+}
+
+#ifdef HAVE_EXPAT
+
+static void XMLCALL startElementCbk(void *pUserData, const char *pszName, const char **ppszAttr)
+{
+    ((OGRVFPReader*)pUserData)->startElementCbk(pszName, ppszAttr);
+}
+
+static void XMLCALL endElementCbk(void *pUserData, const char *pszName)
+{
+    ((OGRVFPReader*)pUserData)->endElementCbk(pszName);
+}
+
+static void XMLCALL dataHandlerCbk(void *pUserData, const char *data, int nLen)
+{
+    ((OGRVFPReader*)pUserData)->dataHandlerCbk(data, nLen);
+}
+
+/* with STATS=YES only, so that the handlers are not timed otherwise */
+static void XMLCALL startElementStatsCbk(void *pUserData, const char *pszName, const char **ppszAttr)
+{
+    ((OGRVFPReader*)pUserData)->startElementStatsCbk(pszName, ppszAttr);
+}
+
+static void XMLCALL endElementStatsCbk(void *pUserData, const char *pszName)
+{
+    ((OGRVFPReader*)pUserData)->endElementStatsCbk(pszName);
+}
+
+#endif
+
+/************************************************************************/
+/*                               Start()                                */
+/*                                                                      */
+/*      Prepare parsing of [nStart, nEnd). pszPrefix and pszSuffix      */
+/*      open and close the elements enclosing the range when it does    */
+/*      not cover the whole layer element. The file handle is closed    */
+/*      by Stop() if bOwnFileIn is set, even when Start() fails.        */
+/*      Otherwise it is the handle shared by the layers of the          */
+/*      datasource, read with OGRVFPDataSource::ReadFile().             */
+/************************************************************************/
+
+bool OGRVFPReader::Start( VSILFILE *fpIn, bool bOwnFileIn,
+                          vsi_l_offset nStart, vsi_l_offset nEnd,
+                          GIntBig nFirstFID,
+                          const char *pszPrefix, const char *pszSuffix )
+{
+    Stop();
+
+    fp = fpIn;
+    bOwnFile = bOwnFileIn;
+    bStarted = TRUE;
+    nNextFID = nFirstFID;
+
+    /* the layer stops its readers before its filters change, see
+       OGRVFPLayer::SetSpatialFilter(); an Arrow stream has its own
+       copy of them */
+    const std::vector<OGRVFPPredicate> &asPredicates =
+        poArrowBatch != NULL ? asArrowPredicates : poLayer->asPredicates;
+    if (poArrowBatch != NULL)
+    {
+        bFilterGeom = !bIgnoreFilters && poArrowFilterGeom != NULL;
+        if (bFilterGeom)
+            poArrowFilterGeom->getEnvelope(&sFilterEnvelope);
+    }
+    else
+    {
+        bFilterGeom = !bIgnoreFilters && poLayer->m_poFilterGeom != NULL;
+        sFilterEnvelope = poLayer->m_sFilterEnvelope;
+    }
+    pasPredicates = (!bIgnoreFilters && pasRecordInfo == NULL &&
+                     !bRecordRangesOnly && !asPredicates.empty()) ?
+        &asPredicates : NULL;
+
+    /* and so does the projection, see OGRVFPLayer::SetIgnoredFields() */
+    abIgnoredFields.resize(poFeatureDefn->GetFieldCount());
+    bIgnoreAllFields = TRUE;
+    for (int i = 0; i < poFeatureDefn->GetFieldCount(); i++)
+    {
+        abIgnoredFields[i] = poFeatureDefn->GetFieldDefn(i)->IsIgnored() != FALSE;
+        if (!abIgnoredFields[i])
+            bIgnoreAllFields = FALSE;
+    }
+    /* the envelopes are still needed by the spatial filter and the scans */
+    bIgnoreGeometry = poFeatureDefn->IsGeometryIgnored() && !bFilterGeom &&
+                      pasRecordInfo == NULL && !bCountOnly;
+
+#ifdef HAVE_EXPAT
+    if (fp == NULL || nEnd <= nStart)
+    {
+        bError = (fp == NULL);
+        bStopParsing = TRUE;
+        return FALSE;
+    }
+
+    oParser = OGRCreateExpatXMLParser();
+    if (bStats)
+        XML_SetElementHandler(oParser, ::startElementStatsCbk, ::endElementStatsCbk);
+    else
+        XML_SetElementHandler(oParser, ::startElementCbk, ::endElementCbk);
+    XML_SetCharacterDataHandler(oParser, ::dataHandlerCbk);
+    XML_SetUserData(oParser, this);
+
+    /* the range is parsed as a document on its own, keep the
+       encoding of the whole file */
+    CPLString osHead;
+    if (poLayer->poDS->GetEncoding() != NULL)
+        osHead.Printf("<?xml version=\"1.0\" encoding=\"%s\"?>",
+                      poLayer->poDS->GetEncoding());
+    if (pszPrefix)
+        osHead += pszPrefix;
+    if (!osHead.empty())
+        XML_Parse(oParser, osHead.c_str(), (int)osHead.size(), XML_FALSE);
+    nHeadOffset = (GIntBig)nStart - (GIntBig)osHead.size();
+    osSuffix = pszSuffix ? pszSuffix : "";
+
+    if (bOwnFile)
+        VSIFSeekL( fp, nStart, SEEK_SET );
+    nReadOffset = nStart;
+    nEndOffset = nEnd;
+    if (poLayer->poDS->UseMmap() &&
+        (bOwnFile ? oMappedRange.Map(fp, nStart, nEnd) :
+                    poLayer->poDS->MapFile(&oMappedRange, nStart, nEnd)))
+        nEndOffset = oMappedRange.GetEnd();
+
+    nWithoutEventCounter = 0;
+
+    return TRUE;
+#else
+    bStopParsing = TRUE;
+    return FALSE;
+#endif
+}
+
+#ifdef HAVE_EXPAT
+
+/************************************************************************/
+/*                           ParseNextChunk()                           */
+/************************************************************************/
+
+void OGRVFPReader::ParseNextChunk()
+{
+    XML_Status eStatus;
+
+    if (bStopParsing)
+        return;
+
+    nDataHandlerCounter = 0;
+    GIntBig nParseStart = 0;
+
+    if (bParserSuspended)
+    {
+        bParserSuspended = FALSE;
+        if (bStats)
+            nParseStart = OGRVFPGetTimeNs();
+        eStatus = XML_ResumeParser(oParser);
+    }
+    else if (bLastChunk)
+    {
+        bStopParsing = TRUE;
+        return;
+    }
+    else if (bEOF || nReadOffset >= nEndOffset)
+    {
+        bLastChunk = TRUE;
+        if (bStats)
+            nParseStart = OGRVFPGetTimeNs();
+        eStatus = XML_Parse(oParser, osSuffix.c_str(), (int)osSuffix.size(), XML_TRUE);
+    }
+    else if (oMappedRange.IsMapped())
+    {
+        int nToRead = nReadChunkSize;
+        if (nEndOffset - nReadOffset < (vsi_l_offset)nToRead)
+            nToRead = (int)(nEndOffset - nReadOffset);
+
+        const char *pszData = oMappedRange.GetData(nReadOffset);
+        nReadOffset += nToRead;
+        sStats.nBytesMapped += nToRead;
+
+        if (bStats)
+            nParseStart = OGRVFPGetTimeNs();
+        eStatus = XML_Parse(oParser, pszData, nToRead, XML_FALSE);
+        nWithoutEventCounter ++;
+    }
+    else
+    {
+        int nToRead = nReadChunkSize;
+        if (nEndOffset - nReadOffset < (vsi_l_offset)nToRead)
+            nToRead = (int)(nEndOffset - nReadOffset);
+
+        void *pBuf = XML_GetBuffer(oParser, nToRead);
+        if (pBuf == NULL)
+        {
+            CPLError(CE_Failure, CPLE_OutOfMemory,
+                     "Cannot allocate XML parser buffer");
+            bError = TRUE;
+            bStopParsing = TRUE;
+            return;
+        }
+
+        if (bStats)
+            nParseStart = OGRVFPGetTimeNs();
+        int nLen = bOwnFile ? (int)VSIFReadL( pBuf, 1, nToRead, fp ) :
+                   poLayer->poDS->ReadFile( nReadOffset, pBuf, nToRead );
+        nReadOffset += nLen;
+        bEOF = (nLen < nToRead);
+        sStats.nBytesRead += nLen;
+        sStats.nReadCalls++;
+        if (bStats)
+        {
+            const GIntBig nReadEnd = OGRVFPGetTimeNs();
+            sStats.nReadNs += nReadEnd - nParseStart;
+            nParseStart = nReadEnd;
+        }
+
+        eStatus = XML_ParseBuffer(oParser, nLen, XML_FALSE);
+        nWithoutEventCounter ++;
+    }
+
+    if (bStats)
+        sStats.nExpatNs += OGRVFPGetTimeNs() - nParseStart;
+
+    if (eStatus == XML_STATUS_ERROR)
+    {
+        /* parsing stopped on purpose, the reason was already reported */
+        if (bStopParsing)
+            return;
+
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "XML parsing of VFP file failed : %s at line %d, column %d",
+                 XML_ErrorString(XML_GetErrorCode(oParser)),
+                 (int)XML_GetCurrentLineNumber(oParser),
+                 (int)XML_GetCurrentColumnNumber(oParser));
+        bError = TRUE;
+        bStopParsing = TRUE;
+    }
+    else if (eStatus == XML_STATUS_SUSPENDED)
+    {
+        bParserSuspended = TRUE;
+    }
+    else if (nWithoutEventCounter == 10)
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Too much data inside one element. File probably corrupted");
+        bError = TRUE;
+        bStopParsing = TRUE;
+    }
+}
+
+/************************************************************************/
+/*                          startElementCbk()                           */
+/************************************************************************/
+
+void OGRVFPReader::startElementCbk(const char *pszName,
+                                   const char **ppszAttr)
+{
+    if (bStopParsing) return;
+
+    nWithoutEventCounter = 0;
+
+    if (paosRecordPaths != NULL && depthLevel < nRecordDepth)
+    {
+        aosPath.push_back(pszName);
+        iRecordPath = -1;
+    }
+
+    if (depthLevel == nRecordDepth)
+    {
+        const GIntBig nStart = bStats ? OGRVFPGetTimeNs() : 0;
+        bInRecord = TRUE;
+        bSkipRecord = bRecordRangesOnly;
+        if (paosRecordPaths != NULL)
+        {
+            const XML_Index nIndex = XML_GetCurrentByteIndex(oParser);
+            nRecordOffset = GetFileOffset(nIndex);
+            nRecordTagEnd = GetFileOffset(nIndex + XML_GetCurrentByteCount(oParser));
+        }
+        oArena.Reset();
+        int nMaxAttrs = 0;
+        while (ppszAttr[2 * nMaxAttrs] != NULL)
+            nMaxAttrs++;
+        pasAttrs = (OGRVFPAttribute *) oArena.Alloc(nMaxAttrs * sizeof(OGRVFPAttribute));
+        nAttrs = 0;
+        /* the predicates may test ignored fields */
+        const bool bReadAttrs = !bSkipRecord && !bCountOnly &&
+                                (!bIgnoreAllFields || pasPredicates != NULL);
+        for (int i = 0; bReadAttrs && ppszAttr[i] != NULL; i += 2)
+        {
+            const int iField =
+                poLayer->anFieldByToken[OGRVFPGetToken(ppszAttr[i])];
+            if (iField >= 0)
+            {
+                /* skip the record before anything is built for it */
+                if (pasPredicates != NULL && !EvaluatePredicates(iField, ppszAttr[i + 1]))
+                {
+                    bSkipRecord = TRUE;
+                    break;
+                }
+                if (abIgnoredFields[iField])
+                    continue;
+                pasAttrs[nAttrs].iField = iField;
+                pasAttrs[nAttrs].pszValue = oArena.Strdup(ppszAttr[i + 1]);
+                nAttrs++;
+            }
+        }
+        if (poGeomBuilder)
+            poGeomBuilder->Reset();
+        if (bStats)
+            sStats.nAttributesNs += OGRVFPGetTimeNs() - nStart;
+    }
+
+    if (depthLevel >= nRecordDepth && bInRecord && !bSkipRecord &&
+        !bIgnoreGeometry && poGeomBuilder)
+    {
+        const GIntBig nStart = bStats ? OGRVFPGetTimeNs() : 0;
+        poGeomBuilder->StartElement(OGRVFPGetToken(pszName), ppszAttr);
+        if (bStats)
+            sStats.nCoordinatesNs += OGRVFPGetTimeNs() - nStart;
+    }
+
+    depthLevel++;
+}
+
+/************************************************************************/
+/*                           endElementCbk()                            */
+/************************************************************************/
+
+void OGRVFPReader::endElementCbk(const char *pszName)
+{
+    if (bStopParsing) return;
+
+    nWithoutEventCounter = 0;
+
+    depthLevel--;
+
+    if (paosRecordPaths != NULL && depthLevel < nRecordDepth && !aosPath.empty())
+    {
+        aosPath.pop_back();
+        iRecordPath = -1;
+    }
+
+    if (depthLevel >= nRecordDepth && bInRecord && !bSkipRecord &&
+        !bIgnoreGeometry && poGeomBuilder)
+    {
+        const GIntBig nStart = bStats ? OGRVFPGetTimeNs() : 0;
+        poGeomBuilder->EndElement(OGRVFPGetToken(pszName));
+        if (bStats)
+            sStats.nCoordinatesNs += OGRVFPGetTimeNs() - nStart;
+    }
+
+    if (depthLevel == nRecordDepth && bInRecord)
+    {
+        bInRecord = FALSE;
+        sStats.nRecords++;
+
+        if (bCountOnly)
+        {
+            OGREnvelope sEnvelope;
+            if (poGeomBuilder != NULL && poGeomBuilder->GetEnvelope(&sEnvelope))
+            {
+                if (bHasCountExtent)
+                    sCountExtent.Merge(sEnvelope);
+                else
+                    sCountExtent = sEnvelope;
+                bHasCountExtent = TRUE;
+            }
+            nNextFID++;
+            if (poGeomBuilder)
+                poGeomBuilder->Reset();
+            return;
+        }
+
+        if (pasRecordInfo != NULL)
+        {
+            AddRecordInfo();
+            nNextFID++;
+            if (poGeomBuilder)
+                poGeomBuilder->Reset();
+            return;
+        }
+
+        /* the record keeps its FID even if it is filtered out */
+        const GIntBig nFID = nNextFID++;
+        if (pasRecordRanges != NULL && nFID == (GIntBig)pasRecordRanges->size())
+        {
+            OGRVFPRecordRange sRange;
+            GetRecordRange(&sRange);
+            pasRecordRanges->push_back(sRange);
+        }
+
+        bool bSkip = bSkipRecord;
+        if (!bSkip && bFilterGeom)
+        {
+            const GIntBig nStart = bStats ? OGRVFPGetTimeNs() : 0;
+            bSkip = poGeomBuilder == NULL ||
+                    !poGeomBuilder->Intersects(sFilterEnvelope);
+            if (bStats)
+                sStats.nFilterNs += OGRVFPGetTimeNs() - nStart;
+        }
+        if (bSkip)
+        {
+            sStats.nRecordsSkipped++;
+            if (poGeomBuilder)
+                poGeomBuilder->Reset();
+            return;
+        }
+
+        if (poArrowBatch != NULL)
+        {
+            AddArrowRecord(nFID);
+            return;
+        }
+
+        GIntBig nStart = bStats ? OGRVFPGetTimeNs() : 0;
+        OGRGeometry *poGeom = NULL;
+        if (poGeomBuilder && !bIgnoreGeometry)
+        {
+            poGeom = poGeomBuilder->GetGeometry();
+            if (bStats)
+            {
+                const GIntBig nEnd = OGRVFPGetTimeNs();
+                sStats.nGeometryNs += nEnd - nStart;
+                nStart = nEnd;
+            }
+        }
+
+        OGRFeature *poFeature = new OGRFeature(poFeatureDefn);
+        poFeature->SetFID(nFID);
+        SetFields(poFeature);
+        if (poGeom)
+        {
+            poGeom->assignSpatialReference(poLayer->poSRS);
+            poFeature->SetGeometryDirectly(poGeom);
+        }
+
+        if (nFeatureTabLength == nFeatureTabAlloc)
+        {
+            nFeatureTabAlloc = nFeatureTabAlloc * 2 + 64;
+            ppoFeatureTab = (OGRFeature **)
+                CPLRealloc(ppoFeatureTab, nFeatureTabAlloc * sizeof(OGRFeature*));
+        }
+        ppoFeatureTab[nFeatureTabLength++] = poFeature;
+        sStats.nFeaturesBuilt++;
+        if (bStats)
+            sStats.nFeatureNs += OGRVFPGetTimeNs() - nStart;
+
+        if (nFeatureTabLength == nFeatureTabSize)
+            XML_StopParser(oParser, XML_TRUE);
+    }
+}
+
+/************************************************************************/
+/*                        startElementStatsCbk()                        */
+/*                                                                      */
+/*      Handlers installed with STATS=YES: the events are counted and   */
+/*      the time spent in the handlers is taken out of the expat time.  */
+/************************************************************************/
+
+void OGRVFPReader::startElementStatsCbk(const char *pszName,
+                                        const char **ppszAttr)
+{
+    const GIntBig nStart = OGRVFPGetTimeNs();
+    startElementCbk(pszName, ppszAttr);
+    sStats.nXMLEvents++;
+    sStats.nHandlersNs += OGRVFPGetTimeNs() - nStart;
+}
+
+/************************************************************************/
+/*                         endElementStatsCbk()                         */
+/************************************************************************/
+
+void OGRVFPReader::endElementStatsCbk(const char *pszName)
+{
+    const GIntBig nStart = OGRVFPGetTimeNs();
+    endElementCbk(pszName);
+    sStats.nXMLEvents++;
+    sStats.nHandlersNs += OGRVFPGetTimeNs() - nStart;
+}
+
+/************************************************************************/
+/*                             SetFields()                              */
+/************************************************************************/
+
+void OGRVFPReader::SetFields( OGRFeature *poFeature )
+{
+    for (int i = 0; i < nAttrs; i++)
+    {
+        /* an empty value of a numeric field is left unset, not 0 */
+        const char *pszValue = pasAttrs[i].pszValue;
+        if (pszValue[0] != '\0' ||
+            poFeatureDefn->GetFieldDefn(pasAttrs[i].iField)->GetType() == OFTString)
+            poFeature->SetField(pasAttrs[i].iField, pszValue);
+    }
+}
+
+/************************************************************************/
+/*                           SetArrowBatch()                            */
+/*                                                                      */
+/*      Switch to Arrow mode, copying the filters of the layer so that  */
+/*      the stream is not affected by their later changes.              */
+/************************************************************************/
+
+void OGRVFPReader::SetArrowBatch( OGRVFPArrowBatch *poArrowBatchIn, int nBatchSize )
+{
+    poArrowBatch = poArrowBatchIn;
+    nArrowBatchSize = nBatchSize;
+
+    delete poArrowFilterGeom;
+    poArrowFilterGeom = poLayer->m_poFilterGeom != NULL ?
+        poLayer->m_poFilterGeom->clone() : NULL;
+    bArrowFilterIsEnvelope = poLayer->m_bFilterIsEnvelope != FALSE;
+
+    delete poArrowAttrQuery;
+    poArrowAttrQuery = NULL;
+    if (poLayer->m_poAttrQuery != NULL && poLayer->m_pszAttrQueryString != NULL)
+    {
+        poArrowAttrQuery = new OGRFeatureQuery();
+        if (poArrowAttrQuery->Compile(poFeatureDefn,
+                                      poLayer->m_pszAttrQueryString) != OGRERR_NONE)
+        {
+            delete poArrowAttrQuery;
+            poArrowAttrQuery = NULL;
+        }
+    }
+
+    asArrowPredicates = poLayer->asPredicates;
+}
+
+/************************************************************************/
+/*                        FilterArrowGeometry()                         */
+/*                                                                      */
+/*      OGRLayer::FilterGeometry() with the copy of the filter.         */
+/************************************************************************/
+
+bool OGRVFPReader::FilterArrowGeometry( OGRGeometry *poGeom )
+{
+    if (poGeom == NULL || poGeom->IsEmpty())
+        return FALSE;
+
+    OGREnvelope sEnvelope;
+    poGeom->getEnvelope(&sEnvelope);
+    if (!sEnvelope.Intersects(sFilterEnvelope))
+        return FALSE;
+
+    if (bArrowFilterIsEnvelope &&
+        sEnvelope.MinX >= sFilterEnvelope.MinX &&
+        sEnvelope.MinY >= sFilterEnvelope.MinY &&
+        sEnvelope.MaxX <= sFilterEnvelope.MaxX &&
+        sEnvelope.MaxY <= sFilterEnvelope.MaxY)
+        return TRUE;
+
+    if (!OGRGeometryFactory::haveGEOS())
+        return TRUE;
+
+    return poArrowFilterGeom->Intersects(poGeom) != FALSE;
+}
+
+/************************************************************************/
+/*                           AddArrowRecord()                           */
+/*                                                                      */
+/*      Called at the end tag of a record in Arrow mode, once its       */
+/*      envelope passed the spatial filter. The parts of the filters    */
+/*      left to OGR by GetNextFeature() are applied here. A feature     */
+/*      is only built to evaluate an attribute filter.                  */
+/************************************************************************/
+
+void OGRVFPReader::AddArrowRecord( GIntBig nFID )
+{
+    OGRGeometry *poGeom = NULL;
+    if (poGeomBuilder && !bIgnoreGeometry)
+        poGeom = poGeomBuilder->GetGeometry();
+
+    bool bMatch = !bFilterGeom || FilterArrowGeometry(poGeom);
+    if (bMatch && !bIgnoreFilters && poArrowAttrQuery != NULL)
+    {
+        OGRFeature oFeature(poFeatureDefn);
+        oFeature.SetFID(nFID);
+        SetFields(&oFeature);
+        bMatch = poArrowAttrQuery->Evaluate(&oFeature) != FALSE;
+    }
+
+    if (bMatch)
+        poArrowBatch->AddRecord(nFID, pasAttrs, nAttrs, poGeom);
+    delete poGeom;
+
+    if (poArrowBatch->GetLength() >= nArrowBatchSize)
+        XML_StopParser(oParser, XML_TRUE);
+}
+
+/************************************************************************/
+/*                         EvaluatePredicates()                         */
+/************************************************************************/
+
+bool OGRVFPReader::EvaluatePredicates(int iField, const char *pszValue)
+{
+    for (size_t i = 0; i < pasPredicates->size(); i++)
+    {
+        const OGRVFPPredicate &oPredicate = (*pasPredicates)[i];
+        if (oPredicate.iField == iField && !oPredicate.Evaluate(pszValue))
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/************************************************************************/
+/*                           GetRecordRange()                           */
+/*                                                                      */
+/*      Called at the end tag of a record. The end tag of an empty      */
+/*      element has no bytes of its own, the record is then its start   */
+/*      tag.                                                            */
+/************************************************************************/
+
+void OGRVFPReader::GetRecordRange( OGRVFPRecordRange *psRange )
+{
+    const int nCount = XML_GetCurrentByteCount(oParser);
+    const vsi_l_offset nRecordEnd = nCount > 0 ?
+        GetFileOffset(XML_GetCurrentByteIndex(oParser) + nCount) : nRecordTagEnd;
+
+    if (iRecordPath < 0)
+    {
+        CPLString osPath;
+        for (size_t i = 0; i < aosPath.size(); i++)
+        {
+            if (i > 0)
+                osPath += "/";
+            osPath += aosPath[i];
+        }
+        for (size_t i = 0; i < paosRecordPaths->size() && iRecordPath < 0; i++)
+        {
+            if ((*paosRecordPaths)[i] == osPath)
+                iRecordPath = (int)i;
+        }
+        if (iRecordPath < 0)
+        {
+            iRecordPath = (int)paosRecordPaths->size();
+            paosRecordPaths->push_back(osPath);
+        }
+    }
+
+    psRange->nOffset = nRecordOffset;
+    psRange->nSize = (GUInt32)(nRecordEnd - nRecordOffset);
+    psRange->iPath = (GUInt32)iRecordPath;
+}
+
+/************************************************************************/
+/*                           AddRecordInfo()                            */
+/*                                                                      */
+/*      Called at the end tag of a record in scan mode.                 */
+/************************************************************************/
+
+void OGRVFPReader::AddRecordInfo()
+{
+    OGRVFPRecordRange sRange;
+    GetRecordRange(&sRange);
+
+    OGRVFPRecordInfo sInfo;
+    sInfo.nOffset = sRange.nOffset;
+    sInfo.nSize = sRange.nSize;
+    sInfo.iPath = sRange.iPath;
+    sInfo.bHasEnvelope = poGeomBuilder != NULL &&
+                         poGeomBuilder->GetEnvelope(&sInfo.sEnvelope);
+    pasRecordInfo->push_back(sInfo);
+}
+
+/************************************************************************/
+/*                           dataHandlerCbk()                           */
+/************************************************************************/
+
+void OGRVFPReader::dataHandlerCbk(CPL_UNUSED const char *data,
+                                  CPL_UNUSED int nLen)
+{
+    if (bStopParsing) return;
+
+    nDataHandlerCounter ++;
+    if (nDataHandlerCounter >= nReadChunkSize)
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "File probably corrupted (million laugh pattern)");
+        XML_StopParser(oParser, XML_FALSE);
+        bError = TRUE;
+        bStopParsing = TRUE;
+    }
+}
+
+#else
+
+void OGRVFPReader::ParseNextChunk()
+{
+    bStopParsing = TRUE;
+}
+
+#endif
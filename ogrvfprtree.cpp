@@ -0,0 +1,612 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  VFP Translator
+ * Purpose:  Implements OGRVFPRTree class.
+ * Author:   Martin Landa, landa.martin gmail.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, Martin Landa <landa.martin gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ogr_vfp.h"
+#include "cpl_conv.h"
+#include "cpl_string.h"
+
+#include <algorithm>
+
+CPL_CVSID("$Id$");
+
+/*
+ * Layout of a .vfpr file, all numbers are little endian:
+ *
+ *   header      "VFPRTREE", version, node size, size and modification
+ *               time of the VFP file, start offset of the layer element,
+ *               number of records, number of indexed records (those
+ *               with coordinates) and the extent of the layer
+ *   paths       number of paths, then for each its length and bytes
+ *   records     for each FID: offset (8 bytes), size and path (4 bytes)
+ *   tree        nodes of 40 bytes: envelope and, for a leaf the FID of
+ *               its record, for other nodes the index of their first
+ *               child. The root comes first and the leaves last.
+ */
+
+#define VFPR_MAGIC          "VFPRTREE"
+#define VFPR_VERSION        1
+#define VFPR_NODE_SIZE      16
+#define VFPR_HEADER_SIZE    88
+#define VFPR_RECORD_SIZE    16
+#define VFPR_NODE_BYTES     40
+
+typedef struct
+{
+    double             dfMinX;
+    double             dfMinY;
+    double             dfMaxX;
+    double             dfMaxY;
+    GUIntBig           nIndex;
+} OGRVFPRTreeNode;
+
+typedef struct
+{
+    GUInt32            nHilbert;
+    GUIntBig           nFID;
+} OGRVFPRTreeItem;
+
+static bool CompareItems( const OGRVFPRTreeItem &sA, const OGRVFPRTreeItem &sB )
+{
+    if( sA.nHilbert != sB.nHilbert )
+        return sA.nHilbert < sB.nHilbert;
+    return sA.nFID < sB.nFID;
+}
+
+/************************************************************************/
+/*                             Hilbert()                                */
+/*                                                                      */
+/*      Position of (nX, nY), both in [0, 65535], along the Hilbert     */
+/*      curve filling the square.                                       */
+/************************************************************************/
+
+static GUInt32 Hilbert( GUInt32 nX, GUInt32 nY )
+{
+    GUInt32 a = nX ^ nY;
+    GUInt32 b = 0xFFFF ^ a;
+    GUInt32 c = 0xFFFF ^ (nX | nY);
+    GUInt32 d = nX & (nY ^ 0xFFFF);
+
+    GUInt32 A = a | (b >> 1);
+    GUInt32 B = (a >> 1) ^ a;
+    GUInt32 C = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+    GUInt32 D = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+
+    a = A; b = B; c = C; d = D;
+    A = (a & (a >> 2)) ^ (b & (b >> 2));
+    B = (a & (b >> 2)) ^ (b & ((a ^ b) >> 2));
+    C ^= (a & (c >> 2)) ^ (b & (d >> 2));
+    D ^= (b & (c >> 2)) ^ ((a ^ b) & (d >> 2));
+
+    a = A; b = B; c = C; d = D;
+    A = (a & (a >> 4)) ^ (b & (b >> 4));
+    B = (a & (b >> 4)) ^ (b & ((a ^ b) >> 4));
+    C ^= (a & (c >> 4)) ^ (b & (d >> 4));
+    D ^= (b & (c >> 4)) ^ ((a ^ b) & (d >> 4));
+
+    a = A; b = B; c = C; d = D;
+    C ^= (a & (c >> 8)) ^ (b & (d >> 8));
+    D ^= (b & (c >> 8)) ^ ((a ^ b) & (d >> 8));
+
+    a = C ^ (C >> 1);
+    b = D ^ (D >> 1);
+
+    GUInt32 i0 = nX ^ nY;
+    GUInt32 i1 = b | (0xFFFF ^ (i0 | a));
+
+    i0 = (i0 | (i0 << 8)) & 0x00FF00FF;
+    i0 = (i0 | (i0 << 4)) & 0x0F0F0F0F;
+    i0 = (i0 | (i0 << 2)) & 0x33333333;
+    i0 = (i0 | (i0 << 1)) & 0x55555555;
+
+    i1 = (i1 | (i1 << 8)) & 0x00FF00FF;
+    i1 = (i1 | (i1 << 4)) & 0x0F0F0F0F;
+    i1 = (i1 | (i1 << 2)) & 0x33333333;
+    i1 = (i1 | (i1 << 1)) & 0x55555555;
+
+    return (i1 << 1) | i0;
+}
+
+/************************************************************************/
+/*                           Level layout                               */
+/*                                                                      */
+/*      Number of nodes of each level, from the leaves up to the        */
+/*      root, and the index of the first node of each level in the      */
+/*      file where the root comes first.                                */
+/************************************************************************/
+
+static GUIntBig ComputeLevels( GUIntBig nItems, int nNodeSize,
+                               std::vector<GUIntBig> &anLevelStart,
+                               std::vector<GUIntBig> &anLevelSize )
+{
+    anLevelSize.resize(0);
+    anLevelStart.resize(0);
+
+    GUIntBig nCount = nItems;
+    GUIntBig nNodes = nCount;
+    anLevelSize.push_back(nCount);
+    while( nCount > 1 )
+    {
+        nCount = (nCount + nNodeSize - 1) / nNodeSize;
+        anLevelSize.push_back(nCount);
+        nNodes += nCount;
+    }
+
+    anLevelStart.resize(anLevelSize.size());
+    GUIntBig nStart = 0;
+    for( int i = (int)anLevelSize.size() - 1; i >= 0; i-- )
+    {
+        anLevelStart[i] = nStart;
+        nStart += anLevelSize[i];
+    }
+
+    return nNodes;
+}
+
+/************************************************************************/
+/*                         Read and write helpers                       */
+/************************************************************************/
+
+static void WriteUInt32( VSILFILE *fp, GUInt32 nValue )
+{
+    CPL_LSBPTR32(&nValue);
+    VSIFWriteL(&nValue, 1, 4, fp);
+}
+
+static void WriteUInt64( VSILFILE *fp, GUIntBig nValue )
+{
+    CPL_LSBPTR64(&nValue);
+    VSIFWriteL(&nValue, 1, 8, fp);
+}
+
+static void WriteDouble( VSILFILE *fp, double dfValue )
+{
+    CPL_LSBPTR64(&dfValue);
+    VSIFWriteL(&dfValue, 1, 8, fp);
+}
+
+static GUInt32 GetUInt32( const GByte *pabyData )
+{
+    GUInt32 nValue;
+    memcpy(&nValue, pabyData, 4);
+    CPL_LSBPTR32(&nValue);
+    return nValue;
+}
+
+static GUIntBig GetUInt64( const GByte *pabyData )
+{
+    GUIntBig nValue;
+    memcpy(&nValue, pabyData, 8);
+    CPL_LSBPTR64(&nValue);
+    return nValue;
+}
+
+static double GetDouble( const GByte *pabyData )
+{
+    double dfValue;
+    memcpy(&dfValue, pabyData, 8);
+    CPL_LSBPTR64(&dfValue);
+    return dfValue;
+}
+
+/************************************************************************/
+/*                            OGRVFPRTree()                             */
+/************************************************************************/
+
+OGRVFPRTree::OGRVFPRTree()
+{
+    fp = NULL;
+    nFeatures = 0;
+    nItems = 0;
+    nNodeSize = VFPR_NODE_SIZE;
+    nRecordTableOffset = 0;
+    nTreeOffset = 0;
+}
+
+/************************************************************************/
+/*                           ~OGRVFPRTree()                             */
+/************************************************************************/
+
+OGRVFPRTree::~OGRVFPRTree()
+{
+    if( fp != NULL )
+        VSIFCloseL(fp);
+}
+
+/************************************************************************/
+/*                               Build()                                */
+/*                                                                      */
+/*      Write the index of the records of a layer collected by a        */
+/*      reader in scan mode. The leaves are sorted along the Hilbert    */
+/*      curve of their center, then packed into parent nodes of         */
+/*      VFPR_NODE_SIZE children up to the root.                         */
+/************************************************************************/
+
+bool OGRVFPRTree::Build( const char *pszFilename, const char *pszDataFilename,
+                         vsi_l_offset nSectionStart,
+                         const std::vector<OGRVFPRecordInfo>& asRecords,
+                         const std::vector<CPLString>& aosPathsIn )
+{
+    VSIStatBufL sStat;
+    if( VSIStatL(pszDataFilename, &sStat) != 0 )
+        return FALSE;
+
+    /* extent and Hilbert value of the records with coordinates */
+    OGREnvelope sExtent;
+    bool bHasExtent = FALSE;
+    for( size_t i = 0; i < asRecords.size(); i++ )
+    {
+        if( !asRecords[i].bHasEnvelope )
+            continue;
+        if( !bHasExtent )
+        {
+            sExtent = asRecords[i].sEnvelope;
+            bHasExtent = TRUE;
+        }
+        else
+            sExtent.Merge(asRecords[i].sEnvelope);
+    }
+
+    std::vector<OGRVFPRTreeItem> asItems;
+    const double dfWidth = bHasExtent ? sExtent.MaxX - sExtent.MinX : 0.0;
+    const double dfHeight = bHasExtent ? sExtent.MaxY - sExtent.MinY : 0.0;
+    for( size_t i = 0; i < asRecords.size(); i++ )
+    {
+        if( !asRecords[i].bHasEnvelope )
+            continue;
+        const OGREnvelope &sEnv = asRecords[i].sEnvelope;
+        OGRVFPRTreeItem sItem;
+        const double dfX = dfWidth > 0.0 ?
+            65535.0 * ((sEnv.MinX + sEnv.MaxX) / 2 - sExtent.MinX) / dfWidth : 0.0;
+        const double dfY = dfHeight > 0.0 ?
+            65535.0 * ((sEnv.MinY + sEnv.MaxY) / 2 - sExtent.MinY) / dfHeight : 0.0;
+        sItem.nHilbert = Hilbert((GUInt32)dfX, (GUInt32)dfY);
+        sItem.nFID = (GUIntBig)i;
+        asItems.push_back(sItem);
+    }
+    std::sort(asItems.begin(), asItems.end(), CompareItems);
+
+    /* pack the tree */
+    std::vector<GUIntBig> anLevelStart, anLevelSize;
+    const GUIntBig nItems = asItems.size();
+    const GUIntBig nNodes = nItems > 0 ?
+        ComputeLevels(nItems, VFPR_NODE_SIZE, anLevelStart, anLevelSize) : 0;
+
+    std::vector<OGRVFPRTreeNode> asNodes((size_t)nNodes);
+    for( GUIntBig i = 0; i < nItems; i++ )
+    {
+        const OGREnvelope &sEnv = asRecords[(size_t)asItems[(size_t)i].nFID].sEnvelope;
+        OGRVFPRTreeNode &sNode = asNodes[(size_t)(anLevelStart[0] + i)];
+        sNode.dfMinX = sEnv.MinX;
+        sNode.dfMinY = sEnv.MinY;
+        sNode.dfMaxX = sEnv.MaxX;
+        sNode.dfMaxY = sEnv.MaxY;
+        sNode.nIndex = asItems[(size_t)i].nFID;
+    }
+    for( size_t iLevel = 0; iLevel + 1 < anLevelSize.size(); iLevel++ )
+    {
+        for( GUIntBig iParent = 0; iParent < anLevelSize[iLevel + 1]; iParent++ )
+        {
+            const GUIntBig nFirst = anLevelStart[iLevel] + iParent * VFPR_NODE_SIZE;
+            const GUIntBig nEnd = MIN(nFirst + VFPR_NODE_SIZE,
+                                      anLevelStart[iLevel] + anLevelSize[iLevel]);
+            OGRVFPRTreeNode &sParent = asNodes[(size_t)(anLevelStart[iLevel + 1] + iParent)];
+            sParent = asNodes[(size_t)nFirst];
+            sParent.nIndex = nFirst;
+            for( GUIntBig i = nFirst + 1; i < nEnd; i++ )
+            {
+                const OGRVFPRTreeNode &sChild = asNodes[(size_t)i];
+                sParent.dfMinX = MIN(sParent.dfMinX, sChild.dfMinX);
+                sParent.dfMinY = MIN(sParent.dfMinY, sChild.dfMinY);
+                sParent.dfMaxX = MAX(sParent.dfMaxX, sChild.dfMaxX);
+                sParent.dfMaxY = MAX(sParent.dfMaxY, sChild.dfMaxY);
+            }
+        }
+    }
+
+    /* the directory may be read-only, the caller handles the failure */
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    VSILFILE *fpOut = VSIFOpenL(pszFilename, "wb");
+    CPLPopErrorHandler();
+    if( fpOut == NULL )
+        return FALSE;
+
+    VSIFWriteL(VFPR_MAGIC, 1, 8, fpOut);
+    WriteUInt32(fpOut, VFPR_VERSION);
+    WriteUInt32(fpOut, VFPR_NODE_SIZE);
+    WriteUInt64(fpOut, (GUIntBig)sStat.st_size);
+    WriteUInt64(fpOut, (GUIntBig)sStat.st_mtime);
+    WriteUInt64(fpOut, (GUIntBig)nSectionStart);
+    WriteUInt64(fpOut, (GUIntBig)asRecords.size());
+    WriteUInt64(fpOut, nItems);
+    WriteDouble(fpOut, bHasExtent ? sExtent.MinX : 0.0);
+    WriteDouble(fpOut, bHasExtent ? sExtent.MinY : 0.0);
+    WriteDouble(fpOut, bHasExtent ? sExtent.MaxX : 0.0);
+    WriteDouble(fpOut, bHasExtent ? sExtent.MaxY : 0.0);
+
+    WriteUInt32(fpOut, (GUInt32)aosPathsIn.size());
+    for( size_t i = 0; i < aosPathsIn.size(); i++ )
+    {
+        WriteUInt32(fpOut, (GUInt32)aosPathsIn[i].size());
+        VSIFWriteL(aosPathsIn[i].c_str(), 1, aosPathsIn[i].size(), fpOut);
+    }
+
+    for( size_t i = 0; i < asRecords.size(); i++ )
+    {
+        WriteUInt64(fpOut, (GUIntBig)asRecords[i].nOffset);
+        WriteUInt32(fpOut, asRecords[i].nSize);
+        WriteUInt32(fpOut, asRecords[i].iPath);
+    }
+
+    for( size_t i = 0; i < asNodes.size(); i++ )
+    {
+        WriteDouble(fpOut, asNodes[i].dfMinX);
+        WriteDouble(fpOut, asNodes[i].dfMinY);
+        WriteDouble(fpOut, asNodes[i].dfMaxX);
+        WriteDouble(fpOut, asNodes[i].dfMaxY);
+        WriteUInt64(fpOut, asNodes[i].nIndex);
+    }
+
+    const vsi_l_offset nExpected = VFPR_HEADER_SIZE + 4 +
+        (vsi_l_offset)asRecords.size() * VFPR_RECORD_SIZE +
+        (vsi_l_offset)nNodes * VFPR_NODE_BYTES;
+    vsi_l_offset nPathBytes = 0;
+    for( size_t i = 0; i < aosPathsIn.size(); i++ )
+        nPathBytes += 4 + aosPathsIn[i].size();
+
+    const bool bOK = VSIFTellL(fpOut) == nExpected + nPathBytes;
+    if( VSIFCloseL(fpOut) != 0 || !bOK )
+    {
+        VSIUnlink(pszFilename);
+        return FALSE;
+    }
+
+    CPLDebug("VFP", "Wrote %s: " CPL_FRMT_GUIB " records, " CPL_FRMT_GUIB " indexed",
+             pszFilename, (GUIntBig)asRecords.size(), nItems);
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                               Open()                                 */
+/*                                                                      */
+/*      Open the index of a layer. NULL is returned if the file does    */
+/*      not exist, is corrupted or does not match the data file.        */
+/************************************************************************/
+
+OGRVFPRTree *OGRVFPRTree::Open( const char *pszFilename,
+                                const char *pszDataFilename,
+                                vsi_l_offset nSectionStart )
+{
+    VSIStatBufL sStat, sIndexStat;
+    if( VSIStatL(pszDataFilename, &sStat) != 0 ||
+        VSIStatL(pszFilename, &sIndexStat) != 0 )
+        return NULL;
+
+    VSILFILE *fp = VSIFOpenL(pszFilename, "rb");
+    if( fp == NULL )
+        return NULL;
+
+    GByte abyHeader[VFPR_HEADER_SIZE + 4];
+    if( VSIFReadL(abyHeader, 1, sizeof(abyHeader), fp) != sizeof(abyHeader) ||
+        memcmp(abyHeader, VFPR_MAGIC, 8) != 0 ||
+        GetUInt32(abyHeader + 8) != VFPR_VERSION )
+    {
+        CPLDebug("VFP", "%s is not a valid spatial index, ignored", pszFilename);
+        VSIFCloseL(fp);
+        return NULL;
+    }
+
+    if( GetUInt64(abyHeader + 16) != (GUIntBig)sStat.st_size ||
+        GetUInt64(abyHeader + 24) != (GUIntBig)sStat.st_mtime ||
+        GetUInt64(abyHeader + 32) != (GUIntBig)nSectionStart )
+    {
+        CPLDebug("VFP", "%s is out of date, ignored", pszFilename);
+        VSIFCloseL(fp);
+        return NULL;
+    }
+
+    OGRVFPRTree *poTree = new OGRVFPRTree();
+    poTree->fp = fp;
+    poTree->nNodeSize = (int)GetUInt32(abyHeader + 12);
+    poTree->nFeatures = GetUInt64(abyHeader + 40);
+    poTree->nItems = GetUInt64(abyHeader + 48);
+    poTree->sExtent.MinX = GetDouble(abyHeader + 56);
+    poTree->sExtent.MinY = GetDouble(abyHeader + 64);
+    poTree->sExtent.MaxX = GetDouble(abyHeader + 72);
+    poTree->sExtent.MaxY = GetDouble(abyHeader + 80);
+
+    /* only the node size written by Create() is supported, Search()
+       reads the children of a node in a buffer of that size */
+    bool bOK = poTree->nNodeSize == VFPR_NODE_SIZE &&
+               poTree->nItems <= poTree->nFeatures;
+    const GUInt32 nPaths = GetUInt32(abyHeader + VFPR_HEADER_SIZE);
+    for( GUInt32 i = 0; bOK && i < nPaths; i++ )
+    {
+        GByte abyLen[4];
+        bOK = VSIFReadL(abyLen, 1, 4, fp) == 4;
+        const GUInt32 nLen = bOK ? GetUInt32(abyLen) : 0;
+        bOK = bOK && nLen < 1024;
+        if( bOK )
+        {
+            char szPath[1024];
+            bOK = VSIFReadL(szPath, 1, nLen, fp) == nLen;
+            szPath[nLen] = '\0';
+            poTree->aosPaths.push_back(szPath);
+        }
+    }
+
+    if( bOK )
+    {
+        poTree->nRecordTableOffset = VSIFTellL(fp);
+        const vsi_l_offset nIndexSize = (vsi_l_offset)sIndexStat.st_size;
+
+        /* bound the counts by the file size before any multiplication */
+        bOK = poTree->nRecordTableOffset <= nIndexSize &&
+              poTree->nFeatures <=
+                  (nIndexSize - poTree->nRecordTableOffset) / VFPR_RECORD_SIZE;
+        if( bOK )
+        {
+            poTree->nTreeOffset = poTree->nRecordTableOffset +
+                (vsi_l_offset)poTree->nFeatures * VFPR_RECORD_SIZE;
+            const GUIntBig nNodes = poTree->nItems > 0 ?
+                ComputeLevels(poTree->nItems, poTree->nNodeSize,
+                              poTree->anLevelStart, poTree->anLevelSize) : 0;
+            bOK = nNodes <= (nIndexSize - poTree->nTreeOffset) / VFPR_NODE_BYTES &&
+                  nIndexSize == poTree->nTreeOffset +
+                                (vsi_l_offset)nNodes * VFPR_NODE_BYTES;
+        }
+    }
+
+    if( !bOK )
+    {
+        CPLDebug("VFP", "%s is corrupted, ignored", pszFilename);
+        delete poTree;
+        return NULL;
+    }
+
+    CPLDebug("VFP", "Using %s", pszFilename);
+
+    return poTree;
+}
+
+/************************************************************************/
+/*                             GetExtent()                              */
+/************************************************************************/
+
+bool OGRVFPRTree::GetExtent( OGREnvelope *psExtent )
+{
+    if( nItems == 0 )
+        return FALSE;
+    *psExtent = sExtent;
+    return TRUE;
+}
+
+/************************************************************************/
+/*                              Search()                                */
+/*                                                                      */
+/*      FIDs of the records whose envelope intersects sFilter, in       */
+/*      increasing order. The children of a node are contiguous, so     */
+/*      each visited node costs one read of at most nNodeSize nodes.    */
+/************************************************************************/
+
+bool OGRVFPRTree::Search( const OGREnvelope &sFilter, std::vector<GIntBig> &anFIDs )
+{
+    anFIDs.resize(0);
+    if( nItems == 0 )
+        return TRUE;
+
+    /* ranges of nodes to visit, with their level */
+    std::vector<GUIntBig> anStack;
+    const int nRootLevel = (int)anLevelSize.size() - 1;
+    anStack.push_back(anLevelStart[nRootLevel]);
+    anStack.push_back(anLevelStart[nRootLevel] + anLevelSize[nRootLevel]);
+    anStack.push_back((GUIntBig)nRootLevel);
+
+    std::vector<GByte> abyNodes(nNodeSize * VFPR_NODE_BYTES);
+
+    while( !anStack.empty() )
+    {
+        const int nLevel = (int)anStack.back();
+        anStack.pop_back();
+        const GUIntBig nEnd = anStack.back();
+        anStack.pop_back();
+        const GUIntBig nFirst = anStack.back();
+        anStack.pop_back();
+
+        const size_t nCount = (size_t)(nEnd - nFirst);
+        if( VSIFSeekL(fp, nTreeOffset + nFirst * VFPR_NODE_BYTES, SEEK_SET) != 0 ||
+            VSIFReadL(&abyNodes[0], VFPR_NODE_BYTES, nCount, fp) != nCount )
+        {
+            CPLError(CE_Failure, CPLE_FileIO, "Cannot read spatial index");
+            return FALSE;
+        }
+
+        for( size_t i = 0; i < nCount; i++ )
+        {
+            const GByte *pabyNode = &abyNodes[i * VFPR_NODE_BYTES];
+            if( GetDouble(pabyNode) > sFilter.MaxX ||
+                GetDouble(pabyNode + 8) > sFilter.MaxY ||
+                GetDouble(pabyNode + 16) < sFilter.MinX ||
+                GetDouble(pabyNode + 24) < sFilter.MinY )
+                continue;
+
+            const GUIntBig nIndex = GetUInt64(pabyNode + 32);
+            if( nLevel == 0 )
+            {
+                anFIDs.push_back((GIntBig)nIndex);
+            }
+            else
+            {
+                /* the children of a node are in the level below it */
+                if( nIndex < anLevelStart[nLevel - 1] ||
+                    nIndex >= anLevelStart[nLevel - 1] + anLevelSize[nLevel - 1] )
+                {
+                    CPLError(CE_Failure, CPLE_AppDefined,
+                             "Corrupted spatial index");
+                    return FALSE;
+                }
+                anStack.push_back(nIndex);
+                anStack.push_back(MIN(nIndex + nNodeSize,
+                                      anLevelStart[nLevel - 1] + anLevelSize[nLevel - 1]));
+                anStack.push_back((GUIntBig)(nLevel - 1));
+            }
+        }
+    }
+
+    std::sort(anFIDs.begin(), anFIDs.end());
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                             GetRecord()                              */
+/************************************************************************/
+
+bool OGRVFPRTree::GetRecord( GIntBig nFID, vsi_l_offset *pnOffset,
+                             GUInt32 *pnSize, const char **ppszPath )
+{
+    if( nFID < 0 || (GUIntBig)nFID >= nFeatures )
+        return FALSE;
+
+    GByte abyRecord[VFPR_RECORD_SIZE];
+    if( VSIFSeekL(fp, nRecordTableOffset + (vsi_l_offset)nFID * VFPR_RECORD_SIZE,
+                  SEEK_SET) != 0 ||
+        VSIFReadL(abyRecord, 1, VFPR_RECORD_SIZE, fp) != VFPR_RECORD_SIZE )
+        return FALSE;
+
+    const GUInt32 iPath = GetUInt32(abyRecord + 12);
+    if( iPath >= aosPaths.size() )
+        return FALSE;
+
+    *pnOffset = (vsi_l_offset)GetUInt64(abyRecord);
+    *pnSize = GetUInt32(abyRecord + 8);
+    *ppszPath = aosPaths[iPath].c_str();
+
+    return TRUE;
+}
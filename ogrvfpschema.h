@@ -0,0 +1,1308 @@
+/* Generated by generate_schema.py from vfp_3.1.xsd, do not edit. */
+
+#ifndef _OGR_VFP_SCHEMA_H_INCLUDED
+#define _OGR_VFP_SCHEMA_H_INCLUDED
+
+static const OGRVFPFieldDesc asVFPFields_ucastnici[] = {
+    { "id", OFTInteger64 },
+    { "op_id", OFTString },
+    { "jm", OFTString },
+    { "pr", OFTString },
+    { "naz", OFTString },
+    { "tpj", OFTString },
+    { "tzj", OFTString },
+    { "rc", OFTString },
+    { "ico", OFTInteger64 },
+    { "ul", OFTString },
+    { "cd", OFTInteger64 },
+    { "co", OFTString },
+    { "caob", OFTString },
+    { "mc", OFTString },
+    { "ob", OFTString },
+    { "psc", OFTString },
+    { "okr", OFTString },
+    { "sta", OFTString },
+    { "email", OFTString },
+    { "tel", OFTString },
+};
+
+static const OGRVFPFieldDesc asVFPFields_narok[] = {
+    { "cis", OFTInteger },
+    { "kk", OFTInteger },
+};
+
+static const OGRVFPFieldDesc asVFPFields_navrh[] = {
+    { "kk", OFTInteger },
+    { "cis", OFTInteger },
+    { "vymr", OFTReal },
+    { "vymnr", OFTReal },
+    { "cen", OFTReal },
+    { "vzd", OFTReal },
+};
+
+static const OGRVFPFieldDesc asVFPFields_pneres[] = {
+    { "parid", OFTString },
+    { "vymz", OFTReal },
+    { "dpz", OFTReal },
+    { "zvz", OFTReal },
+};
+
+static const OGRVFPFieldDesc asVFPFields_pmimo[] = {
+    { "parid", OFTString },
+};
+
+static const OGRVFPFieldDesc asVFPFields_bpej[] = {
+    { "id", OFTInteger64 },
+    { "kod", OFTString },
+    { "cena", OFTReal },
+};
+
+static const OGRVFPFieldDesc asVFPFields_bpejr2[] = {
+    { "id", OFTInteger64 },
+    { "kod", OFTString },
+};
+
+static const OGRVFPFieldDesc asVFPFields_mdp[] = {
+    { "id", OFTInteger64 },
+    { "dp", OFTReal },
+    { "zv", OFTReal },
+};
+
+static const OGRVFPFieldDesc asVFPFields_zs[] = {
+    { "typ", OFTInteger64 },
+    { "sx", OFTReal },
+    { "sy", OFTReal },
+    { "sz", OFTReal },
+    { "cb", OFTInteger64 },
+};
+
+static const OGRVFPFieldDesc asVFPFields_opu[] = {
+    { "id", OFTInteger64 },
+    { "res", OFTInteger },
+    { "poz", OFTString },
+};
+
+static const OGRVFPFieldDesc asVFPFields_por[] = {
+    { "cen", OFTReal },
+    { "naz", OFTString },
+    { "id", OFTInteger64 },
+    { "dp", OFTReal },
+    { "dpo", OFTString },
+    { "zv", OFTReal },
+};
+
+static const OGRVFPFieldDesc asVFPFields_pbre[] = {
+    { "id", OFTInteger64 },
+    { "typ", OFTInteger64 },
+    { "popis", OFTString },
+};
+
+static const OGRVFPFieldDesc asVFPFields_spoz[] = {
+    { "id", OFTInteger64 },
+    { "op", OFTInteger64 },
+    { "psz", OFTString },
+};
+
+static const OGRVFPFieldDesc asVFPFields_pm[] = {
+    { "typ", OFTInteger64 },
+};
+
+static const OGRVFPFieldDesc asVFPFields_mp[] = {
+    { "typ", OFTInteger64 },
+};
+
+static const OGRVFPFieldDesc asVFPFields_meos[] = {
+    { "typ", OFTInteger64 },
+};
+
+static const OGRVFPFieldDesc asVFPFields_meon[] = {
+    { "typ", OFTInteger64 },
+};
+
+static const OGRVFPFieldDesc asVFPFields_hvpsz[] = {
+    { "typ", OFTInteger64 },
+};
+
+static const OGRVFPFieldDesc asVFPFields_zv[] = {
+    { "cb", OFTInteger64 },
+};
+
+static const OGRVFPRecordDesc asVFPRecords_ucastnici[] = {
+    { NULL, "uca", NULL, VFP_RECORD_NONE, NULL, -1, FALSE, 0x000fffff },
+};
+
+static const OGRVFPRecordDesc asVFPRecords_narok[] = {
+    { NULL, "lv", NULL, VFP_RECORD_NONE, NULL, -1, FALSE, 0x00000003 },
+};
+
+static const OGRVFPRecordDesc asVFPRecords_navrh[] = {
+    { NULL, "lv", NULL, VFP_RECORD_NONE, NULL, -1, FALSE, 0x0000003f },
+};
+
+static const OGRVFPRecordDesc asVFPRecords_pneres[] = {
+    { NULL, "pa", NULL, VFP_RECORD_REGION, "gpar/area/reg", 1, TRUE, 0x0000000f },
+};
+
+static const OGRVFPRecordDesc asVFPRecords_pmimo[] = {
+    { NULL, "pa", NULL, VFP_RECORD_REGION, "gpar/area/reg", 1, TRUE, 0x00000001 },
+};
+
+static const OGRVFPRecordDesc asVFPRecords_bpej[] = {
+    { NULL, "pl", NULL, VFP_RECORD_REGION, "area/reg", -1, TRUE, 0x00000007 },
+};
+
+static const OGRVFPRecordDesc asVFPRecords_bpejr2[] = {
+    { NULL, "pl", NULL, VFP_RECORD_REGION, "area/reg", -1, TRUE, 0x00000003 },
+};
+
+static const OGRVFPRecordDesc asVFPRecords_mdp[] = {
+    { NULL, "pl", NULL, VFP_RECORD_REGION, "area/reg", -1, TRUE, 0x00000007 },
+};
+
+static const OGRVFPRecordDesc asVFPRecords_zs[] = {
+    { "plins", "plin", NULL, VFP_RECORD_LINE, "lin", 0, FALSE, 0x00000001 },
+    { "pznas", "pzna", NULL, VFP_RECORD_POINT, "b/c", 0, FALSE, 0x00000001 },
+    { "psour", "psou", NULL, VFP_RECORD_POINT_ATTR, NULL, -1, FALSE, 0x00000010 },
+};
+
+static const OGRVFPRecordDesc asVFPRecords_opu[] = {
+    { NULL, "pl", NULL, VFP_RECORD_REGION, "reg", -1, FALSE, 0x00000007 },
+};
+
+static const OGRVFPRecordDesc asVFPRecords_por[] = {
+    { NULL, "porost", "sol", VFP_RECORD_POINT, "b/c", -1, FALSE, 0x00000007 },
+    { NULL, "porost", "por", VFP_RECORD_REGION, "area/reg", -1, TRUE, 0x0000003d },
+};
+
+static const OGRVFPRecordDesc asVFPRecords_pbre[] = {
+    { NULL, "pl", NULL, VFP_RECORD_REGION, "area/reg", -1, TRUE, 0x00000007 },
+};
+
+static const OGRVFPRecordDesc asVFPRecords_spoz[] = {
+    { NULL, "pl", NULL, VFP_RECORD_REGION, "area/reg", -1, TRUE, 0x00000007 },
+};
+
+static const OGRVFPRecordDesc asVFPRecords_pm[] = {
+    { "pmlins", "pmlin", NULL, VFP_RECORD_LINE, "lin", 0, FALSE, 0x00000001 },
+    { "pmznas", "pmzna", NULL, VFP_RECORD_POINT, "b/c", 0, FALSE, 0x00000001 },
+    { "pmareas", "pmarea", NULL, VFP_RECORD_REGION, "reg", 0, FALSE, 0x00000001 },
+};
+
+static const OGRVFPRecordDesc asVFPRecords_mp[] = {
+    { "mplins", "mplin", NULL, VFP_RECORD_LINE, "lin", 0, FALSE, 0x00000001 },
+    { "mpznas", "mpzna", NULL, VFP_RECORD_POINT, "b/c", 0, FALSE, 0x00000001 },
+    { "mpareas", "mparea", NULL, VFP_RECORD_REGION, "reg", 0, FALSE, 0x00000001 },
+};
+
+static const OGRVFPRecordDesc asVFPRecords_meos[] = {
+    { "meoslins", "meoslin", NULL, VFP_RECORD_LINE, "lin", 0, FALSE, 0x00000001 },
+    { "meosznas", "meoszna", NULL, VFP_RECORD_POINT, "b/c", 0, FALSE, 0x00000001 },
+    { "meosareas", "meosarea", NULL, VFP_RECORD_REGION, "reg", 0, FALSE, 0x00000001 },
+};
+
+static const OGRVFPRecordDesc asVFPRecords_meon[] = {
+    { "meonlins", "meonlin", NULL, VFP_RECORD_LINE, "lin", 0, FALSE, 0x00000001 },
+    { "meonznas", "meonzna", NULL, VFP_RECORD_POINT, "b/c", 0, FALSE, 0x00000001 },
+    { "meonareas", "meonarea", NULL, VFP_RECORD_REGION, "reg", 0, FALSE, 0x00000001 },
+};
+
+static const OGRVFPRecordDesc asVFPRecords_hvpsz[] = {
+    { "hvpszlins", "hvpszlin", NULL, VFP_RECORD_LINE, "lin", 0, FALSE, 0x00000001 },
+    { "hvpszznas", "hvpszzna", NULL, VFP_RECORD_POINT, "b/c", 0, FALSE, 0x00000001 },
+    { "hvpszareas", "hvpszarea", NULL, VFP_RECORD_REGION, "reg", 0, FALSE, 0x00000001 },
+};
+
+static const OGRVFPRecordDesc asVFPRecords_zv[] = {
+    { "zvbods", "zvbod", NULL, VFP_RECORD_POINT, "c", -1, FALSE, 0x00000001 },
+    { "zvlins", "zvlin", NULL, VFP_RECORD_LINE, "lin", 0, FALSE, 0x00000000 },
+    { "zvareas", "zvarea", NULL, VFP_RECORD_REGION, "reg", 0, FALSE, 0x00000000 },
+};
+
+static const OGRVFPLayerDesc asVFPLayers[] = {
+    { "ucastnici", VFP_TOKEN_UCASTNICI, 1, FALSE, asVFPFields_ucastnici, 20, asVFPRecords_ucastnici, 1 },
+    { "narok", VFP_TOKEN_NAROK, 1, TRUE, asVFPFields_narok, 2, asVFPRecords_narok, 1 },
+    { "navrh", VFP_TOKEN_NAVRH, 1, TRUE, asVFPFields_navrh, 6, asVFPRecords_navrh, 1 },
+    { "pneres", VFP_TOKEN_PNERES, 1, TRUE, asVFPFields_pneres, 4, asVFPRecords_pneres, 1 },
+    { "pmimo", VFP_TOKEN_PMIMO, 1, TRUE, asVFPFields_pmimo, 1, asVFPRecords_pmimo, 1 },
+    { "bpej", VFP_TOKEN_BPEJ, 1, TRUE, asVFPFields_bpej, 3, asVFPRecords_bpej, 1 },
+    { "bpejr2", VFP_TOKEN_BPEJR2, 1, TRUE, asVFPFields_bpejr2, 2, asVFPRecords_bpejr2, 1 },
+    { "mdp", VFP_TOKEN_MDP, 1, TRUE, asVFPFields_mdp, 3, asVFPRecords_mdp, 1 },
+    { "zs", VFP_TOKEN_ZS, 2, TRUE, asVFPFields_zs, 5, asVFPRecords_zs, 3 },
+    { "opu", VFP_TOKEN_OPU, 1, TRUE, asVFPFields_opu, 3, asVFPRecords_opu, 1 },
+    { "por", VFP_TOKEN_POR, 1, TRUE, asVFPFields_por, 6, asVFPRecords_por, 2 },
+    { "pbre", VFP_TOKEN_PBRE, 1, TRUE, asVFPFields_pbre, 3, asVFPRecords_pbre, 1 },
+    { "spoz", VFP_TOKEN_SPOZ, 1, TRUE, asVFPFields_spoz, 3, asVFPRecords_spoz, 1 },
+    { "pm", VFP_TOKEN_PM, 2, TRUE, asVFPFields_pm, 1, asVFPRecords_pm, 3 },
+    { "mp", VFP_TOKEN_MP, 2, TRUE, asVFPFields_mp, 1, asVFPRecords_mp, 3 },
+    { "meos", VFP_TOKEN_MEOS, 2, TRUE, asVFPFields_meos, 1, asVFPRecords_meos, 3 },
+    { "meon", VFP_TOKEN_MEON, 2, TRUE, asVFPFields_meon, 1, asVFPRecords_meon, 3 },
+    { "hvpsz", VFP_TOKEN_HVPSZ, 2, TRUE, asVFPFields_hvpsz, 1, asVFPRecords_hvpsz, 3 },
+    { "zv", VFP_TOKEN_ZV, 2, TRUE, asVFPFields_zv, 1, asVFPRecords_zv, 3 },
+};
+
+#define VFP_TOKEN_BUCKETS 256
+#define VFP_TOKEN_SLOTS 1024
+
+static const GUInt32 anVFPTokenSeeds[VFP_TOKEN_BUCKETS] = {
+    1, 0, 1, 0, 0, 0, 0, 1,
+    1, 2, 0, 2, 0, 1, 1, 0,
+    1, 0, 0, 1, 1, 0, 1, 1,
+    1, 1, 0, 0, 1, 1, 0, 1,
+    0, 1, 3, 0, 1, 0, 0, 1,
+    1, 1, 1, 1, 1, 0, 0, 0,
+    1, 1, 1, 0, 3, 1, 1, 0,
+    1, 1, 0, 1, 1, 0, 1, 0,
+    0, 1, 1, 0, 1, 1, 1, 1,
+    1, 1, 0, 0, 1, 0, 1, 0,
+    0, 1, 1, 1, 1, 1, 1, 1,
+    1, 0, 0, 1, 0, 2, 1, 1,
+    1, 1, 0, 1, 1, 0, 2, 0,
+    1, 0, 1, 1, 1, 1, 1, 0,
+    2, 2, 0, 1, 0, 0, 0, 1,
+    1, 1, 1, 1, 2, 0, 1, 0,
+    2, 1, 1, 2, 1, 0, 0, 2,
+    1, 2, 1, 1, 3, 1, 1, 1,
+    1, 2, 0, 0, 1, 2, 0, 0,
+    2, 1, 0, 0, 0, 1, 0, 1,
+    1, 1, 0, 1, 0, 2, 1, 2,
+    0, 0, 2, 5, 0, 2, 1, 0,
+    2, 1, 1, 0, 2, 1, 0, 0,
+    1, 1, 2, 3, 0, 2, 0, 1,
+    2, 1, 1, 1, 0, 0, 2, 1,
+    0, 1, 1, 0, 1, 1, 2, 0,
+    2, 0, 1, 0, 2, 2, 1, 0,
+    0, 0, 2, 0, 1, 0, 1, 0,
+    1, 2, 1, 1, 2, 1, 1, 1,
+    1, 1, 0, 0, 0, 2, 0, 1,
+    0, 1, 0, 1, 3, 0, 1, 0,
+    1, 3, 2, 0, 1, 1, 0, 1,
+};
+
+static const OGRVFPTokenDesc asVFPTokenSlots[VFP_TOKEN_SLOTS] = {
+    { "porost", VFP_TOKEN_POROST },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "hvpsz", VFP_TOKEN_HVPSZ },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "kk", VFP_TOKEN_KK },
+    { "uca", VFP_TOKEN_UCA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "pl", VFP_TOKEN_PL },
+    { "v:zvbods", VFP_TOKEN_ZVBODS },
+    { "lv", VFP_TOKEN_LV },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:znaPart", VFP_TOKEN_ZNAPART },
+    { "v:mpzna", VFP_TOKEN_MPZNA },
+    { "zv", VFP_TOKEN_ZV },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:pl", VFP_TOKEN_PL },
+    { "meostext", VFP_TOKEN_MEOSTEXT },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "navrh", VFP_TOKEN_NAVRH },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "pmtexts", VFP_TOKEN_PMTEXTS },
+    { "v:narok", VFP_TOKEN_NAROK },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:meonzna", VFP_TOKEN_MEONZNA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "mptexts", VFP_TOKEN_MPTEXTS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:plins", VFP_TOKEN_PLINS },
+    { "v:zv", VFP_TOKEN_ZV },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "ob", VFP_TOKEN_OB },
+    { "v:meon", VFP_TOKEN_MEON },
+    { "v:hvpszarea", VFP_TOKEN_HVPSZAREA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:pmarea", VFP_TOKEN_PMAREA },
+    { "v:plin", VFP_TOKEN_PLIN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "zvarea", VFP_TOKEN_ZVAREA },
+    { "zvbods", VFP_TOKEN_ZVBODS },
+    { "mdp", VFP_TOKEN_MDP },
+    { "parid", VFP_TOKEN_PARID },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "zvz", VFP_TOKEN_ZVZ },
+    { "pmznas", VFP_TOKEN_PMZNAS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:mptext", VFP_TOKEN_MPTEXT },
+    { "bre", VFP_TOKEN_BRE },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "hvpszlin", VFP_TOKEN_HVPSZLIN },
+    { "v:hvpszlin", VFP_TOKEN_HVPSZLIN },
+    { "v:sol", VFP_TOKEN_SOL },
+    { "rc", VFP_TOKEN_RC },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:c", VFP_TOKEN_C },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "caob", VFP_TOKEN_CAOB },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:zvareas", VFP_TOKEN_ZVAREAS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:hvpsztext", VFP_TOKEN_HVPSZTEXT },
+    { "zs", VFP_TOKEN_ZS },
+    { "circle", VFP_TOKEN_CIRCLE },
+    { "v:se", VFP_TOKEN_SE },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:pmimo", VFP_TOKEN_PMIMO },
+    { "mparea", VFP_TOKEN_MPAREA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:zvbod", VFP_TOKEN_ZVBOD },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "mp", VFP_TOKEN_MP },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:pmtexts", VFP_TOKEN_PMTEXTS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "tzj", VFP_TOKEN_TZJ },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "mplins", VFP_TOKEN_MPLINS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:meonlins", VFP_TOKEN_MEONLINS },
+    { "poz", VFP_TOKEN_POZ },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "pzna", VFP_TOKEN_PZNA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "co", VFP_TOKEN_CO },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "pmarea", VFP_TOKEN_PMAREA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "meosznas", VFP_TOKEN_MEOSZNAS },
+    { "hvpszzna", VFP_TOKEN_HVPSZZNA },
+    { "op_id", VFP_TOKEN_OP_ID },
+    { "v:t", VFP_TOKEN_T },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "cis", VFP_TOKEN_CIS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:hvpszznas", VFP_TOKEN_HVPSZZNAS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "psc", VFP_TOKEN_PSC },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "cb", VFP_TOKEN_CB },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "meoslin", VFP_TOKEN_MEOSLIN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "hvpszareas", VFP_TOKEN_HVPSZAREAS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "cena", VFP_TOKEN_CENA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:meonlin", VFP_TOKEN_MEONLIN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:pmzna", VFP_TOKEN_PMZNA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "pmareas", VFP_TOKEN_PMAREAS },
+    { "gpar", VFP_TOKEN_GPAR },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:hvpsz", VFP_TOKEN_HVPSZ },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:meostext", VFP_TOKEN_MEOSTEXT },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:meonznas", VFP_TOKEN_MEONZNAS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "plin", VFP_TOKEN_PLIN },
+    { "v:gpar", VFP_TOKEN_GPAR },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:psour", VFP_TOKEN_PSOUR },
+    { "psou", VFP_TOKEN_PSOU },
+    { "t", VFP_TOKEN_T },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:zvarea", VFP_TOKEN_ZVAREA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "nc", VFP_TOKEN_NC },
+    { "ul", VFP_TOKEN_UL },
+    { "meonlin", VFP_TOKEN_MEONLIN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "pmzna", VFP_TOKEN_PMZNA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "ncn", VFP_TOKEN_NCN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:meosareas", VFP_TOKEN_MEOSAREAS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "ucastnici", VFP_TOKEN_UCASTNICI },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:por", VFP_TOKEN_POR },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "segment", VFP_TOKEN_SEGMENT },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:mp", VFP_TOKEN_MP },
+    { "v:meonarea", VFP_TOKEN_MEONAREA },
+    { "zvareas", VFP_TOKEN_ZVAREAS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "brem", VFP_TOKEN_BREM },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "mpareas", VFP_TOKEN_MPAREAS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "meontexts", VFP_TOKEN_MEONTEXTS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:linpol", VFP_TOKEN_LINPOL },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "vfp", VFP_TOKEN_VFP },
+    { "lin", VFP_TOKEN_LIN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:vfp", VFP_TOKEN_VFP },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "typ", VFP_TOKEN_TYP },
+    { "v:meostexts", VFP_TOKEN_MEOSTEXTS },
+    { "v:polygon", VFP_TOKEN_POLYGON },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "meon", VFP_TOKEN_MEON },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "vla", VFP_TOKEN_VLA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:uca", VFP_TOKEN_UCA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:sou", VFP_TOKEN_SOU },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:segment", VFP_TOKEN_SEGMENT },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:circle", VFP_TOKEN_CIRCLE },
+    { "pmtext", VFP_TOKEN_PMTEXT },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "ar", VFP_TOKEN_AR },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "mplin", VFP_TOKEN_MPLIN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "meontext", VFP_TOKEN_MEONTEXT },
+    { "meostexts", VFP_TOKEN_MEOSTEXTS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "popis", VFP_TOKEN_POPIS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "pbre", VFP_TOKEN_PBRE },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "mptext", VFP_TOKEN_MPTEXT },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "zvlin", VFP_TOKEN_ZVLIN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:meontexts", VFP_TOKEN_MEONTEXTS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "cd", VFP_TOKEN_CD },
+    { "sta", VFP_TOKEN_STA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "meoszna", VFP_TOKEN_MEOSZNA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "meosareas", VFP_TOKEN_MEOSAREAS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "kod", VFP_TOKEN_KOD },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "porPart", VFP_TOKEN_PORPART },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:pa", VFP_TOKEN_PA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:mparea", VFP_TOKEN_MPAREA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:meosarea", VFP_TOKEN_MEOSAREA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:bpejr2", VFP_TOKEN_BPEJR2 },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:ptexts", VFP_TOKEN_PTEXTS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "tpj", VFP_TOKEN_TPJ },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:pmlins", VFP_TOKEN_PMLINS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:area", VFP_TOKEN_AREA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:hvpszlins", VFP_TOKEN_HVPSZLINS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "email", VFP_TOKEN_EMAIL },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:nvlas", VFP_TOKEN_NVLAS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "mpznas", VFP_TOKEN_MPZNAS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "psour", VFP_TOKEN_PSOUR },
+    { "v:vlas", VFP_TOKEN_VLAS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:nvla", VFP_TOKEN_NVLA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "cen", VFP_TOKEN_CEN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:pmtext", VFP_TOKEN_PMTEXT },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "polygon", VFP_TOKEN_POLYGON },
+    { "spoz", VFP_TOKEN_SPOZ },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "meonznas", VFP_TOKEN_MEONZNAS },
+    { "v:meosznas", VFP_TOKEN_MEOSZNAS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "area", VFP_TOKEN_AREA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "bpej", VFP_TOKEN_BPEJ },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "sou", VFP_TOKEN_SOU },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "zvlins", VFP_TOKEN_ZVLINS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "hvpsztexts", VFP_TOKEN_HVPSZTEXTS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "meosarea", VFP_TOKEN_MEOSAREA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:sour", VFP_TOKEN_SOUR },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "vymz", VFP_TOKEN_VYMZ },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "pr", VFP_TOKEN_PR },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "vymr", VFP_TOKEN_VYMR },
+    { "v:pmznas", VFP_TOKEN_PMZNAS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:navrh", VFP_TOKEN_NAVRH },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:mplins", VFP_TOKEN_MPLINS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "ico", VFP_TOKEN_ICO },
+    { "v:hvpszzna", VFP_TOKEN_HVPSZZNA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:pm", VFP_TOKEN_PM },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:bpej", VFP_TOKEN_BPEJ },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:pzna", VFP_TOKEN_PZNA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "se", VFP_TOKEN_SE },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "znaPart", VFP_TOKEN_ZNAPART },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "vlas", VFP_TOKEN_VLAS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "dil", VFP_TOKEN_DIL },
+    { "hvpszlins", VFP_TOKEN_HVPSZLINS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:hlav", VFP_TOKEN_HLAV },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "id", VFP_TOKEN_ID },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "tel", VFP_TOKEN_TEL },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:solid", VFP_TOKEN_SOLID },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "pa", VFP_TOKEN_PA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:hvpsztexts", VFP_TOKEN_HVPSZTEXTS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:porost", VFP_TOKEN_POROST },
+    { "hvpszarea", VFP_TOKEN_HVPSZAREA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:ptext", VFP_TOKEN_PTEXT },
+    { "mc", VFP_TOKEN_MC },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "opu", VFP_TOKEN_OPU },
+    { "hvpszznas", VFP_TOKEN_HVPSZZNAS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "vymnr", VFP_TOKEN_VYMNR },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "meonarea", VFP_TOKEN_MEONAREA },
+    { "pmlins", VFP_TOKEN_PMLINS },
+    { "op", VFP_TOKEN_OP },
+    { "v:ucas", VFP_TOKEN_UCAS },
+    { "bpejr2", VFP_TOKEN_BPEJR2 },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "pznas", VFP_TOKEN_PZNAS },
+    { "v:meontext", VFP_TOKEN_MEONTEXT },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:ncn", VFP_TOKEN_NCN },
+    { "v:meoszna", VFP_TOKEN_MEOSZNA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:meonareas", VFP_TOKEN_MEONAREAS },
+    { "v:porPart", VFP_TOKEN_PORPART },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:meoslins", VFP_TOKEN_MEOSLINS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "naz", VFP_TOKEN_NAZ },
+    { "v:mpareas", VFP_TOKEN_MPAREAS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:holes", VFP_TOKEN_HOLES },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:ochr", VFP_TOKEN_OCHR },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "sy", VFP_TOKEN_SY },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:nc", VFP_TOKEN_NC },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:mdp", VFP_TOKEN_MDP },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "meonareas", VFP_TOKEN_MEONAREAS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "sz", VFP_TOKEN_SZ },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "hlav", VFP_TOKEN_HLAV },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "plins", VFP_TOKEN_PLINS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "meonlins", VFP_TOKEN_MEONLINS },
+    { "pm", VFP_TOKEN_PM },
+    { "meonzna", VFP_TOKEN_MEONZNA },
+    { "pneres", VFP_TOKEN_PNERES },
+    { "dp", VFP_TOKEN_DP },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "mpzna", VFP_TOKEN_MPZNA },
+    { "v:meos", VFP_TOKEN_MEOS },
+    { "v:pmareas", VFP_TOKEN_PMAREAS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "por", VFP_TOKEN_POR },
+    { "meos", VFP_TOKEN_MEOS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "res", VFP_TOKEN_RES },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "pmlin", VFP_TOKEN_PMLIN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "solid", VFP_TOKEN_SOLID },
+    { "v:bre", VFP_TOKEN_BRE },
+    { "v:pmlin", VFP_TOKEN_PMLIN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "ucas", VFP_TOKEN_UCAS },
+    { "reg", VFP_TOKEN_REG },
+    { "v:lin", VFP_TOKEN_LIN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:opu", VFP_TOKEN_OPU },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "sour", VFP_TOKEN_SOUR },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "c", VFP_TOKEN_C },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "zvbod", VFP_TOKEN_ZVBOD },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "nvlas", VFP_TOKEN_NVLAS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "ochr", VFP_TOKEN_OCHR },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:zvlins", VFP_TOKEN_ZVLINS },
+    { "pmimo", VFP_TOKEN_PMIMO },
+    { "sx", VFP_TOKEN_SX },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "sol", VFP_TOKEN_SOL },
+    { "v:hvpszareas", VFP_TOKEN_HVPSZAREAS },
+    { "v:zvlin", VFP_TOKEN_ZVLIN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "par", VFP_TOKEN_PAR },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:mplin", VFP_TOKEN_MPLIN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "b", VFP_TOKEN_B },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:dil", VFP_TOKEN_DIL },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "okr", VFP_TOKEN_OKR },
+    { "solPart", VFP_TOKEN_SOLPART },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "linpol", VFP_TOKEN_LINPOL },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:spoz", VFP_TOKEN_SPOZ },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "dpz", VFP_TOKEN_DPZ },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:brem", VFP_TOKEN_BREM },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:vla", VFP_TOKEN_VLA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "vzd", VFP_TOKEN_VZD },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:reg", VFP_TOKEN_REG },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "hvpsztext", VFP_TOKEN_HVPSZTEXT },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "nvla", VFP_TOKEN_NVLA },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:b", VFP_TOKEN_B },
+    { "v:psou", VFP_TOKEN_PSOU },
+    { "v:pneres", VFP_TOKEN_PNERES },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:mpznas", VFP_TOKEN_MPZNAS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "meoslins", VFP_TOKEN_MEOSLINS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:par", VFP_TOKEN_PAR },
+    { "v:mptexts", VFP_TOKEN_MPTEXTS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:lv", VFP_TOKEN_LV },
+    { "v:pznas", VFP_TOKEN_PZNAS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "dpo", VFP_TOKEN_DPO },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "holes", VFP_TOKEN_HOLES },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "jm", VFP_TOKEN_JM },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:ar", VFP_TOKEN_AR },
+    { "v:solPart", VFP_TOKEN_SOLPART },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:ucastnici", VFP_TOKEN_UCASTNICI },
+    { "ptext", VFP_TOKEN_PTEXT },
+    { "ptexts", VFP_TOKEN_PTEXTS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "narok", VFP_TOKEN_NAROK },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "psz", VFP_TOKEN_PSZ },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:meoslin", VFP_TOKEN_MEOSLIN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:zs", VFP_TOKEN_ZS },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { "v:pbre", VFP_TOKEN_PBRE },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+    { NULL, VFP_TOKEN_UNKNOWN },
+};
+
+#endif /* ndef _OGR_VFP_SCHEMA_H_INCLUDED */
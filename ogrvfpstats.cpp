@@ -0,0 +1,141 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  VFP Translator
+ * Purpose:  Counters and timers of the parsing, VFP_STATS metadata domain.
+ * Author:   Martin Landa, landa.martin gmail.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, Martin Landa <landa.martin gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ogr_vfp.h"
+#include "cpl_conv.h"
+#include "cpl_string.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#include <sys/time.h>
+#endif
+
+CPL_CVSID("$Id$");
+
+/************************************************************************/
+/*                          OGRVFPGetTimeNs()                           */
+/*                                                                      */
+/*      Monotonic clock for the timers of STATS=YES.                    */
+/************************************************************************/
+
+GIntBig OGRVFPGetTimeNs()
+
+{
+#ifdef _WIN32
+    static LARGE_INTEGER nFrequency;
+    if( nFrequency.QuadPart == 0 )
+        QueryPerformanceFrequency(&nFrequency);
+    LARGE_INTEGER nCounter;
+    QueryPerformanceCounter(&nCounter);
+    return (GIntBig)(nCounter.QuadPart * 1e9 / nFrequency.QuadPart);
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec sTime;
+    clock_gettime(CLOCK_MONOTONIC, &sTime);
+    return (GIntBig)sTime.tv_sec * 1000000000 + sTime.tv_nsec;
+#else
+    struct timeval sTime;
+    gettimeofday(&sTime, NULL);
+    return (GIntBig)sTime.tv_sec * 1000000000 + (GIntBig)sTime.tv_usec * 1000;
+#endif
+}
+
+/************************************************************************/
+/*                          OGRVFPResetStats()                          */
+/************************************************************************/
+
+void OGRVFPResetStats( OGRVFPStats *psStats )
+
+{
+    memset(psStats, 0, sizeof(OGRVFPStats));
+}
+
+/************************************************************************/
+/*                           OGRVFPAddStats()                           */
+/************************************************************************/
+
+void OGRVFPAddStats( OGRVFPStats *psTo, const OGRVFPStats *psFrom )
+
+{
+    psTo->nBytesRead += psFrom->nBytesRead;
+    psTo->nReadCalls += psFrom->nReadCalls;
+    psTo->nBytesMapped += psFrom->nBytesMapped;
+    psTo->nXMLEvents += psFrom->nXMLEvents;
+    psTo->nRecords += psFrom->nRecords;
+    psTo->nRecordsSkipped += psFrom->nRecordsSkipped;
+    psTo->nFeaturesBuilt += psFrom->nFeaturesBuilt;
+    psTo->nFeaturesReturned += psFrom->nFeaturesReturned;
+    psTo->nFeaturesFiltered += psFrom->nFeaturesFiltered;
+
+    psTo->nReadNs += psFrom->nReadNs;
+    psTo->nExpatNs += psFrom->nExpatNs;
+    psTo->nHandlersNs += psFrom->nHandlersNs;
+    psTo->nAttributesNs += psFrom->nAttributesNs;
+    psTo->nCoordinatesNs += psFrom->nCoordinatesNs;
+    psTo->nGeometryNs += psFrom->nGeometryNs;
+    psTo->nFilterNs += psFrom->nFilterNs;
+    psTo->nFeatureNs += psFrom->nFeatureNs;
+}
+
+/************************************************************************/
+/*                         OGRVFPStatsToList()                          */
+/*                                                                      */
+/*      NAME=VALUE items of the VFP_STATS domain. PARSE_NS is the       */
+/*      time spent by expat itself, without the handlers of the         */
+/*      driver.                                                         */
+/************************************************************************/
+
+static char **SetStat( char **papszList, const char *pszName, GIntBig nValue )
+{
+    return CSLSetNameValue(papszList, pszName, CPLSPrintf(CPL_FRMT_GIB, nValue));
+}
+
+char **OGRVFPStatsToList( const OGRVFPStats *psStats, char **papszList )
+
+{
+    papszList = SetStat(papszList, "BYTES_READ", psStats->nBytesRead);
+    papszList = SetStat(papszList, "READ_CALLS", psStats->nReadCalls);
+    papszList = SetStat(papszList, "BYTES_MAPPED", psStats->nBytesMapped);
+    papszList = SetStat(papszList, "XML_EVENTS", psStats->nXMLEvents);
+    papszList = SetStat(papszList, "RECORDS", psStats->nRecords);
+    papszList = SetStat(papszList, "RECORDS_SKIPPED", psStats->nRecordsSkipped);
+    papszList = SetStat(papszList, "FEATURES_BUILT", psStats->nFeaturesBuilt);
+    papszList = SetStat(papszList, "FEATURES_RETURNED", psStats->nFeaturesReturned);
+    papszList = SetStat(papszList, "FEATURES_FILTERED", psStats->nFeaturesFiltered);
+    papszList = SetStat(papszList, "READ_NS", psStats->nReadNs);
+    papszList = SetStat(papszList, "PARSE_NS",
+                        MAX(0, psStats->nExpatNs - psStats->nHandlersNs));
+    papszList = SetStat(papszList, "ATTRIBUTES_NS", psStats->nAttributesNs);
+    papszList = SetStat(papszList, "COORDINATES_NS", psStats->nCoordinatesNs);
+    papszList = SetStat(papszList, "GEOMETRY_NS", psStats->nGeometryNs);
+    papszList = SetStat(papszList, "FILTER_NS", psStats->nFilterNs);
+    papszList = SetStat(papszList, "FEATURE_NS", psStats->nFeatureNs);
+    return papszList;
+}
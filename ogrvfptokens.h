@@ -0,0 +1,170 @@
+/* Generated by generate_schema.py from vfp_3.1.xsd, do not edit. */
+
+#ifndef _OGR_VFP_TOKENS_H_INCLUDED
+#define _OGR_VFP_TOKENS_H_INCLUDED
+
+/* Element names, xsi:type values and field names of the VFP schema */
+typedef enum
+{
+    VFP_TOKEN_UNKNOWN = 0,
+    VFP_TOKEN_AR,
+    VFP_TOKEN_AREA,
+    VFP_TOKEN_B,
+    VFP_TOKEN_BPEJ,
+    VFP_TOKEN_BPEJR2,
+    VFP_TOKEN_BRE,
+    VFP_TOKEN_BREM,
+    VFP_TOKEN_C,
+    VFP_TOKEN_CAOB,
+    VFP_TOKEN_CB,
+    VFP_TOKEN_CD,
+    VFP_TOKEN_CEN,
+    VFP_TOKEN_CENA,
+    VFP_TOKEN_CIRCLE,
+    VFP_TOKEN_CIS,
+    VFP_TOKEN_CO,
+    VFP_TOKEN_DIL,
+    VFP_TOKEN_DP,
+    VFP_TOKEN_DPO,
+    VFP_TOKEN_DPZ,
+    VFP_TOKEN_EMAIL,
+    VFP_TOKEN_GPAR,
+    VFP_TOKEN_HLAV,
+    VFP_TOKEN_HOLES,
+    VFP_TOKEN_HVPSZ,
+    VFP_TOKEN_HVPSZAREA,
+    VFP_TOKEN_HVPSZAREAS,
+    VFP_TOKEN_HVPSZLIN,
+    VFP_TOKEN_HVPSZLINS,
+    VFP_TOKEN_HVPSZTEXT,
+    VFP_TOKEN_HVPSZTEXTS,
+    VFP_TOKEN_HVPSZZNA,
+    VFP_TOKEN_HVPSZZNAS,
+    VFP_TOKEN_ICO,
+    VFP_TOKEN_ID,
+    VFP_TOKEN_JM,
+    VFP_TOKEN_KK,
+    VFP_TOKEN_KOD,
+    VFP_TOKEN_LIN,
+    VFP_TOKEN_LINPOL,
+    VFP_TOKEN_LV,
+    VFP_TOKEN_MC,
+    VFP_TOKEN_MDP,
+    VFP_TOKEN_MEON,
+    VFP_TOKEN_MEONAREA,
+    VFP_TOKEN_MEONAREAS,
+    VFP_TOKEN_MEONLIN,
+    VFP_TOKEN_MEONLINS,
+    VFP_TOKEN_MEONTEXT,
+    VFP_TOKEN_MEONTEXTS,
+    VFP_TOKEN_MEONZNA,
+    VFP_TOKEN_MEONZNAS,
+    VFP_TOKEN_MEOS,
+    VFP_TOKEN_MEOSAREA,
+    VFP_TOKEN_MEOSAREAS,
+    VFP_TOKEN_MEOSLIN,
+    VFP_TOKEN_MEOSLINS,
+    VFP_TOKEN_MEOSTEXT,
+    VFP_TOKEN_MEOSTEXTS,
+    VFP_TOKEN_MEOSZNA,
+    VFP_TOKEN_MEOSZNAS,
+    VFP_TOKEN_MP,
+    VFP_TOKEN_MPAREA,
+    VFP_TOKEN_MPAREAS,
+    VFP_TOKEN_MPLIN,
+    VFP_TOKEN_MPLINS,
+    VFP_TOKEN_MPTEXT,
+    VFP_TOKEN_MPTEXTS,
+    VFP_TOKEN_MPZNA,
+    VFP_TOKEN_MPZNAS,
+    VFP_TOKEN_NAROK,
+    VFP_TOKEN_NAVRH,
+    VFP_TOKEN_NAZ,
+    VFP_TOKEN_NC,
+    VFP_TOKEN_NCN,
+    VFP_TOKEN_NVLA,
+    VFP_TOKEN_NVLAS,
+    VFP_TOKEN_OB,
+    VFP_TOKEN_OCHR,
+    VFP_TOKEN_OKR,
+    VFP_TOKEN_OP,
+    VFP_TOKEN_OP_ID,
+    VFP_TOKEN_OPU,
+    VFP_TOKEN_PA,
+    VFP_TOKEN_PAR,
+    VFP_TOKEN_PARID,
+    VFP_TOKEN_PBRE,
+    VFP_TOKEN_PL,
+    VFP_TOKEN_PLIN,
+    VFP_TOKEN_PLINS,
+    VFP_TOKEN_PM,
+    VFP_TOKEN_PMAREA,
+    VFP_TOKEN_PMAREAS,
+    VFP_TOKEN_PMIMO,
+    VFP_TOKEN_PMLIN,
+    VFP_TOKEN_PMLINS,
+    VFP_TOKEN_PMTEXT,
+    VFP_TOKEN_PMTEXTS,
+    VFP_TOKEN_PMZNA,
+    VFP_TOKEN_PMZNAS,
+    VFP_TOKEN_PNERES,
+    VFP_TOKEN_POLYGON,
+    VFP_TOKEN_POPIS,
+    VFP_TOKEN_POR,
+    VFP_TOKEN_PORPART,
+    VFP_TOKEN_POROST,
+    VFP_TOKEN_POZ,
+    VFP_TOKEN_PR,
+    VFP_TOKEN_PSC,
+    VFP_TOKEN_PSOU,
+    VFP_TOKEN_PSOUR,
+    VFP_TOKEN_PSZ,
+    VFP_TOKEN_PTEXT,
+    VFP_TOKEN_PTEXTS,
+    VFP_TOKEN_PZNA,
+    VFP_TOKEN_PZNAS,
+    VFP_TOKEN_RC,
+    VFP_TOKEN_REG,
+    VFP_TOKEN_RES,
+    VFP_TOKEN_SE,
+    VFP_TOKEN_SEGMENT,
+    VFP_TOKEN_SOL,
+    VFP_TOKEN_SOLPART,
+    VFP_TOKEN_SOLID,
+    VFP_TOKEN_SOU,
+    VFP_TOKEN_SOUR,
+    VFP_TOKEN_SPOZ,
+    VFP_TOKEN_STA,
+    VFP_TOKEN_SX,
+    VFP_TOKEN_SY,
+    VFP_TOKEN_SZ,
+    VFP_TOKEN_T,
+    VFP_TOKEN_TEL,
+    VFP_TOKEN_TPJ,
+    VFP_TOKEN_TYP,
+    VFP_TOKEN_TZJ,
+    VFP_TOKEN_UCA,
+    VFP_TOKEN_UCAS,
+    VFP_TOKEN_UCASTNICI,
+    VFP_TOKEN_UL,
+    VFP_TOKEN_VFP,
+    VFP_TOKEN_VLA,
+    VFP_TOKEN_VLAS,
+    VFP_TOKEN_VYMNR,
+    VFP_TOKEN_VYMR,
+    VFP_TOKEN_VYMZ,
+    VFP_TOKEN_VZD,
+    VFP_TOKEN_ZNAPART,
+    VFP_TOKEN_ZS,
+    VFP_TOKEN_ZV,
+    VFP_TOKEN_ZVAREA,
+    VFP_TOKEN_ZVAREAS,
+    VFP_TOKEN_ZVBOD,
+    VFP_TOKEN_ZVBODS,
+    VFP_TOKEN_ZVLIN,
+    VFP_TOKEN_ZVLINS,
+    VFP_TOKEN_ZVZ,
+    VFP_TOKEN_COUNT
+} OGRVFPToken;
+
+#endif /* ndef _OGR_VFP_TOKENS_H_INCLUDED */
@@ -0,0 +1,1012 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  VFP Translator
+ * Purpose:  Implements OGRVFPWriter and OGRVFPWriterLayer classes.
+ * Author:   Martin Landa, landa.martin gmail.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, Martin Landa <landa.martin gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ogr_vfp.h"
+#include "cpl_conv.h"
+#include "cpl_string.h"
+
+#include <math.h>
+
+CPL_CVSID("$Id$");
+
+/* values below this are formatted with integer arithmetic, their
+   hundredths stay below 2^53 */
+#define VFP_MAX_FAST_COORDINATE 9.0e13
+#define VFP_MAX_FAST_REAL 1.0e13
+
+/* room reserved for a coordinate formatted by OGRVFPFormatCents() */
+#define VFP_CENTS_BUFFER_SIZE 32
+
+/************************************************************************/
+/*                         OGRVFPFormatCents()                          */
+/*                                                                      */
+/*      Format a number of hundredths as a decimal with two digits      */
+/*      after the point, without them if bTrim and they are zeros.      */
+/************************************************************************/
+
+static int OGRVFPFormatCents( GIntBig nCents, bool bTrim, char *pszOut )
+{
+    char szDigits[24];
+    int nDigits = 0;
+    GUIntBig nAbs = nCents < 0 ? (GUIntBig)(-nCents) : (GUIntBig)nCents;
+    do
+    {
+        szDigits[nDigits++] = (char)('0' + nAbs % 10);
+        nAbs /= 10;
+    } while( nAbs != 0 || nDigits < 3 );
+
+    int nLen = 0;
+    if( nCents < 0 )
+        pszOut[nLen++] = '-';
+    for( int i = nDigits - 1; i >= 2; i-- )
+        pszOut[nLen++] = szDigits[i];
+
+    if( bTrim && szDigits[0] == '0' )
+    {
+        if( szDigits[1] != '0' )
+        {
+            pszOut[nLen++] = '.';
+            pszOut[nLen++] = szDigits[1];
+        }
+        return nLen;
+    }
+    pszOut[nLen++] = '.';
+    pszOut[nLen++] = szDigits[1];
+    pszOut[nLen++] = szDigits[0];
+    return nLen;
+}
+
+/************************************************************************/
+/*                         OGRVFPFormatReal()                           */
+/*                                                                      */
+/*      Shortest decimal that reads back as the same double, in the     */
+/*      plain notation of xs:decimal. The common values with at most    */
+/*      two decimals (areas, prices) are formatted from their           */
+/*      hundredths: when n / 100.0 gives back the value, the decimal    */
+/*      n / 100 parses to it too, and with at most 15 significant       */
+/*      digits no shorter decimal does. Other values take the first     */
+/*      of 15, 16 or 17 significant digits that round-trips.            */
+/************************************************************************/
+
+static CPLString OGRVFPFormatReal( double dfValue )
+{
+    char szBuf[64];
+
+    if( fabs(dfValue) < VFP_MAX_FAST_REAL )
+    {
+        const GIntBig nCents = (GIntBig)floor(dfValue * 100.0 + 0.5);
+        if( (double)nCents / 100.0 == dfValue )
+        {
+            szBuf[OGRVFPFormatCents(nCents, TRUE, szBuf)] = '\0';
+            return szBuf;
+        }
+    }
+
+    int nPrecision = 15;
+    for( ; nPrecision < 17; nPrecision++ )
+    {
+        CPLsnprintf(szBuf, sizeof(szBuf), "%.*e", nPrecision - 1, dfValue);
+        if( CPLAtof(szBuf) == dfValue )
+            break;
+    }
+    if( nPrecision == 17 )
+        CPLsnprintf(szBuf, sizeof(szBuf), "%.*e", nPrecision - 1, dfValue);
+
+    /* d.ddde[+-]x to plain notation */
+    const char *pszIter = szBuf;
+    CPLString osSign;
+    if( *pszIter == '-' )
+    {
+        osSign = "-";
+        pszIter++;
+    }
+    CPLString osDigits;
+    for( ; *pszIter != 'e' && *pszIter != '\0'; pszIter++ )
+    {
+        if( *pszIter != '.' )
+            osDigits += *pszIter;
+    }
+    const int nExponent = *pszIter == 'e' ? atoi(pszIter + 1) : 0;
+    while( osDigits.size() > 1 && osDigits[osDigits.size() - 1] == '0' )
+        osDigits.resize(osDigits.size() - 1);
+
+    const int nDigits = (int)osDigits.size();
+    if( nExponent < 0 )
+        return osSign + "0." + CPLString().append(-nExponent - 1, '0') + osDigits;
+    if( nExponent + 1 >= nDigits )
+        return osSign + osDigits + CPLString().append(nExponent + 1 - nDigits, '0');
+    return osSign + osDigits.substr(0, nExponent + 1) + "." +
+           osDigits.substr(nExponent + 1);
+}
+
+/************************************************************************/
+/*                            OGRVFPWriter()                            */
+/************************************************************************/
+
+OGRVFPWriter::OGRVFPWriter( VSILFILE *fpIn, int nBufferSizeIn )
+{
+    fp = fpIn;
+    nBufferSize = nBufferSizeIn < 4096 ? 4096 : (size_t) nBufferSizeIn;
+    pachBuffer = (char *) CPLMalloc(nBufferSize);
+    nBufferUsed = 0;
+    bError = FALSE;
+
+    iCurLayer = -1;
+    pszCurLayer = NULL;
+    pszCurGroup = NULL;
+    bWarnedGroups = FALSE;
+}
+
+/************************************************************************/
+/*                           ~OGRVFPWriter()                            */
+/************************************************************************/
+
+OGRVFPWriter::~OGRVFPWriter()
+
+{
+    Close();
+    CPLFree(pachBuffer);
+}
+
+/************************************************************************/
+/*                            FlushBuffer()                             */
+/************************************************************************/
+
+bool OGRVFPWriter::FlushBuffer()
+{
+    if( nBufferUsed > 0 && !bError &&
+        VSIFWriteL(pachBuffer, 1, nBufferUsed, fp) != nBufferUsed )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Cannot write to the VFP file.");
+        bError = TRUE;
+    }
+    nBufferUsed = 0;
+    return !bError;
+}
+
+/************************************************************************/
+/*                              Reserve()                               */
+/*                                                                      */
+/*      Room for nSize bytes, no more than the size of the buffer, to   */
+/*      be formatted in place and committed by increasing nBufferUsed.  */
+/************************************************************************/
+
+char *OGRVFPWriter::Reserve( size_t nSize )
+{
+    if( nBufferUsed + nSize > nBufferSize )
+        FlushBuffer();
+    return pachBuffer + nBufferUsed;
+}
+
+/************************************************************************/
+/*                               Write()                                */
+/************************************************************************/
+
+void OGRVFPWriter::Write( const char *pachData, size_t nSize )
+{
+    if( nBufferUsed + nSize > nBufferSize )
+    {
+        FlushBuffer();
+        /* larger than the buffer, e.g. a long string value */
+        if( nSize > nBufferSize )
+        {
+            if( !bError && VSIFWriteL(pachData, 1, nSize, fp) != nSize )
+            {
+                CPLError(CE_Failure, CPLE_FileIO, "Cannot write to the VFP file.");
+                bError = TRUE;
+            }
+            return;
+        }
+    }
+    memcpy(pachBuffer + nBufferUsed, pachData, nSize);
+    nBufferUsed += nSize;
+}
+
+/************************************************************************/
+/*                            WriteEscaped()                            */
+/*                                                                      */
+/*      Text of an attribute value. The runs of characters without      */
+/*      markup are copied as they are; control characters that XML      */
+/*      does not allow are dropped.                                     */
+/************************************************************************/
+
+void OGRVFPWriter::WriteEscaped( const char *pszStr )
+{
+    const char *pszRun = pszStr;
+    for( const char *pszIter = pszStr; ; pszIter++ )
+    {
+        const char *pszEntity;
+        switch( *pszIter )
+        {
+            case '\0':
+                Write(pszRun, pszIter - pszRun);
+                return;
+            case '&':  pszEntity = "&amp;"; break;
+            case '<':  pszEntity = "&lt;"; break;
+            case '>':  pszEntity = "&gt;"; break;
+            case '"':  pszEntity = "&quot;"; break;
+            case '\t': pszEntity = "&#9;"; break;
+            case '\n': pszEntity = "&#10;"; break;
+            case '\r': pszEntity = "&#13;"; break;
+            default:
+                if( (unsigned char)*pszIter >= 0x20 )
+                    continue;
+                pszEntity = "";
+                break;
+        }
+        Write(pszRun, pszIter - pszRun);
+        Write(pszEntity);
+        pszRun = pszIter + 1;
+    }
+}
+
+/************************************************************************/
+/*                           WriteInteger()                             */
+/************************************************************************/
+
+void OGRVFPWriter::WriteInteger( GIntBig nValue )
+{
+    char szDigits[24];
+    int nDigits = 0;
+    GUIntBig nAbs = nValue < 0 ? (GUIntBig)0 - (GUIntBig)nValue : (GUIntBig)nValue;
+    do
+    {
+        szDigits[nDigits++] = (char)('0' + nAbs % 10);
+        nAbs /= 10;
+    } while( nAbs != 0 );
+
+    char *pszOut = Reserve(sizeof(szDigits));
+    int nLen = 0;
+    if( nValue < 0 )
+        pszOut[nLen++] = '-';
+    while( nDigits > 0 )
+        pszOut[nLen++] = szDigits[--nDigits];
+    nBufferUsed += nLen;
+}
+
+/************************************************************************/
+/*                             WriteReal()                              */
+/************************************************************************/
+
+void OGRVFPWriter::WriteReal( double dfValue )
+{
+    const CPLString osValue = OGRVFPFormatReal(dfValue);
+    Write(osValue.c_str(), osValue.size());
+}
+
+/************************************************************************/
+/*                          WriteCoordinate()                           */
+/*                                                                      */
+/*      Coordinates have two decimals in the schema                     */
+/*      (coordinateAttrType), they are rounded to the hundredth.        */
+/************************************************************************/
+
+void OGRVFPWriter::WriteCoordinate( double dfValue )
+{
+    if( fabs(dfValue) < VFP_MAX_FAST_COORDINATE )
+    {
+        const GIntBig nCents = (GIntBig)floor(dfValue * 100.0 + 0.5);
+        /* Reserve() may flush, nBufferUsed must be read after it */
+        char *pszOut = Reserve(VFP_CENTS_BUFFER_SIZE);
+        nBufferUsed += OGRVFPFormatCents(nCents, FALSE, pszOut);
+    }
+    else
+    {
+        Write(CPLSPrintf("%.2f", dfValue));
+    }
+}
+
+/************************************************************************/
+/*                          WriteAttribute()                            */
+/************************************************************************/
+
+void OGRVFPWriter::WriteAttribute( const char *pszName, const char *pszValue )
+{
+    Write(" ", 1);
+    Write(pszName);
+    Write("=\"", 2);
+    WriteEscaped(pszValue);
+    Write("\"", 1);
+}
+
+void OGRVFPWriter::WriteIntegerAttribute( const char *pszName, GIntBig nValue )
+{
+    Write(" ", 1);
+    Write(pszName);
+    Write("=\"", 2);
+    WriteInteger(nValue);
+    Write("\"", 1);
+}
+
+void OGRVFPWriter::WriteRealAttribute( const char *pszName, double dfValue )
+{
+    Write(" ", 1);
+    Write(pszName);
+    Write("=\"", 2);
+    WriteReal(dfValue);
+    Write("\"", 1);
+}
+
+void OGRVFPWriter::WriteCoordinateAttribute( const char *pszName, double dfValue )
+{
+    Write(" ", 1);
+    Write(pszName);
+    Write("=\"", 2);
+    WriteCoordinate(dfValue);
+    Write("\"", 1);
+}
+
+/************************************************************************/
+/*                             WritePoint()                             */
+/************************************************************************/
+
+void OGRVFPWriter::WritePoint( double dfX, double dfY, double dfZ, bool b3D )
+{
+    Write("<c", 2);
+    WriteCoordinateAttribute("x", dfX);
+    WriteCoordinateAttribute("y", dfY);
+    if( b3D )
+        WriteCoordinateAttribute("z", dfZ);
+    Write("/>", 2);
+}
+
+/************************************************************************/
+/*                      StartElement(), EndElement()                    */
+/************************************************************************/
+
+void OGRVFPWriter::StartElement( const char *pszName )
+{
+    Write("<", 1);
+    Write(pszName);
+    Write(">", 1);
+}
+
+void OGRVFPWriter::EndElement( const char *pszName )
+{
+    Write("</", 2);
+    Write(pszName);
+    Write(">", 1);
+}
+
+/************************************************************************/
+/*                             StartLayer()                             */
+/*                                                                      */
+/*      Make the element of a layer the current one. Fails if a layer   */
+/*      coming after it in the schema has been started already.         */
+/************************************************************************/
+
+bool OGRVFPWriter::StartLayer( int iLayer, const char *pszName )
+{
+    if( iLayer == iCurLayer )
+        return TRUE;
+    if( iLayer < iCurLayer )
+        return FALSE;
+
+    EndLayer();
+    Write("  <");
+    Write(pszName);
+    Write(">\n");
+    iCurLayer = iLayer;
+    pszCurLayer = pszName;
+    return TRUE;
+}
+
+/************************************************************************/
+/*                             StartGroup()                             */
+/*                                                                      */
+/*      Record group of a layer with two levels (zs/plins, ...). The    */
+/*      schema wants each group once, in order, so groups are only      */
+/*      repeated when the features of a layer come mixed.               */
+/************************************************************************/
+
+void OGRVFPWriter::StartGroup( const char *pszGroup )
+{
+    if( pszGroup == NULL || pszCurGroup == NULL ?
+        pszGroup == pszCurGroup : strcmp(pszGroup, pszCurGroup) == 0 )
+        return;
+
+    EndGroup();
+    if( pszGroup == NULL )
+        return;
+
+    for( size_t i = 0; i < apszUsedGroups.size(); i++ )
+    {
+        if( strcmp(apszUsedGroups[i], pszGroup) == 0 && !bWarnedGroups )
+        {
+            CPLError(CE_Warning, CPLE_AppDefined,
+                     "The features of layer %s are not sorted by their kind, "
+                     "the %s element is written several times.",
+                     pszCurLayer, pszGroup);
+            bWarnedGroups = TRUE;
+        }
+    }
+    apszUsedGroups.push_back(pszGroup);
+
+    Write("    <");
+    Write(pszGroup);
+    Write(">\n");
+    pszCurGroup = pszGroup;
+}
+
+/************************************************************************/
+/*                              EndGroup()                              */
+/************************************************************************/
+
+void OGRVFPWriter::EndGroup()
+{
+    if( pszCurGroup == NULL )
+        return;
+
+    Write("    </");
+    Write(pszCurGroup);
+    Write(">\n");
+    pszCurGroup = NULL;
+}
+
+/************************************************************************/
+/*                              EndLayer()                              */
+/************************************************************************/
+
+void OGRVFPWriter::EndLayer()
+{
+    if( pszCurLayer == NULL )
+        return;
+
+    EndGroup();
+    Write("  </");
+    Write(pszCurLayer);
+    Write(">\n");
+    pszCurLayer = NULL;
+    apszUsedGroups.clear();
+    bWarnedGroups = FALSE;
+}
+
+/************************************************************************/
+/*                               Close()                                */
+/*                                                                      */
+/*      Close the open elements and the file.                           */
+/************************************************************************/
+
+bool OGRVFPWriter::Close()
+{
+    if( fp == NULL )
+        return !bError;
+
+    EndLayer();
+    Write("</v:vfp>\n");
+    FlushBuffer();
+    if( VSIFCloseL(fp) != 0 && !bError )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Cannot write to the VFP file.");
+        bError = TRUE;
+    }
+    fp = NULL;
+    return !bError;
+}
+
+/************************************************************************/
+/*                         OGRVFPWriterLayer()                          */
+/************************************************************************/
+
+OGRVFPWriterLayer::OGRVFPWriterLayer( OGRVFPWriter *poWriterIn, int iLayerIn,
+                                      const OGRVFPLayerDesc *psDescIn,
+                                      OGRSpatialReference *poSRS )
+{
+    poWriter = poWriterIn;
+    iLayer = iLayerIn;
+    psDesc = psDescIn;
+    nFeatures = 0;
+    bWarnedNoGeometry = FALSE;
+    bWarnedParts = FALSE;
+
+    poFeatureDefn = new OGRFeatureDefn( psDesc->pszName );
+    SetDescription( poFeatureDefn->GetName() );
+    poFeatureDefn->Reference();
+    if (!psDesc->bHasGeometry)
+        poFeatureDefn->SetGeomType(wkbNone);
+
+    /* same fields as a layer being read */
+    for (int i = 0; i < psDesc->nFields; i++)
+    {
+        OGRFieldDefn oFieldDefn(psDesc->pasFields[i].pszName,
+                                psDesc->pasFields[i].eType);
+        poFeatureDefn->AddFieldDefn(&oFieldDefn);
+    }
+    if( poFeatureDefn->GetGeomFieldCount() != 0 )
+        poFeatureDefn->GetGeomFieldDefn(0)->SetSpatialRef(poSRS);
+
+    for (int i = 0; i < psDesc->nRecords; i++)
+    {
+        const char *pszPath = psDesc->pasRecords[i].pszGeometryPath;
+        apapszPaths.push_back(pszPath != NULL ?
+                              CSLTokenizeString2(pszPath, "/", 0) : NULL);
+    }
+}
+
+/************************************************************************/
+/*                         ~OGRVFPWriterLayer()                         */
+/************************************************************************/
+
+OGRVFPWriterLayer::~OGRVFPWriterLayer()
+
+{
+    for( size_t i = 0; i < apapszPaths.size(); i++ )
+        CSLDestroy(apapszPaths[i]);
+    poFeatureDefn->Release();
+}
+
+/************************************************************************/
+/*                            CreateField()                             */
+/*                                                                      */
+/*      The fields are fixed by the schema, only those it defines can   */
+/*      be "created" again, e.g. by ogr2ogr.                            */
+/************************************************************************/
+
+OGRErr OGRVFPWriterLayer::CreateField( OGRFieldDefn *poField,
+                                       CPL_UNUSED int bApproxOK )
+{
+    if( poFeatureDefn->GetFieldIndex(poField->GetNameRef()) >= 0 )
+        return OGRERR_NONE;
+
+    CPLError(CE_Failure, CPLE_NotSupported,
+             "Field %s is not defined by the VFP schema for layer %s.",
+             poField->GetNameRef(), psDesc->pszName);
+    return OGRERR_FAILURE;
+}
+
+/************************************************************************/
+/*                             FindRecord()                             */
+/*                                                                      */
+/*      Record template for the geometry of a feature, and among the    */
+/*      templates of the same kind (sol or por porost, pzna or psou     */
+/*      point of zs) the one with attributes for most of the fields     */
+/*      set. -1 if the geometry does not fit in the layer.              */
+/************************************************************************/
+
+int OGRVFPWriterLayer::FindRecord( OGRFeature *poFeature, OGRGeometry *poGeom )
+{
+    int eGeometry = VFP_RECORD_NONE;
+    bool bSinglePoint = FALSE;
+    if( poGeom != NULL )
+    {
+        switch( wkbFlatten(poGeom->getGeometryType()) )
+        {
+            case wkbPolygon:
+            case wkbCurvePolygon:
+            case wkbMultiPolygon:
+            case wkbMultiSurface:
+                eGeometry = VFP_RECORD_REGION;
+                break;
+            case wkbLineString:
+            case wkbCircularString:
+            case wkbCompoundCurve:
+            case wkbMultiLineString:
+            case wkbMultiCurve:
+                eGeometry = VFP_RECORD_LINE;
+                break;
+            case wkbPoint:
+                bSinglePoint = TRUE;
+                eGeometry = VFP_RECORD_POINT;
+                break;
+            case wkbMultiPoint:
+                eGeometry = VFP_RECORD_POINT;
+                break;
+            default:
+                return -1;
+        }
+    }
+
+    int iBest = -1;
+    int nBestFields = -1;
+    for( int i = 0; i < psDesc->nRecords; i++ )
+    {
+        const OGRVFPRecordDesc *psRecord = psDesc->pasRecords + i;
+        if( psRecord->eGeometry != eGeometry &&
+            !(psRecord->eGeometry == VFP_RECORD_POINT_ATTR && bSinglePoint) )
+            continue;
+
+        int nFields = 0;
+        for( int iField = 0; iField < psDesc->nFields; iField++ )
+        {
+            if( (psRecord->nFieldMask & (1U << iField)) != 0 &&
+                poFeature->IsFieldSet(iField) )
+                nFields++;
+        }
+        if( nFields > nBestFields )
+        {
+            iBest = i;
+            nBestFields = nFields;
+        }
+    }
+
+    /* without geometry, a record of the layer with its geometry left out */
+    if( iBest < 0 && eGeometry == VFP_RECORD_NONE && psDesc->nRecords > 0 )
+        iBest = 0;
+    return iBest;
+}
+
+/************************************************************************/
+/*                          WriteAttributes()                           */
+/************************************************************************/
+
+void OGRVFPWriterLayer::WriteAttributes( const OGRVFPRecordDesc *psRecord,
+                                         OGRFeature *poFeature )
+{
+    for( int i = 0; i < psDesc->nFields; i++ )
+    {
+        if( (psRecord->nFieldMask & (1U << i)) == 0 || !poFeature->IsFieldSet(i) )
+            continue;
+
+        const char *pszName = psDesc->pasFields[i].pszName;
+        switch( psDesc->pasFields[i].eType )
+        {
+            case OFTInteger:
+            case OFTInteger64:
+                poWriter->WriteIntegerAttribute(pszName,
+                                                poFeature->GetFieldAsInteger64(i));
+                break;
+
+            case OFTReal:
+            {
+                const double dfValue = poFeature->GetFieldAsDouble(i);
+                if( CPLIsFinite(dfValue) )
+                    poWriter->WriteRealAttribute(pszName, dfValue);
+                break;
+            }
+
+            default:
+                poWriter->WriteAttribute(pszName, poFeature->GetFieldAsString(i));
+                break;
+        }
+    }
+}
+
+/************************************************************************/
+/*                           WriteSegments()                            */
+/*                                                                      */
+/*      Line strings give one se segment, circular strings an ar        */
+/*      segment for each arc, compound curves the segments of their     */
+/*      parts in turn.                                                  */
+/************************************************************************/
+
+void OGRVFPWriterLayer::WriteSegments( OGRCurve *poCurve, bool b3D )
+{
+    const OGRwkbGeometryType eType = wkbFlatten(poCurve->getGeometryType());
+    if( eType == wkbCompoundCurve )
+    {
+        OGRCompoundCurve *poCC = (OGRCompoundCurve *) poCurve;
+        for( int i = 0; i < poCC->getNumCurves(); i++ )
+            WriteSegments(poCC->getCurve(i), b3D);
+        return;
+    }
+
+    OGRSimpleCurve *poSC = (OGRSimpleCurve *) poCurve;
+    const int nPoints = poSC->getNumPoints();
+    if( eType == wkbCircularString )
+    {
+        for( int i = 0; i + 2 < nPoints; i += 2 )
+        {
+            poWriter->Write("<segment xsi:type=\"v:ar\">");
+            for( int j = i; j < i + 3; j++ )
+                poWriter->WritePoint(poSC->getX(j), poSC->getY(j),
+                                     poSC->getZ(j), b3D);
+            poWriter->Write("</segment>");
+        }
+    }
+    else if( nPoints >= 2 )
+    {
+        poWriter->Write("<segment xsi:type=\"v:se\">");
+        for( int j = 0; j < nPoints; j++ )
+            poWriter->WritePoint(poSC->getX(j), poSC->getY(j),
+                                 poSC->getZ(j), b3D);
+        poWriter->Write("</segment>");
+    }
+}
+
+/************************************************************************/
+/*                             WriteRing()                              */
+/*                                                                      */
+/*      A full circle (a closed circular string of one arc) is written  */
+/*      as a circle polygon, as the reader builds it.                   */
+/************************************************************************/
+
+void OGRVFPWriterLayer::WriteRing( OGRCurve *poRing, bool b3D )
+{
+    if( wkbFlatten(poRing->getGeometryType()) == wkbCircularString )
+    {
+        OGRSimpleCurve *poSC = (OGRSimpleCurve *) poRing;
+        if( poSC->getNumPoints() == 3 &&
+            poSC->getX(0) == poSC->getX(2) && poSC->getY(0) == poSC->getY(2) )
+        {
+            const double dfDX = poSC->getX(1) - poSC->getX(0);
+            const double dfDY = poSC->getY(1) - poSC->getY(0);
+            poWriter->Write("<polygon xsi:type=\"v:circle\"");
+            poWriter->WriteRealAttribute("r", sqrt(dfDX * dfDX + dfDY * dfDY) / 2);
+            poWriter->Write(">");
+            poWriter->WritePoint((poSC->getX(0) + poSC->getX(1)) / 2,
+                                 (poSC->getY(0) + poSC->getY(1)) / 2,
+                                 poSC->getZ(0), b3D);
+            poWriter->Write("</polygon>");
+            return;
+        }
+    }
+
+    poWriter->Write("<polygon xsi:type=\"v:linpol\">");
+    WriteSegments(poRing, b3D);
+    poWriter->Write("</polygon>");
+}
+
+/************************************************************************/
+/*                             WritePart()                              */
+/*                                                                      */
+/*      reg, lin or c element of a single geometry.                     */
+/************************************************************************/
+
+void OGRVFPWriterLayer::WritePart( const OGRVFPRecordDesc *psRecord,
+                                   const char *pszElement, OGRGeometry *poPart,
+                                   bool b3D )
+{
+    switch( psRecord->eGeometry )
+    {
+        case VFP_RECORD_REGION:
+        {
+            OGRCurvePolygon *poSurface = (OGRCurvePolygon *) poPart;
+            poWriter->StartElement(pszElement);
+            poWriter->StartElement("solid");
+            WriteRing(poSurface->getExteriorRingCurve(), b3D);
+            poWriter->EndElement("solid");
+            if( poSurface->getNumInteriorRings() > 0 )
+            {
+                poWriter->StartElement("holes");
+                for( int i = 0; i < poSurface->getNumInteriorRings(); i++ )
+                    WriteRing(poSurface->getInteriorRingCurve(i), b3D);
+                poWriter->EndElement("holes");
+            }
+            poWriter->EndElement(pszElement);
+            break;
+        }
+
+        case VFP_RECORD_LINE:
+            poWriter->StartElement(pszElement);
+            WriteSegments((OGRCurve *) poPart, b3D);
+            poWriter->EndElement(pszElement);
+            break;
+
+        case VFP_RECORD_POINT:
+        {
+            OGRPoint *poPoint = (OGRPoint *) poPart;
+            poWriter->WritePoint(poPoint->getX(), poPoint->getY(),
+                                 poPoint->getZ(), b3D);
+            break;
+        }
+    }
+}
+
+/************************************************************************/
+/*                             WriteLabel()                             */
+/*                                                                      */
+/*      t element required after the reg of an area, placed at the      */
+/*      centre of the envelope of the region.                           */
+/************************************************************************/
+
+void OGRVFPWriterLayer::WriteLabel( OGRGeometry *poGeom, const char *pszLabel )
+{
+    OGREnvelope sEnvelope;
+    poGeom->getEnvelope(&sEnvelope);
+
+    poWriter->Write("<t");
+    poWriter->WriteAttribute("hod", pszLabel);
+    poWriter->Write(">");
+    poWriter->WritePoint((sEnvelope.MinX + sEnvelope.MaxX) / 2,
+                         (sEnvelope.MinY + sEnvelope.MaxY) / 2, 0.0, FALSE);
+    poWriter->Write("</t>");
+}
+
+/************************************************************************/
+/*                           WriteGeometry()                            */
+/*                                                                      */
+/*      The elements of the geometry path up to the repeated one are    */
+/*      written once, the others for each part of a multi geometry,     */
+/*      e.g. gpar, then area/reg/t for each polygon of a parcel.        */
+/************************************************************************/
+
+void OGRVFPWriterLayer::WriteGeometry( int iRecord, OGRGeometry *poGeom,
+                                       const char *pszLabel )
+{
+    const OGRVFPRecordDesc *psRecord = psDesc->pasRecords + iRecord;
+    char **papszPath = apapszPaths[iRecord];
+    const int nPath = CSLCount(papszPath);
+    const bool b3D = poGeom->getCoordinateDimension() == 3;
+
+    OGRGeometryCollection *poColl = NULL;
+    int nParts = 1;
+    if( OGR_GT_IsSubClassOf(wkbFlatten(poGeom->getGeometryType()),
+                            wkbGeometryCollection) )
+    {
+        poColl = (OGRGeometryCollection *) poGeom;
+        nParts = poColl->getNumGeometries();
+    }
+    int iRepeat = psRecord->iRepeat;
+    if( iRepeat < 0 )
+    {
+        if( nParts > 1 && !bWarnedParts )
+        {
+            CPLError(CE_Warning, CPLE_AppDefined,
+                     "The records of layer %s have a single %s, only the first "
+                     "part of multi geometries is written.",
+                     psDesc->pszName, papszPath[nPath - 1]);
+            bWarnedParts = TRUE;
+        }
+        iRepeat = nPath - 1;
+    }
+
+    for( int i = 0; i < iRepeat; i++ )
+        poWriter->StartElement(papszPath[i]);
+
+    int nWritten = 0;
+    for( int iPart = 0; iPart < nParts; iPart++ )
+    {
+        OGRGeometry *poPart = poColl != NULL ? poColl->getGeometryRef(iPart) : poGeom;
+        if( poPart->IsEmpty() )
+            continue;
+        if( nWritten > 0 && psRecord->iRepeat < 0 )
+            break;
+        nWritten++;
+
+        for( int i = iRepeat; i < nPath - 1; i++ )
+            poWriter->StartElement(papszPath[i]);
+        WritePart(psRecord, papszPath[nPath - 1], poPart, b3D);
+        if( psRecord->bLabel && iRepeat < nPath - 1 )
+            WriteLabel(poPart, pszLabel);
+        for( int i = nPath - 2; i >= iRepeat; i-- )
+            poWriter->EndElement(papszPath[i]);
+    }
+    if( psRecord->bLabel && iRepeat == nPath - 1 )
+        WriteLabel(poGeom, pszLabel);
+
+    for( int i = iRepeat - 1; i >= 0; i-- )
+        poWriter->EndElement(papszPath[i]);
+}
+
+/************************************************************************/
+/*                           ICreateFeature()                           */
+/*                                                                      */
+/*      The record is written out right away, one per line.             */
+/************************************************************************/
+
+OGRErr OGRVFPWriterLayer::ICreateFeature( OGRFeature *poFeature )
+{
+    if( poWriter->HasError() )
+        return OGRERR_FAILURE;
+
+    OGRGeometry *poGeom = poFeature->GetGeometryRef();
+    if( poGeom != NULL && (poGeom->IsEmpty() || !psDesc->bHasGeometry) )
+        poGeom = NULL;
+
+    const int iRecord = FindRecord(poFeature, poGeom);
+    if( iRecord < 0 )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "%s geometries cannot be written to layer %s.",
+                 poGeom->getGeometryName(), psDesc->pszName);
+        return OGRERR_FAILURE;
+    }
+
+    if( !poWriter->StartLayer(iLayer, psDesc->pszName) )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Layer %s cannot be written to any more. The layers of a VFP "
+                 "file are written in the order of the schema, and a layer "
+                 "coming after it has been written to already.",
+                 psDesc->pszName);
+        return OGRERR_FAILURE;
+    }
+
+    const OGRVFPRecordDesc *psRecord = psDesc->pasRecords + iRecord;
+    poWriter->StartGroup(psRecord->pszGroup);
+
+    poWriter->Write(psDesc->nRecordDepth == 2 ? "      <" : "    <");
+    poWriter->Write(psRecord->pszRecord);
+    if( psRecord->pszType != NULL )
+        poWriter->WriteAttribute("xsi:type",
+                                 CPLSPrintf("v:%s", psRecord->pszType));
+    WriteAttributes(psRecord, poFeature);
+
+    if( poGeom != NULL && psRecord->eGeometry == VFP_RECORD_POINT_ATTR )
+    {
+        OGRPoint *poPoint = (OGRPoint *) poGeom;
+        poWriter->WriteCoordinateAttribute("sx", poPoint->getX());
+        poWriter->WriteCoordinateAttribute("sy", poPoint->getY());
+        if( poPoint->getCoordinateDimension() == 3 )
+            poWriter->WriteCoordinateAttribute("sz", poPoint->getZ());
+        poWriter->Write("/>\n");
+    }
+    else if( poGeom != NULL )
+    {
+        /* text of the label: the first attribute, e.g. the parcel id */
+        CPLString osLabel;
+        for( int i = 0; psRecord->bLabel && i < psDesc->nFields; i++ )
+        {
+            if( (psRecord->nFieldMask & (1U << i)) != 0 &&
+                poFeature->IsFieldSet(i) )
+            {
+                osLabel = poFeature->GetFieldAsString(i);
+                break;
+            }
+        }
+        if( psRecord->bLabel && osLabel.empty() )
+            osLabel.Printf(CPL_FRMT_GIB, poFeature->GetFID() != OGRNullFID ?
+                                         poFeature->GetFID() : nFeatures);
+
+        poWriter->Write(">");
+        WriteGeometry(iRecord, poGeom, osLabel);
+        poWriter->Write("</");
+        poWriter->Write(psRecord->pszRecord);
+        poWriter->Write(">\n");
+    }
+    else
+    {
+        if( psRecord->eGeometry != VFP_RECORD_NONE && !bWarnedNoGeometry )
+        {
+            CPLError(CE_Warning, CPLE_AppDefined,
+                     "Features without geometry are written to layer %s "
+                     "without the geometry its records require.",
+                     psDesc->pszName);
+            bWarnedNoGeometry = TRUE;
+        }
+        poWriter->Write("/>\n");
+    }
+
+    if( poFeature->GetFID() == OGRNullFID )
+        poFeature->SetFID(nFeatures);
+    nFeatures++;
+
+    return poWriter->HasError() ? OGRERR_FAILURE : OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                           TestCapability()                           */
+/************************************************************************/
+
+int OGRVFPWriterLayer::TestCapability( const char * pszCap )
+{
+    if (EQUAL(pszCap, OLCSequentialWrite))
+        return TRUE;
+
+    if (EQUAL(pszCap, OLCCreateField))
+        return TRUE;
+
+    if (EQUAL(pszCap, OLCCurveGeometries))
+        return TRUE;
+
+    if (EQUAL(pszCap, OLCStringsAsUTF8))
+        return TRUE;
+
+    return FALSE;
+}
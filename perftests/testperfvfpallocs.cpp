@@ -0,0 +1,189 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  VFP Translator
+ * Purpose:  Counts the heap allocations of the VFP driver per feature.
+ * Author:   Martin Landa, landa.martin gmail.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, Martin Landa <landa.martin gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "../ogr_vfp.h"
+#include "vfpgeneratefile.h"
+#include "gdal_priv.h"
+#include "cpl_conv.h"
+#include "cpl_string.h"
+
+/* Every malloc(), calloc() and realloc() of the process is counted by
+   replacing them with wrappers of the glibc allocator; operator new and
+   CPLMalloc() end up there as well. For each feature read, the
+   allocations of GetNextFeature() are compared with those of Clone(),
+   which allocates the same feature, fields and geometry objects and
+   nothing else. The difference is the transient allocation of the
+   driver, which should be close to 0 per feature. */
+
+#ifdef __GLIBC__
+
+static GIntBig nAllocs = 0;
+
+extern "C"
+{
+void *__libc_malloc( size_t nSize );
+void *__libc_calloc( size_t nCount, size_t nSize );
+void *__libc_realloc( void *pData, size_t nSize );
+void __libc_free( void *pData );
+
+void *malloc( size_t nSize ) throw()
+{
+    nAllocs++;
+    return __libc_malloc(nSize);
+}
+
+void *calloc( size_t nCount, size_t nSize ) throw()
+{
+    nAllocs++;
+    return __libc_calloc(nCount, nSize);
+}
+
+void *realloc( void *pData, size_t nSize ) throw()
+{
+    nAllocs++;
+    return __libc_realloc(pData, nSize);
+}
+
+void free( void *pData ) throw()
+{
+    __libc_free(pData);
+}
+}
+
+int main( int argc, char **argv )
+{
+    int nParcels = 100000;
+    const char *pszFilename = NULL;
+    double dfMaxOverhead = -1.0;
+    char **papszOpenOptions = NULL;
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( EQUAL(argv[i], "-parcels") && i + 1 < argc )
+            nParcels = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-max-overhead") && i + 1 < argc )
+            dfMaxOverhead = CPLAtof(argv[++i]);
+        else if( EQUAL(argv[i], "-oo") && i + 1 < argc )
+            papszOpenOptions = CSLAddString(papszOpenOptions, argv[++i]);
+        else if( argv[i][0] != '-' && pszFilename == NULL )
+            pszFilename = argv[i];
+        else
+        {
+            printf("Usage: testperfvfpallocs [-parcels n] [-max-overhead n] "
+                   "[-oo NAME=VALUE]* [file.vfp]\n");
+            return 1;
+        }
+    }
+
+    GDALAllRegister();
+
+    CPLString osSynthetic;
+    if( pszFilename == NULL )
+    {
+        /* about one parcel in four has an arc, so that both linear
+           and compound rings are built */
+        VFPGenerateOptions sOptions;
+        VFPGenerateParcelOptions(&sOptions, nParcels);
+        sOptions.nArcPercent = 25;
+        osSynthetic = VFPGenerateTempFile("testperfvfpallocs", &sOptions);
+        pszFilename = osSynthetic.c_str();
+    }
+
+    GDALDataset *poDS = (GDALDataset *)
+        GDALOpenEx(pszFilename, GDAL_OF_VECTOR | GDAL_OF_READONLY, NULL,
+                   papszOpenOptions, NULL);
+    CSLDestroy(papszOpenOptions);
+    if( poDS == NULL )
+    {
+        fprintf(stderr, "cannot open %s\n", pszFilename);
+        return 1;
+    }
+
+    double dfWorstOverhead = 0.0;
+    for( int iLayer = 0; iLayer < poDS->GetLayerCount(); iLayer++ )
+    {
+        OGRLayer *poLayer = poDS->GetLayer(iLayer);
+        GIntBig nFeatures = 0, nRead = 0, nFeatureAllocs = 0;
+
+        /* the first feature also sets up the parser and its buffers */
+        GIntBig nBefore = nAllocs;
+        OGRFeature *poFeature = poLayer->GetNextFeature();
+        const GIntBig nFirst = nAllocs - nBefore;
+        while( poFeature != NULL )
+        {
+            nBefore = nAllocs;
+            OGRFeature *poClone = poFeature->Clone();
+            nFeatureAllocs += nAllocs - nBefore;
+            delete poClone;
+            delete poFeature;
+            nFeatures++;
+
+            nBefore = nAllocs;
+            poFeature = poLayer->GetNextFeature();
+            nRead += nAllocs - nBefore;
+        }
+        if( nFeatures == 0 )
+            continue;
+
+        /* the read count covers features 2..n, the clone count 1..n */
+        const double dfRead = (double)(nRead + nFirst) / nFeatures;
+        const double dfFeature = (double)nFeatureAllocs / nFeatures;
+        const double dfOverhead = dfRead - dfFeature;
+        printf("%s: features=" CPL_FRMT_GIB " allocs/feature=%.2f "
+               "feature objects=%.2f driver=%.2f first feature=" CPL_FRMT_GIB "\n",
+               poLayer->GetName(), nFeatures, dfRead, dfFeature, dfOverhead, nFirst);
+        if( nFeatures > 1000 && dfOverhead > dfWorstOverhead )
+            dfWorstOverhead = dfOverhead;
+    }
+
+    GDALClose(poDS);
+    if( !osSynthetic.empty() )
+    {
+        VSIUnlink(osSynthetic);
+        VSIUnlink(CPLResetExtension(osSynthetic, "vfpi"));
+    }
+
+    if( dfMaxOverhead >= 0 && dfWorstOverhead > dfMaxOverhead )
+    {
+        printf("driver allocations per feature %.2f > %.2f\n",
+               dfWorstOverhead, dfMaxOverhead);
+        return 1;
+    }
+    return 0;
+}
+
+#else
+
+int main()
+{
+    printf("testperfvfpallocs needs the glibc allocator to count allocations\n");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,306 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  VFP Translator
+ * Purpose:  Compares the Arrow stream of a VFP layer with a row to column
+ *           conversion of its features.
+ * Author:   Martin Landa, landa.martin gmail.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, Martin Landa <landa.martin gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "../ogr_vfp.h"
+#include "vfpgeneratefile.h"
+#include "gdal_priv.h"
+#include "cpl_conv.h"
+#include "cpl_string.h"
+
+#include <time.h>
+#include <vector>
+
+/* The generic adapter is what an application does without the stream:
+   each OGRFeature returned by GetNextFeature() is appended to column
+   buffers of the same layout (validity bits, values, string offsets and
+   WKB), which are emptied every MAX_FEATURES_IN_BATCH features. Both
+   sides count the rows, the non-null values and the WKB bytes, which
+   must match. */
+
+typedef struct
+{
+    GIntBig            nRows;
+    GIntBig            nValues;
+    GIntBig            nWkbBytes;
+} ArrowCounts;
+
+static double Elapsed( clock_t nStart )
+{
+    return (double)(clock() - nStart) / CLOCKS_PER_SEC;
+}
+
+/************************************************************************/
+/*                             ReadStream()                             */
+/************************************************************************/
+
+static bool ReadStream( OGRLayer *poLayer, char **papszOptions,
+                        ArrowCounts *psCounts )
+{
+    struct ArrowArrayStream sStream;
+    if( !OGR_VFP_L_GetArrowStream((OGRLayerH) poLayer, &sStream, papszOptions) )
+        return false;
+
+    struct ArrowSchema sSchema;
+    sStream.get_schema(&sStream, &sSchema);
+
+    bool bOK = true;
+    while( true )
+    {
+        struct ArrowArray sArray;
+        if( sStream.get_next(&sStream, &sArray) != 0 )
+        {
+            fprintf(stderr, "%s\n", sStream.get_last_error(&sStream));
+            bOK = false;
+            break;
+        }
+        if( sArray.release == NULL )
+            break;
+
+        psCounts->nRows += sArray.length;
+        for( int64_t i = 0; i < sArray.n_children; i++ )
+        {
+            const struct ArrowArray *psChild = sArray.children[i];
+            if( EQUAL(sSchema.children[i]->name, "OGC_FID") )
+                continue;
+            psCounts->nValues += psChild->length - psChild->null_count;
+            if( EQUAL(sSchema.children[i]->format, "z") )
+                psCounts->nWkbBytes +=
+                    ((const GInt32 *) psChild->buffers[1])[psChild->length];
+        }
+        sArray.release(&sArray);
+    }
+
+    sSchema.release(&sSchema);
+    sStream.release(&sStream);
+    return bOK;
+}
+
+/************************************************************************/
+/*                            ReadFeatures()                            */
+/************************************************************************/
+
+typedef struct
+{
+    std::vector<GByte> abyValidity;
+    std::vector<GByte> abyValues;
+    std::vector<GInt32> anOffsets;
+} GenericColumn;
+
+static void AppendBit( std::vector<GByte> &abyValidity, int iRow, bool bValid )
+{
+    if( iRow % 8 == 0 )
+        abyValidity.push_back(0);
+    if( bValid )
+        abyValidity.back() |= (GByte)(1 << (iRow % 8));
+}
+
+static void AppendBytes( std::vector<GByte> &abyValues, const void *pData, size_t nSize )
+{
+    abyValues.insert(abyValues.end(), (const GByte *) pData,
+                     (const GByte *) pData + nSize);
+}
+
+static void ReadFeatures( OGRLayer *poLayer, int nBatchSize, ArrowCounts *psCounts )
+{
+    OGRFeatureDefn *poDefn = poLayer->GetLayerDefn();
+    const int nFields = poDefn->GetFieldCount();
+    std::vector<GenericColumn> asColumns(nFields + 2);
+    int nLength = 0;
+
+    poLayer->ResetReading();
+    OGRFeature *poFeature;
+    while( (poFeature = poLayer->GetNextFeature()) != NULL )
+    {
+        const GIntBig nFID = poFeature->GetFID();
+        AppendBytes(asColumns[nFields].abyValues, &nFID, sizeof(nFID));
+
+        for( int i = 0; i < nFields; i++ )
+        {
+            GenericColumn &oColumn = asColumns[i];
+            const bool bSet = poFeature->IsFieldSet(i) != FALSE;
+            AppendBit(oColumn.abyValidity, nLength, bSet);
+            if( bSet )
+                psCounts->nValues++;
+            switch( poDefn->GetFieldDefn(i)->GetType() )
+            {
+                case OFTInteger:
+                {
+                    const GInt32 nValue = poFeature->GetFieldAsInteger(i);
+                    AppendBytes(oColumn.abyValues, &nValue, sizeof(nValue));
+                    break;
+                }
+                case OFTInteger64:
+                {
+                    const GIntBig nValue = poFeature->GetFieldAsInteger64(i);
+                    AppendBytes(oColumn.abyValues, &nValue, sizeof(nValue));
+                    break;
+                }
+                case OFTReal:
+                {
+                    const double dfValue = poFeature->GetFieldAsDouble(i);
+                    AppendBytes(oColumn.abyValues, &dfValue, sizeof(dfValue));
+                    break;
+                }
+                default:
+                {
+                    const char *pszValue = poFeature->GetFieldAsString(i);
+                    AppendBytes(oColumn.abyValues, pszValue, strlen(pszValue));
+                    oColumn.anOffsets.push_back((GInt32) oColumn.abyValues.size());
+                    break;
+                }
+            }
+        }
+
+        OGRGeometry *poGeom = poFeature->GetGeometryRef();
+        GenericColumn &oGeom = asColumns[nFields + 1];
+        AppendBit(oGeom.abyValidity, nLength, poGeom != NULL);
+        if( poGeom != NULL )
+        {
+            const size_t nOffset = oGeom.abyValues.size();
+            const int nWkbSize = poGeom->WkbSize();
+            oGeom.abyValues.resize(nOffset + nWkbSize);
+            poGeom->exportToWkb(wkbNDR, &oGeom.abyValues[nOffset], wkbVariantIso);
+            psCounts->nWkbBytes += nWkbSize;
+            psCounts->nValues++;
+        }
+        oGeom.anOffsets.push_back((GInt32) oGeom.abyValues.size());
+
+        delete poFeature;
+        psCounts->nRows++;
+        if( ++nLength == nBatchSize )
+        {
+            for( size_t i = 0; i < asColumns.size(); i++ )
+            {
+                asColumns[i].abyValidity.resize(0);
+                asColumns[i].abyValues.resize(0);
+                asColumns[i].anOffsets.resize(0);
+            }
+            nLength = 0;
+        }
+    }
+}
+
+int main( int argc, char **argv )
+{
+    int nParcels = 200000;
+    int nBatchSize = 65536;
+    const char *pszFilename = NULL;
+    char **papszOpenOptions = NULL;
+    char **papszStreamOptions = NULL;
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( EQUAL(argv[i], "-parcels") && i + 1 < argc )
+            nParcels = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-batch") && i + 1 < argc )
+            nBatchSize = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-oo") && i + 1 < argc )
+            papszOpenOptions = CSLAddString(papszOpenOptions, argv[++i]);
+        else if( EQUAL(argv[i], "-so") && i + 1 < argc )
+            papszStreamOptions = CSLAddString(papszStreamOptions, argv[++i]);
+        else if( argv[i][0] != '-' && pszFilename == NULL )
+            pszFilename = argv[i];
+        else
+        {
+            printf("Usage: testperfvfparrow [-parcels n] [-batch n] "
+                   "[-oo NAME=VALUE]* [-so NAME=VALUE]* [file.vfp]\n");
+            return 1;
+        }
+    }
+    papszStreamOptions = CSLSetNameValue(papszStreamOptions, "MAX_FEATURES_IN_BATCH",
+                                         CPLSPrintf("%d", nBatchSize));
+
+    GDALAllRegister();
+
+    CPLString osSynthetic;
+    if( pszFilename == NULL )
+    {
+        VFPGenerateOptions sOptions;
+        VFPGenerateParcelOptions(&sOptions, nParcels);
+        osSynthetic = VFPGenerateTempFile("testperfvfparrow", &sOptions);
+        pszFilename = osSynthetic.c_str();
+    }
+
+    GDALDataset *poDS = (GDALDataset *)
+        GDALOpenEx(pszFilename, GDAL_OF_VECTOR | GDAL_OF_READONLY, NULL,
+                   papszOpenOptions, NULL);
+    CSLDestroy(papszOpenOptions);
+    if( poDS == NULL )
+    {
+        fprintf(stderr, "cannot open %s\n", pszFilename);
+        CSLDestroy(papszStreamOptions);
+        return 1;
+    }
+
+    int nMismatches = 0;
+    for( int iLayer = 0; iLayer < poDS->GetLayerCount(); iLayer++ )
+    {
+        OGRLayer *poLayer = poDS->GetLayer(iLayer);
+        if( poLayer->GetFeatureCount(TRUE) == 0 )
+            continue;
+
+        ArrowCounts sGeneric = { 0, 0, 0 };
+        clock_t nStart = clock();
+        ReadFeatures(poLayer, nBatchSize, &sGeneric);
+        const double dfGeneric = Elapsed(nStart);
+
+        ArrowCounts sStream = { 0, 0, 0 };
+        nStart = clock();
+        if( !ReadStream(poLayer, papszStreamOptions, &sStream) )
+            nMismatches++;
+        const double dfStream = Elapsed(nStart);
+
+        if( sStream.nRows != sGeneric.nRows || sStream.nValues != sGeneric.nValues ||
+            sStream.nWkbBytes != sGeneric.nWkbBytes )
+            nMismatches++;
+
+        printf("%s: features=" CPL_FRMT_GIB " values=" CPL_FRMT_GIB
+               " wkb bytes=" CPL_FRMT_GIB " (stream: " CPL_FRMT_GIB " "
+               CPL_FRMT_GIB " " CPL_FRMT_GIB ")\n",
+               poLayer->GetName(), sGeneric.nRows, sGeneric.nValues,
+               sGeneric.nWkbBytes, sStream.nRows, sStream.nValues,
+               sStream.nWkbBytes);
+        printf("%s: GetNextFeature to columns: %.3f s, Arrow stream: %.3f s",
+               poLayer->GetName(), dfGeneric, dfStream);
+        if( dfStream > 0 )
+            printf(", speedup: %.2fx", dfGeneric / dfStream);
+        printf("\n");
+    }
+
+    CSLDestroy(papszStreamOptions);
+    GDALClose(poDS);
+    if( !osSynthetic.empty() )
+    {
+        VSIUnlink(osSynthetic);
+        VSIUnlink(CPLResetExtension(osSynthetic, "vfpi"));
+    }
+
+    return nMismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,391 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  VFP Translator
+ * Purpose:  Measures opening, scanning and querying a VFP file, with one
+ *           JSON object per line as output.
+ * Author:   Martin Landa, landa.martin gmail.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, Martin Landa <landa.martin gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "gdal_priv.h"
+#include "ogrsf_frmts.h"
+#include "cpl_conv.h"
+#include "cpl_string.h"
+
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#include <sys/resource.h>
+#endif
+
+/* Each measure is printed as a line like
+
+     {"test": "scan", "layer": "pneres", "seconds": 0.41, ...}
+
+   with the best time of -iterations runs, so that the output of two
+   releases can be compared line by line. The tests are:
+
+     file           size of the file, GDAL version and open options
+     index          first open and count of all layers, without the index
+                    files (.vfpi), which are written by this pass
+     open           GDALOpenEx() and GDALClose() with the index
+     scan           GetNextFeature() over a layer, features/s
+     scan_all       all layers one after the other, features/s and MB/s
+     spatial_first  first spatial query of a layer, which builds its
+                    .vfpr index with SPATIAL_INDEX=AUTO
+     spatial        query of the central 10 % x 10 % of the layer extent
+     attribute      equality filter on the first field of the layer
+
+   Every line has the peak resident set size of the process so far. */
+
+static double Now()
+{
+#ifdef _WIN32
+    return GetTickCount() / 1000.0;
+#else
+    struct timeval sTime;
+    gettimeofday(&sTime, NULL);
+    return sTime.tv_sec + sTime.tv_usec * 1e-6;
+#endif
+}
+
+static GIntBig PeakRSS()
+{
+#ifdef _WIN32
+    return -1;
+#else
+    struct rusage sUsage;
+    if( getrusage(RUSAGE_SELF, &sUsage) != 0 )
+        return -1;
+#ifdef __APPLE__
+    return (GIntBig) sUsage.ru_maxrss / 1024;
+#else
+    return (GIntBig) sUsage.ru_maxrss;
+#endif
+#endif
+}
+
+static CPLString JSONString( const char *pszValue )
+{
+    CPLString osResult("\"");
+    for( ; *pszValue != '\0'; pszValue++ )
+    {
+        if( *pszValue == '"' || *pszValue == '\\' )
+            osResult += '\\';
+        if( (unsigned char) *pszValue < 0x20 )
+            osResult += CPLSPrintf("\\u%04x", *pszValue);
+        else
+            osResult += *pszValue;
+    }
+    osResult += '"';
+    return osResult;
+}
+
+/************************************************************************/
+/*                              Report()                                */
+/************************************************************************/
+
+static void Report( const char *pszTest, const char *pszLayer,
+                    double dfSeconds, GIntBig nFeatures,
+                    const char *pszExtra = NULL )
+{
+    printf("{\"test\": %s", JSONString(pszTest).c_str());
+    if( pszLayer != NULL )
+        printf(", \"layer\": %s", JSONString(pszLayer).c_str());
+    printf(", \"seconds\": %.6f", dfSeconds);
+    if( nFeatures >= 0 )
+    {
+        printf(", \"features\": " CPL_FRMT_GIB, nFeatures);
+        printf(", \"features_per_s\": %.1f",
+               dfSeconds > 0 ? nFeatures / dfSeconds : 0.0);
+    }
+    if( pszExtra != NULL )
+        printf(", %s", pszExtra);
+    printf(", \"peak_rss_kb\": " CPL_FRMT_GIB "}\n", PeakRSS());
+    fflush(stdout);
+}
+
+static GIntBig ReadLayer( OGRLayer *poLayer )
+{
+    GIntBig nFeatures = 0;
+    poLayer->ResetReading();
+    OGRFeature *poFeature;
+    while( (poFeature = poLayer->GetNextFeature()) != NULL )
+    {
+        delete poFeature;
+        nFeatures++;
+    }
+    return nFeatures;
+}
+
+/************************************************************************/
+/*                          AttributeFilter()                           */
+/*                                                                      */
+/*      Equality with the value of the first field set on the first     */
+/*      feature, or an empty string if the layer has none.              */
+/************************************************************************/
+
+static CPLString AttributeFilter( OGRLayer *poLayer )
+{
+    CPLString osFilter;
+    poLayer->ResetReading();
+    OGRFeature *poFeature = poLayer->GetNextFeature();
+    if( poFeature == NULL )
+        return osFilter;
+
+    OGRFeatureDefn *poDefn = poLayer->GetLayerDefn();
+    for( int i = 0; i < poDefn->GetFieldCount(); i++ )
+    {
+        if( !poFeature->IsFieldSet(i) )
+            continue;
+        const OGRFieldType eType = poDefn->GetFieldDefn(i)->GetType();
+        if( eType == OFTInteger || eType == OFTInteger64 || eType == OFTReal )
+            osFilter.Printf("%s = %s", poDefn->GetFieldDefn(i)->GetNameRef(),
+                            poFeature->GetFieldAsString(i));
+        else
+        {
+            char *pszEscaped = CPLEscapeString(poFeature->GetFieldAsString(i),
+                                               -1, CPLES_SQL);
+            osFilter.Printf("%s = '%s'", poDefn->GetFieldDefn(i)->GetNameRef(),
+                            pszEscaped);
+            CPLFree(pszEscaped);
+        }
+        break;
+    }
+    delete poFeature;
+    return osFilter;
+}
+
+int main( int argc, char **argv )
+{
+    int nIterations = 3;
+    const char *pszFilename = NULL;
+    char **papszOpenOptions = NULL;
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( EQUAL(argv[i], "-iterations") && i + 1 < argc )
+            nIterations = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-oo") && i + 1 < argc )
+            papszOpenOptions = CSLAddString(papszOpenOptions, argv[++i]);
+        else if( argv[i][0] != '-' && pszFilename == NULL )
+            pszFilename = argv[i];
+        else
+        {
+            printf("Usage: testperfvfpbench [-iterations n] [-oo NAME=VALUE]* "
+                   "file.vfp\n");
+            return 1;
+        }
+    }
+    if( pszFilename == NULL )
+    {
+        printf("Usage: testperfvfpbench [-iterations n] [-oo NAME=VALUE]* "
+               "file.vfp\n");
+        return 1;
+    }
+    nIterations = MAX(1, nIterations);
+
+    GDALAllRegister();
+
+    VSIStatBufL sStat;
+    if( VSIStatL(pszFilename, &sStat) != 0 )
+    {
+        fprintf(stderr, "cannot open %s\n", pszFilename);
+        return 1;
+    }
+    const double dfMegaBytes = sStat.st_size / (1024.0 * 1024.0);
+
+    CPLString osOptions("[");
+    for( int i = 0; papszOpenOptions != NULL && papszOpenOptions[i] != NULL; i++ )
+    {
+        if( i > 0 )
+            osOptions += ", ";
+        osOptions += JSONString(papszOpenOptions[i]);
+    }
+    osOptions += "]";
+    printf("{\"test\": \"file\", \"file\": %s, \"bytes\": " CPL_FRMT_GIB
+           ", \"gdal\": %s, \"iterations\": %d, \"open_options\": %s}\n",
+           JSONString(pszFilename).c_str(), (GIntBig) sStat.st_size,
+           JSONString(GDALVersionInfo("RELEASE_NAME")).c_str(), nIterations,
+           osOptions.c_str());
+
+/* -------------------------------------------------------------------- */
+/*      Remove the index files left by an earlier run.                  */
+/* -------------------------------------------------------------------- */
+    GDALDataset *poDS = (GDALDataset *)
+        GDALOpenEx(pszFilename, GDAL_OF_VECTOR | GDAL_OF_READONLY, NULL,
+                   papszOpenOptions, NULL);
+    if( poDS == NULL )
+    {
+        fprintf(stderr, "cannot open %s\n", pszFilename);
+        CSLDestroy(papszOpenOptions);
+        return 1;
+    }
+    std::vector<CPLString> aosLayers;
+    for( int i = 0; i < poDS->GetLayerCount(); i++ )
+        aosLayers.push_back(poDS->GetLayer(i)->GetName());
+    GDALClose(poDS);
+
+    VSIUnlink(CPLResetExtension(pszFilename, "vfpi"));
+    for( size_t i = 0; i < aosLayers.size(); i++ )
+        VSIUnlink(CPLResetExtension(pszFilename,
+                                    CPLSPrintf("%s.vfpr", aosLayers[i].c_str())));
+
+/* -------------------------------------------------------------------- */
+/*      First pass, which writes the index.                             */
+/* -------------------------------------------------------------------- */
+    double dfStart = Now();
+    poDS = (GDALDataset *)
+        GDALOpenEx(pszFilename, GDAL_OF_VECTOR | GDAL_OF_READONLY, NULL,
+                   papszOpenOptions, NULL);
+    GIntBig nTotal = 0;
+    for( int i = 0; poDS != NULL && i < poDS->GetLayerCount(); i++ )
+        nTotal += poDS->GetLayer(i)->GetFeatureCount(TRUE);
+    GDALClose(poDS);
+    Report("index", NULL, Now() - dfStart, nTotal);
+
+    double dfBest = 0.0;
+    for( int iIter = 0; iIter < nIterations; iIter++ )
+    {
+        dfStart = Now();
+        poDS = (GDALDataset *)
+            GDALOpenEx(pszFilename, GDAL_OF_VECTOR | GDAL_OF_READONLY, NULL,
+                       papszOpenOptions, NULL);
+        GDALClose(poDS);
+        const double dfElapsed = Now() - dfStart;
+        if( iIter == 0 || dfElapsed < dfBest )
+            dfBest = dfElapsed;
+    }
+    Report("open", NULL, dfBest, -1);
+
+/* -------------------------------------------------------------------- */
+/*      Full scans.                                                     */
+/* -------------------------------------------------------------------- */
+    poDS = (GDALDataset *)
+        GDALOpenEx(pszFilename, GDAL_OF_VECTOR | GDAL_OF_READONLY, NULL,
+                   papszOpenOptions, NULL);
+    CSLDestroy(papszOpenOptions);
+    if( poDS == NULL )
+    {
+        fprintf(stderr, "cannot open %s\n", pszFilename);
+        return 1;
+    }
+
+    int nErrors = 0;
+    double dfScanAll = 0.0;
+    nTotal = 0;
+    for( int iLayer = 0; iLayer < poDS->GetLayerCount(); iLayer++ )
+    {
+        OGRLayer *poLayer = poDS->GetLayer(iLayer);
+        GIntBig nFeatures = 0;
+        for( int iIter = 0; iIter < nIterations; iIter++ )
+        {
+            dfStart = Now();
+            const GIntBig nRead = ReadLayer(poLayer);
+            const double dfElapsed = Now() - dfStart;
+            if( iIter == 0 || dfElapsed < dfBest )
+                dfBest = dfElapsed;
+            if( iIter > 0 && nRead != nFeatures )
+                nErrors++;
+            nFeatures = nRead;
+        }
+        if( nFeatures != poLayer->GetFeatureCount(TRUE) )
+            nErrors++;
+        if( nFeatures == 0 )
+            continue;
+        Report("scan", poLayer->GetName(), dfBest, nFeatures);
+        dfScanAll += dfBest;
+        nTotal += nFeatures;
+    }
+    Report("scan_all", NULL, dfScanAll, nTotal,
+           CPLSPrintf("\"mb\": %.3f, \"mb_per_s\": %.2f", dfMegaBytes,
+                      dfScanAll > 0 ? dfMegaBytes / dfScanAll : 0.0));
+
+/* -------------------------------------------------------------------- */
+/*      Filtered queries.                                               */
+/* -------------------------------------------------------------------- */
+    for( int iLayer = 0; iLayer < poDS->GetLayerCount(); iLayer++ )
+    {
+        OGRLayer *poLayer = poDS->GetLayer(iLayer);
+        if( poLayer->GetFeatureCount(TRUE) == 0 )
+            continue;
+
+        OGREnvelope sExtent;
+        if( poLayer->GetGeomType() != wkbNone &&
+            poLayer->GetExtent(&sExtent, TRUE) == OGRERR_NONE )
+        {
+            const double dfCenterX = (sExtent.MinX + sExtent.MaxX) / 2;
+            const double dfCenterY = (sExtent.MinY + sExtent.MaxY) / 2;
+            const double dfHalfWidth = (sExtent.MaxX - sExtent.MinX) / 20;
+            const double dfHalfHeight = (sExtent.MaxY - sExtent.MinY) / 20;
+            poLayer->SetSpatialFilterRect(dfCenterX - dfHalfWidth,
+                                          dfCenterY - dfHalfHeight,
+                                          dfCenterX + dfHalfWidth,
+                                          dfCenterY + dfHalfHeight);
+
+            dfStart = Now();
+            const GIntBig nFirst = ReadLayer(poLayer);
+            Report("spatial_first", poLayer->GetName(), Now() - dfStart, nFirst);
+
+            GIntBig nFeatures = 0;
+            for( int iIter = 0; iIter < nIterations; iIter++ )
+            {
+                dfStart = Now();
+                nFeatures = ReadLayer(poLayer);
+                const double dfElapsed = Now() - dfStart;
+                if( iIter == 0 || dfElapsed < dfBest )
+                    dfBest = dfElapsed;
+                if( nFeatures != nFirst )
+                    nErrors++;
+            }
+            Report("spatial", poLayer->GetName(), dfBest, nFeatures);
+            poLayer->SetSpatialFilter(NULL);
+        }
+
+        const CPLString osFilter = AttributeFilter(poLayer);
+        if( osFilter.empty() || poLayer->SetAttributeFilter(osFilter) != OGRERR_NONE )
+            continue;
+        GIntBig nFeatures = 0;
+        for( int iIter = 0; iIter < nIterations; iIter++ )
+        {
+            dfStart = Now();
+            nFeatures = ReadLayer(poLayer);
+            const double dfElapsed = Now() - dfStart;
+            if( iIter == 0 || dfElapsed < dfBest )
+                dfBest = dfElapsed;
+        }
+        if( nFeatures == 0 )
+            nErrors++;
+        Report("attribute", poLayer->GetName(), dfBest, nFeatures,
+               CPLSPrintf("\"filter\": %s", JSONString(osFilter).c_str()));
+        poLayer->SetAttributeFilter(NULL);
+    }
+
+    GDALClose(poDS);
+
+    return nErrors == 0 ? 0 : 1;
+}
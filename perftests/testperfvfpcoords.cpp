@@ -0,0 +1,113 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  VFP Translator
+ * Purpose:  Micro-benchmark of the coordinate parsing of the VFP driver.
+ * Author:   Martin Landa, landa.martin gmail.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, Martin Landa <landa.martin gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "../ogr_vfp.h"
+#include "cpl_conv.h"
+#include "cpl_string.h"
+
+#include <time.h>
+#include <vector>
+
+/* Coordinates in S-JTSK as written in VFP files: <c x="-744185.31"
+   y="-1041276.08" z="284.70"/>. The values are generated with a fixed
+   seed so that runs are comparable. */
+
+static unsigned int nSeed = 12345;
+
+static double Random( double dfMin, double dfMax )
+{
+    nSeed = nSeed * 1103515245U + 12345U;
+    return dfMin + (dfMax - dfMin) * ((nSeed >> 8) & 0xFFFFFF) / (double)0xFFFFFF;
+}
+
+static double Elapsed( clock_t nStart )
+{
+    return (double)(clock() - nStart) / CLOCKS_PER_SEC;
+}
+
+int main( int argc, char **argv )
+{
+    int nValues = 1000000;
+    int nIterations = 20;
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( EQUAL(argv[i], "-values") && i + 1 < argc )
+            nValues = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-iterations") && i + 1 < argc )
+            nIterations = atoi(argv[++i]);
+        else
+        {
+            printf("Usage: testperfvfpcoords [-values n] [-iterations n]\n");
+            return 1;
+        }
+    }
+
+    std::vector<CPLString> aosValues;
+    aosValues.reserve(nValues);
+    for( int i = 0; i < nValues; i++ )
+    {
+        switch( i % 3 )
+        {
+            case 0: aosValues.push_back(CPLSPrintf("%.2f", Random(-905000, -431000))); break;
+            case 1: aosValues.push_back(CPLSPrintf("%.2f", Random(-1227000, -935000))); break;
+            default: aosValues.push_back(CPLSPrintf("%.2f", Random(115, 1602))); break;
+        }
+    }
+
+    int nMismatches = 0;
+    for( int i = 0; i < nValues; i++ )
+    {
+        if( OGRVFPStrtod(aosValues[i], NULL) != CPLAtof(aosValues[i]) )
+            nMismatches++;
+    }
+
+    double dfSum = 0.0;
+    clock_t nStart = clock();
+    for( int iIter = 0; iIter < nIterations; iIter++ )
+        for( int i = 0; i < nValues; i++ )
+            dfSum += CPLAtof(aosValues[i]);
+    const double dfAtof = Elapsed(nStart);
+
+    nStart = clock();
+    for( int iIter = 0; iIter < nIterations; iIter++ )
+        for( int i = 0; i < nValues; i++ )
+            dfSum -= OGRVFPStrtod(aosValues[i], NULL);
+    const double dfVFP = Elapsed(nStart);
+
+    const double dfCount = (double)nValues * nIterations;
+    printf("values=%d iterations=%d mismatches=%d checksum=%g\n",
+           nValues, nIterations, nMismatches, dfSum);
+    printf("CPLAtof: %.1f ns/value\n", dfAtof * 1e9 / dfCount);
+    printf("OGRVFPStrtod: %.1f ns/value\n", dfVFP * 1e9 / dfCount);
+    if( dfVFP > 0 )
+        printf("speedup: %.2fx\n", dfAtof / dfVFP);
+
+    return nMismatches == 0 ? 0 : 1;
+}
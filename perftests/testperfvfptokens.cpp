@@ -0,0 +1,303 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  VFP Translator
+ * Purpose:  Micro-benchmark of the element name dispatch of the VFP driver.
+ * Author:   Martin Landa, landa.martin gmail.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, Martin Landa <landa.martin gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "../ogr_vfp.h"
+#include "../ogrvfpschema.h"
+#include "vfpgeneratefile.h"
+#include "cpl_conv.h"
+#include "cpl_string.h"
+
+#include <time.h>
+
+/* A pneres layer of the shared generator with about nElements elements:
+   <pa><gpar><area><reg><solid><polygon><segment><c/>...</segment>...
+   </polygon></solid></reg><t><c/></t></area></gpar></pa>
+   The handlers below count the elements the geometry builder reacts to,
+   either with the strcmp() chains used before the token table or with
+   OGRVFPGetToken() and a switch. */
+
+typedef struct
+{
+    int         nDepth;
+    int         nEvents;
+    int         nRoots;
+    int         nLayers;
+    int         nCoordinates;
+    int         nPaths;
+    int         nSegments;
+    int         nRegions;
+} BenchState;
+
+static const int nLayerCount = (int)(sizeof(asVFPLayers) / sizeof(asVFPLayers[0]));
+
+static void XMLCALL startNoop( void *pUserData, const char *, const char ** )
+{
+    ((BenchState *)pUserData)->nEvents++;
+}
+
+static void XMLCALL endNoop( void *pUserData, const char * )
+{
+    ((BenchState *)pUserData)->nEvents++;
+}
+
+static void XMLCALL startStrcmp( void *pUserData, const char *pszName, const char ** )
+{
+    BenchState *psState = (BenchState *)pUserData;
+    psState->nEvents++;
+    if( psState->nDepth == 0 )
+    {
+        if( strcmp(pszName, "v:vfp") == 0 )
+            psState->nRoots++;
+    }
+    else if( psState->nDepth == 1 )
+    {
+        for( int i = 0; i < nLayerCount; i++ )
+        {
+            if( strcmp(asVFPLayers[i].pszName, pszName) == 0 )
+            {
+                psState->nLayers++;
+                break;
+            }
+        }
+    }
+    else if( strcmp(pszName, "c") == 0 )
+        psState->nCoordinates++;
+    else if( strcmp(pszName, "segment") == 0 ||
+             strcmp(pszName, "se") == 0 || strcmp(pszName, "ar") == 0 )
+        psState->nSegments++;
+    else if( strcmp(pszName, "polygon") == 0 ||
+             strcmp(pszName, "linpol") == 0 || strcmp(pszName, "circle") == 0 )
+        psState->nPaths++;
+    else if( strcmp(pszName, "lin") == 0 )
+        psState->nPaths++;
+    else if( strcmp(pszName, "reg") == 0 )
+        psState->nRegions++;
+    psState->nDepth++;
+}
+
+static void XMLCALL endStrcmp( void *pUserData, const char *pszName )
+{
+    BenchState *psState = (BenchState *)pUserData;
+    psState->nEvents++;
+    psState->nDepth--;
+    if( strcmp(pszName, "segment") == 0 ||
+        strcmp(pszName, "se") == 0 || strcmp(pszName, "ar") == 0 )
+        psState->nSegments--;
+    else if( strcmp(pszName, "polygon") == 0 || strcmp(pszName, "linpol") == 0 ||
+             strcmp(pszName, "circle") == 0 || strcmp(pszName, "lin") == 0 )
+        psState->nPaths--;
+    else if( strcmp(pszName, "reg") == 0 )
+        psState->nRegions--;
+}
+
+static void XMLCALL startToken( void *pUserData, const char *pszName, const char ** )
+{
+    BenchState *psState = (BenchState *)pUserData;
+    psState->nEvents++;
+    const OGRVFPToken eToken = OGRVFPGetToken(pszName);
+    if( psState->nDepth == 0 )
+    {
+        if( eToken == VFP_TOKEN_VFP )
+            psState->nRoots++;
+    }
+    else if( psState->nDepth == 1 )
+    {
+        for( int i = 0; i < nLayerCount; i++ )
+        {
+            if( asVFPLayers[i].eToken == eToken )
+            {
+                psState->nLayers++;
+                break;
+            }
+        }
+    }
+    else
+    {
+        switch( eToken )
+        {
+            case VFP_TOKEN_C:
+                psState->nCoordinates++;
+                break;
+            case VFP_TOKEN_SEGMENT: case VFP_TOKEN_SE: case VFP_TOKEN_AR:
+                psState->nSegments++;
+                break;
+            case VFP_TOKEN_POLYGON: case VFP_TOKEN_LINPOL:
+            case VFP_TOKEN_CIRCLE: case VFP_TOKEN_LIN:
+                psState->nPaths++;
+                break;
+            case VFP_TOKEN_REG:
+                psState->nRegions++;
+                break;
+            default:
+                break;
+        }
+    }
+    psState->nDepth++;
+}
+
+static void XMLCALL endToken( void *pUserData, const char *pszName )
+{
+    BenchState *psState = (BenchState *)pUserData;
+    psState->nEvents++;
+    psState->nDepth--;
+    switch( OGRVFPGetToken(pszName) )
+    {
+        case VFP_TOKEN_SEGMENT: case VFP_TOKEN_SE: case VFP_TOKEN_AR:
+            psState->nSegments--;
+            break;
+        case VFP_TOKEN_POLYGON: case VFP_TOKEN_LINPOL:
+        case VFP_TOKEN_CIRCLE: case VFP_TOKEN_LIN:
+            psState->nPaths--;
+            break;
+        case VFP_TOKEN_REG:
+            psState->nRegions--;
+            break;
+        default:
+            break;
+    }
+}
+
+/* element names of the document, for timing the dispatch alone */
+static std::vector<CPLString> aosNames;
+
+static void XMLCALL startRecord( void *pUserData, const char *pszName, const char ** )
+{
+    ((BenchState *)pUserData)->nEvents++;
+    aosNames.push_back(pszName);
+}
+
+static double Dispatch( XML_StartElementHandler pfnStart,
+                        XML_EndElementHandler pfnEnd, int nIterations,
+                        BenchState *psState )
+{
+    static const char *apszNoAttr[] = { NULL };
+    memset(psState, 0, sizeof(BenchState));
+    clock_t nStart = clock();
+    for( int iIter = 0; iIter < nIterations; iIter++ )
+    {
+        /* the same names as start and end events, nesting is ignored */
+        for( size_t i = 0; i < aosNames.size(); i++ )
+        {
+            psState->nDepth = 2;
+            pfnStart(psState, aosNames[i], apszNoAttr);
+            pfnEnd(psState, aosNames[i]);
+        }
+    }
+    return (double)(clock() - nStart) / CLOCKS_PER_SEC;
+}
+
+static double Parse( const CPLString &osDoc, XML_StartElementHandler pfnStart,
+                     XML_EndElementHandler pfnEnd, int nIterations,
+                     BenchState *psState )
+{
+    memset(psState, 0, sizeof(BenchState));
+    clock_t nStart = clock();
+    for( int iIter = 0; iIter < nIterations; iIter++ )
+    {
+        XML_Parser oParser = OGRCreateExpatXMLParser();
+        XML_SetUserData(oParser, psState);
+        XML_SetElementHandler(oParser, pfnStart, pfnEnd);
+        if( XML_Parse(oParser, osDoc.c_str(), (int)osDoc.size(), 1) == XML_STATUS_ERROR )
+            fprintf(stderr, "parse error: %s\n", XML_ErrorString(XML_GetErrorCode(oParser)));
+        XML_ParserFree(oParser);
+    }
+    return (double)(clock() - nStart) / CLOCKS_PER_SEC;
+}
+
+int main( int argc, char **argv )
+{
+    int nElements = 1000000;
+    int nIterations = 5;
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( EQUAL(argv[i], "-elements") && i + 1 < argc )
+            nElements = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-iterations") && i + 1 < argc )
+            nIterations = atoi(argv[++i]);
+        else
+        {
+            printf("Usage: testperfvfptokens [-elements n] [-iterations n]\n");
+            return 1;
+        }
+    }
+
+    /* about 15 elements per parcel, the document is parsed in memory */
+    VFPGenerateOptions sOptions;
+    VFPGenerateParcelOptions(&sOptions, nElements / 15 + 1);
+    const CPLString osFilename = VFPGenerateTempFile("testperfvfptokens", &sOptions);
+    GByte *pabyDoc = NULL;
+    vsi_l_offset nDocSize = 0;
+    if( osFilename.empty() ||
+        !VSIIngestFile(NULL, osFilename, &pabyDoc, &nDocSize, -1) )
+    {
+        fprintf(stderr, "cannot generate the document\n");
+        return 1;
+    }
+    VSIUnlink(osFilename);
+    const CPLString osDoc((const char *) pabyDoc, (size_t) nDocSize);
+    CPLFree(pabyDoc);
+
+    BenchState sNoop, sStrcmp, sToken;
+    const double dfNoop = Parse(osDoc, startNoop, endNoop, nIterations, &sNoop);
+    const double dfStrcmp = Parse(osDoc, startStrcmp, endStrcmp, nIterations, &sStrcmp);
+    const double dfToken = Parse(osDoc, startToken, endToken, nIterations, &sToken);
+
+    BenchState sRecord, sDispatchStrcmp, sDispatchToken;
+    Parse(osDoc, startRecord, NULL, 1, &sRecord);
+    const double dfDispatchStrcmp =
+        Dispatch(startStrcmp, endStrcmp, nIterations, &sDispatchStrcmp);
+    const double dfDispatchToken =
+        Dispatch(startToken, endToken, nIterations, &sDispatchToken);
+
+    const bool bSame = sStrcmp.nRoots == sToken.nRoots &&
+                       sStrcmp.nLayers == sToken.nLayers &&
+                       sStrcmp.nCoordinates == sToken.nCoordinates &&
+                       sStrcmp.nPaths == sToken.nPaths &&
+                       sStrcmp.nSegments == sToken.nSegments &&
+                       sStrcmp.nRegions == sToken.nRegions &&
+                       sDispatchStrcmp.nCoordinates == sDispatchToken.nCoordinates &&
+                       sDispatchStrcmp.nPaths == sDispatchToken.nPaths;
+
+    const double dfEvents = (double)sNoop.nEvents;
+    printf("elements=%d bytes=%d iterations=%d events=%.0f results=%s\n",
+           sNoop.nEvents / nIterations / 2, (int)osDoc.size(), nIterations,
+           dfEvents, bSame ? "same" : "DIFFERENT");
+    printf("expat only: %.2f Mevents/s\n", dfEvents / dfNoop / 1e6);
+    printf("strcmp dispatch: %.2f Mevents/s, %.1f ns/event over expat\n",
+           dfEvents / dfStrcmp / 1e6, (dfStrcmp - dfNoop) * 1e9 / dfEvents);
+    printf("token dispatch: %.2f Mevents/s, %.1f ns/event over expat\n",
+           dfEvents / dfToken / 1e6, (dfToken - dfNoop) * 1e9 / dfEvents);
+    printf("strcmp dispatch alone: %.2f Mevents/s\n",
+           dfEvents / dfDispatchStrcmp / 1e6);
+    printf("token dispatch alone: %.2f Mevents/s\n",
+           dfEvents / dfDispatchToken / 1e6);
+
+    return bSame ? 0 : 1;
+}
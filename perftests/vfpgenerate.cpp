@@ -0,0 +1,87 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  VFP Translator
+ * Purpose:  Writes synthetic VFP files for the benchmarks.
+ * Author:   Martin Landa, landa.martin gmail.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, Martin Landa <landa.martin gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "vfpgeneratefile.h"
+#include "cpl_conv.h"
+#include "cpl_string.h"
+
+static int Usage()
+{
+    printf("Usage: vfpgenerate [-participants n] [-parcels n] [-blocks n]\n"
+           "                   [-lines n] [-points n] [-sources n]\n"
+           "                   [-arcs percent] [-circles percent] [-holes percent]\n"
+           "                   [-seed n] file.vfp\n");
+    return 1;
+}
+
+int main( int argc, char **argv )
+{
+    VFPGenerateOptions sOptions;
+    VFPGenerateDefaultOptions(&sOptions);
+    const char *pszFilename = NULL;
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( i + 1 < argc && argv[i][0] == '-' )
+        {
+            const int nValue = atoi(argv[i + 1]);
+            if( EQUAL(argv[i], "-participants") )
+                sOptions.nParticipants = nValue;
+            else if( EQUAL(argv[i], "-parcels") )
+                sOptions.nParcels = nValue;
+            else if( EQUAL(argv[i], "-blocks") )
+                sOptions.nBlocks = nValue;
+            else if( EQUAL(argv[i], "-lines") )
+                sOptions.nLines = nValue;
+            else if( EQUAL(argv[i], "-points") )
+                sOptions.nPoints = nValue;
+            else if( EQUAL(argv[i], "-sources") )
+                sOptions.nSources = nValue;
+            else if( EQUAL(argv[i], "-arcs") )
+                sOptions.nArcPercent = nValue;
+            else if( EQUAL(argv[i], "-circles") )
+                sOptions.nCirclePercent = nValue;
+            else if( EQUAL(argv[i], "-holes") )
+                sOptions.nHolePercent = nValue;
+            else if( EQUAL(argv[i], "-seed") )
+                sOptions.nSeed = (GUInt32) nValue;
+            else
+                return Usage();
+            i++;
+        }
+        else if( argv[i][0] != '-' && pszFilename == NULL )
+            pszFilename = argv[i];
+        else
+            return Usage();
+    }
+    if( pszFilename == NULL )
+        return Usage();
+
+    return VFPGenerateFile(pszFilename, &sOptions) ? 0 : 1;
+}
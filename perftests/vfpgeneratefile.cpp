@@ -0,0 +1,371 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  VFP Translator
+ * Purpose:  Synthetic VFP files of the benchmarks and performance tests.
+ * Author:   Martin Landa, landa.martin gmail.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, Martin Landa <landa.martin gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "vfpgeneratefile.h"
+#include "cpl_conv.h"
+#include "cpl_string.h"
+#include "cpl_vsi.h"
+
+static GUInt32 nRandomState = 1;
+
+static int Random( int nMax )
+{
+    nRandomState = nRandomState * 1103515245U + 12345U;
+    return (int) ((nRandomState >> 8) % (GUInt32) nMax);
+}
+
+static const double dfOriginX = -700000.0;
+static const double dfOriginY = -1000000.0;
+static const double dfCell = 20.0;
+
+static void WritePoint( VSILFILE *fp, double dfX, double dfY )
+{
+    VSIFPrintfL(fp, "<c x=\"%.2f\" y=\"%.2f\"/>", dfX, dfY);
+}
+
+/************************************************************************/
+/*                            WriteSquare()                             */
+/*                                                                      */
+/*      A linpol ring, with the top side replaced by an arc bulging     */
+/*      by dfBulge when it is not zero.                                 */
+/************************************************************************/
+
+static void WriteSquare( VSILFILE *fp, double dfX, double dfY, double dfSize,
+                         double dfBulge )
+{
+    VSIFPrintfL(fp, "<polygon xsi:type=\"v:linpol\"><segment xsi:type=\"v:se\">");
+    WritePoint(fp, dfX, dfY);
+    WritePoint(fp, dfX + dfSize, dfY);
+    WritePoint(fp, dfX + dfSize, dfY + dfSize);
+    if( dfBulge != 0.0 )
+    {
+        VSIFPrintfL(fp, "</segment><segment xsi:type=\"v:ar\">");
+        WritePoint(fp, dfX + dfSize, dfY + dfSize);
+        WritePoint(fp, dfX + dfSize / 2, dfY + dfSize + dfBulge);
+        WritePoint(fp, dfX, dfY + dfSize);
+        VSIFPrintfL(fp, "</segment><segment xsi:type=\"v:se\">");
+    }
+    WritePoint(fp, dfX, dfY + dfSize);
+    WritePoint(fp, dfX, dfY);
+    VSIFPrintfL(fp, "</segment></polygon>");
+}
+
+/************************************************************************/
+/*                            WriteRegion()                             */
+/************************************************************************/
+
+static void WriteRegion( VSILFILE *fp, const VFPGenerateOptions *psOptions,
+                         double dfX, double dfY, double dfSize,
+                         const char *pszLabel )
+{
+    const double dfBulge =
+        Random(100) < psOptions->nArcPercent ? dfSize / 10 : 0.0;
+
+    VSIFPrintfL(fp, "<area><reg><solid>");
+    WriteSquare(fp, dfX, dfY, dfSize, dfBulge);
+    VSIFPrintfL(fp, "</solid>");
+    if( Random(100) < psOptions->nHolePercent )
+    {
+        VSIFPrintfL(fp, "<holes>");
+        if( Random(psOptions->nHolePercent) < psOptions->nCirclePercent )
+        {
+            VSIFPrintfL(fp, "<polygon xsi:type=\"v:circle\" r=\"%.2f\">",
+                        dfSize / 6);
+            WritePoint(fp, dfX + dfSize / 2, dfY + dfSize / 2);
+            VSIFPrintfL(fp, "</polygon>");
+        }
+        else
+            WriteSquare(fp, dfX + dfSize / 3, dfY + dfSize / 3, dfSize / 3, 0.0);
+        VSIFPrintfL(fp, "</holes>");
+    }
+    VSIFPrintfL(fp, "</reg><t hod=\"%s\">", pszLabel);
+    WritePoint(fp, dfX + dfSize / 4, dfY + dfSize / 4);
+    VSIFPrintfL(fp, "</t></area>");
+}
+
+/************************************************************************/
+/*                         WriteParticipants()                          */
+/************************************************************************/
+
+static void WriteParticipants( VSILFILE *fp, int nParticipants )
+{
+    static const char * const apszFirstNames[] =
+        { "Jan", "Eva", "Petr", "Jiří", "Zdeňka", "Tomáš", "Marie" };
+    static const char * const apszLastNames[] =
+        { "Novák", "Svobodová", "Dvořák", "Černý", "Procházková", "Kučera" };
+    static const char * const apszCompanies[] =
+        { "Zemědělské družstvo &amp; syn", "Lesy &lt;Vysočina&gt;",
+          "Obec Horní Dolní", "&quot;Agro&quot; s.r.o." };
+    static const char * const apszTowns[] =
+        { "Praha", "Brno", "Jihlava", "Písek", "Třeboň" };
+
+    VSIFPrintfL(fp, "  <ucastnici>\n");
+    for( int i = 0; i < nParticipants; i++ )
+    {
+        VSIFPrintfL(fp, "    <uca id=\"%d\" op_id=\"OS%08d\"", i + 1, i + 1);
+        if( Random(10) < 8 )
+            VSIFPrintfL(fp, " jm=\"%s\" pr=\"%s\" rc=\"%06d%04d\"",
+                        apszFirstNames[Random(7)], apszLastNames[Random(6)],
+                        500101 + Random(300000), Random(10000));
+        else
+            VSIFPrintfL(fp, " naz=\"%s\" ico=\"%d\"",
+                        apszCompanies[Random(4)],
+                        10000000 + Random(80000000));
+        VSIFPrintfL(fp, " ul=\"Polní\" cd=\"%d\" ob=\"%s\" psc=\"%05d\"/>\n",
+                    1 + Random(2000), apszTowns[Random(5)],
+                    10000 + Random(80000));
+    }
+    VSIFPrintfL(fp, "  </ucastnici>\n");
+}
+
+/************************************************************************/
+/*                            WriteParcels()                            */
+/************************************************************************/
+
+static void WriteParcels( VSILFILE *fp, const VFPGenerateOptions *psOptions,
+                          int nColumns )
+{
+    static const int anKinds[] = { 2, 3, 4, 5, 6, 7, 8, 10, 11, 13, 14 };
+
+    VSIFPrintfL(fp, "  <pneres>\n");
+    for( int i = 0; i < psOptions->nParcels; i++ )
+    {
+        const double dfX = dfOriginX + (i % nColumns) * dfCell;
+        const double dfY = dfOriginY + (i / nColumns) * dfCell;
+        CPLString osLabel;
+        osLabel.Printf("%d/%d", 1 + i / 1000, 1 + i % 1000);
+
+        VSIFPrintfL(fp, "    <pa parid=\"%d\" vymz=\"%d.%02d\" dpz=\"%d\"",
+                    100000 + i, 300 + Random(60), Random(100),
+                    anKinds[Random(11)]);
+        if( Random(2) )
+            VSIFPrintfL(fp, " zvz=\"%d\"", 1 + Random(30));
+        VSIFPrintfL(fp, "><gpar>");
+        WriteRegion(fp, psOptions, dfX + 1, dfY + 1, dfCell - 2, osLabel);
+        VSIFPrintfL(fp, "</gpar></pa>\n");
+    }
+    VSIFPrintfL(fp, "  </pneres>\n");
+}
+
+/************************************************************************/
+/*                            WriteBlocks()                             */
+/************************************************************************/
+
+static void WriteBlocks( VSILFILE *fp, const VFPGenerateOptions *psOptions,
+                         int nColumns )
+{
+    const int nBlockColumns = MAX(1, (nColumns + 4) / 5);
+
+    VSIFPrintfL(fp, "  <bpej>\n");
+    for( int i = 0; i < psOptions->nBlocks; i++ )
+    {
+        const double dfX = dfOriginX + (i % nBlockColumns) * dfCell * 5;
+        const double dfY = dfOriginY + (i / nBlockColumns) * dfCell * 5;
+        CPLString osCode;
+        osCode.Printf("%05d", 10000 + Random(90000));
+
+        VSIFPrintfL(fp, "    <pl id=\"%d\" kod=\"%s\" cena=\"%d.%02d\">",
+                    i + 1, osCode.c_str(), 1 + Random(20), Random(100));
+        WriteRegion(fp, psOptions, dfX, dfY, dfCell * 5, osCode);
+        VSIFPrintfL(fp, "</pl>\n");
+    }
+    VSIFPrintfL(fp, "  </bpej>\n");
+}
+
+/************************************************************************/
+/*                              WriteZS()                               */
+/*                                                                      */
+/*      Lines along the rows of the grid, with an arc in every other    */
+/*      cell for the requested share of the lines, survey points and    */
+/*      source points.                                                  */
+/************************************************************************/
+
+static void WriteZS( VSILFILE *fp, const VFPGenerateOptions *psOptions,
+                     int nColumns, int nRows )
+{
+    VSIFPrintfL(fp, "  <zs>\n");
+    if( psOptions->nLines > 0 )
+    {
+        VSIFPrintfL(fp, "    <plins>\n");
+        for( int i = 0; i < psOptions->nLines; i++ )
+        {
+            const int nCells = 2 + Random(8);
+            const int nStart = Random(MAX(1, nColumns - nCells));
+            const double dfY = dfOriginY + (i % (nRows + 1)) * dfCell;
+            const bool bArcs = Random(100) < psOptions->nArcPercent;
+
+            VSIFPrintfL(fp, "      <plin typ=\"%d\"><lin><segment xsi:type=\"v:se\">",
+                        1 + Random(20));
+            double dfX = dfOriginX + nStart * dfCell;
+            WritePoint(fp, dfX, dfY);
+            for( int j = 0; j < nCells; j++, dfX += dfCell )
+            {
+                if( bArcs && j % 2 == 1 )
+                {
+                    VSIFPrintfL(fp, "</segment><segment xsi:type=\"v:ar\">");
+                    WritePoint(fp, dfX, dfY);
+                    WritePoint(fp, dfX + dfCell / 2, dfY + dfCell / 8);
+                    WritePoint(fp, dfX + dfCell, dfY);
+                    if( j + 1 < nCells )
+                    {
+                        VSIFPrintfL(fp, "</segment><segment xsi:type=\"v:se\">");
+                        WritePoint(fp, dfX + dfCell, dfY);
+                    }
+                }
+                else
+                    WritePoint(fp, dfX + dfCell, dfY);
+            }
+            VSIFPrintfL(fp, "</segment></lin></plin>\n");
+        }
+        VSIFPrintfL(fp, "    </plins>\n");
+    }
+    if( psOptions->nPoints > 0 )
+    {
+        VSIFPrintfL(fp, "    <pznas>\n");
+        for( int i = 0; i < psOptions->nPoints; i++ )
+        {
+            VSIFPrintfL(fp, "      <pzna typ=\"%d\"><b o=\"%d\">",
+                        1 + Random(40), Random(360));
+            WritePoint(fp, dfOriginX + Random(nColumns * 20 + 1),
+                       dfOriginY + Random(nRows * 20 + 1));
+            VSIFPrintfL(fp, "</b></pzna>\n");
+        }
+        VSIFPrintfL(fp, "    </pznas>\n");
+    }
+    if( psOptions->nSources > 0 )
+    {
+        VSIFPrintfL(fp, "    <psour>\n");
+        for( int i = 0; i < psOptions->nSources; i++ )
+            VSIFPrintfL(fp, "      <psou sx=\"%.2f\" sy=\"%.2f\" sz=\"%d.%02d\" cb=\"%d\"/>\n",
+                        dfOriginX + Random(nColumns * 20 * 100 + 1) / 100.0,
+                        dfOriginY + Random(nRows * 20 * 100 + 1) / 100.0,
+                        400 + Random(200), Random(100), i + 1);
+        VSIFPrintfL(fp, "    </psour>\n");
+    }
+    VSIFPrintfL(fp, "  </zs>\n");
+}
+
+/************************************************************************/
+/*                     VFPGenerateDefaultOptions()                      */
+/************************************************************************/
+
+void VFPGenerateDefaultOptions( VFPGenerateOptions *psOptions )
+{
+    psOptions->nParticipants = 10000;
+    psOptions->nParcels = 100000;
+    psOptions->nBlocks = -1;
+    psOptions->nLines = 20000;
+    psOptions->nPoints = 20000;
+    psOptions->nSources = 5000;
+    psOptions->nArcPercent = 10;
+    psOptions->nCirclePercent = 5;
+    psOptions->nHolePercent = 10;
+    psOptions->nSeed = 1;
+}
+
+/************************************************************************/
+/*                          VFPGenerateFile()                           */
+/************************************************************************/
+
+bool VFPGenerateFile( const char *pszFilename, const VFPGenerateOptions *psOptions )
+{
+    VFPGenerateOptions sOptions = *psOptions;
+    nRandomState = sOptions.nSeed;
+
+    /* circles are a part of the holes */
+    sOptions.nCirclePercent = MIN(sOptions.nCirclePercent, sOptions.nHolePercent);
+
+    const int nColumns = MAX(1, (int) sqrt((double) MAX(sOptions.nParcels, 1)));
+    const int nRows = (MAX(sOptions.nParcels, 1) + nColumns - 1) / nColumns;
+    if( sOptions.nBlocks < 0 )
+        sOptions.nBlocks = ((nColumns + 4) / 5) * ((nRows + 4) / 5);
+
+    VSILFILE *fp = VSIFOpenL(pszFilename, "wb");
+    if( fp == NULL )
+    {
+        fprintf(stderr, "cannot create %s\n", pszFilename);
+        return false;
+    }
+
+    VSIFPrintfL(fp, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                "<v:vfp xmlns:v=\"http://www.hsi.cz/vfp\" "
+                "xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\">\n"
+                "  <hlav dvz=\"2016-01-01T00:00:00\" dkn=\"2016-01-01T00:00:00\" "
+                "aut=\"vfpgenerate\" et=\"1\" kk=\"600001\" typ=\"kopu\" cpu=\"1\" "
+                "ver=\"3.1\" sw=\"vfpgenerate\"/>\n");
+    if( sOptions.nParticipants > 0 )
+        WriteParticipants(fp, sOptions.nParticipants);
+    if( sOptions.nParcels > 0 )
+        WriteParcels(fp, &sOptions, nColumns);
+    if( sOptions.nBlocks > 0 )
+        WriteBlocks(fp, &sOptions, nColumns);
+    if( sOptions.nLines > 0 || sOptions.nPoints > 0 || sOptions.nSources > 0 )
+        WriteZS(fp, &sOptions, nColumns, nRows);
+    VSIFPrintfL(fp, "</v:vfp>\n");
+
+    const bool bOK = VSIFCloseL(fp) == 0;
+    if( !bOK )
+        fprintf(stderr, "cannot write %s\n", pszFilename);
+
+    return bOK;
+}
+
+/************************************************************************/
+/*                      VFPGenerateParcelOptions()                      */
+/************************************************************************/
+
+void VFPGenerateParcelOptions( VFPGenerateOptions *psOptions, int nParcels )
+{
+    VFPGenerateDefaultOptions(psOptions);
+    psOptions->nParticipants = 0;
+    psOptions->nParcels = nParcels;
+    psOptions->nBlocks = 0;
+    psOptions->nLines = 0;
+    psOptions->nPoints = 0;
+    psOptions->nSources = 0;
+}
+
+/************************************************************************/
+/*                        VFPGenerateTempFile()                         */
+/************************************************************************/
+
+CPLString VFPGenerateTempFile( const char *pszPrefix,
+                               const VFPGenerateOptions *psOptions )
+{
+    CPLString osFilename = CPLGenerateTempFilename(pszPrefix);
+    osFilename += ".vfp";
+
+    if( !VFPGenerateFile(osFilename, psOptions) )
+    {
+        VSIUnlink(osFilename);
+        return "";
+    }
+
+    return osFilename;
+}
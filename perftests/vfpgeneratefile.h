@@ -0,0 +1,64 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  VFP Translator
+ * Purpose:  Synthetic VFP files of the benchmarks and performance tests.
+ * Author:   Martin Landa, landa.martin gmail.com
+ *
+ ******************************************************************************
+ * Copyright (c) 2015, Martin Landa <landa.martin gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef VFPGENERATEFILE_H_INCLUDED
+#define VFPGENERATEFILE_H_INCLUDED
+
+#include "cpl_string.h"
+
+/* The files are valid against data/vfp_3.1.xsd. Parcels (pneres) are
+   squares of a grid of 20 m cells, some with an arc on one side and a
+   circular or square hole. BPEJ blocks (bpej) cover 5 x 5 parcels, the
+   lines of zs follow the grid with straight and arc segments, and the
+   participants (ucastnici) have names and addresses with characters that
+   must be escaped. The same options give the same file. */
+
+typedef struct
+{
+    int         nParticipants;
+    int         nParcels;
+    int         nBlocks;        /* -1: cover the parcels */
+    int         nLines;
+    int         nPoints;
+    int         nSources;
+    int         nArcPercent;
+    int         nCirclePercent;
+    int         nHolePercent;
+    GUInt32     nSeed;
+} VFPGenerateOptions;
+
+void VFPGenerateDefaultOptions( VFPGenerateOptions *psOptions );
+/* the default options with a pneres layer of nParcels only */
+void VFPGenerateParcelOptions( VFPGenerateOptions *psOptions, int nParcels );
+bool VFPGenerateFile( const char *pszFilename, const VFPGenerateOptions *psOptions );
+/* a temporary <prefix>*.vfp file, "" on error */
+CPLString VFPGenerateTempFile( const char *pszPrefix,
+                               const VFPGenerateOptions *psOptions );
+
+#endif /* ndef VFPGENERATEFILE_H_INCLUDED */